@@ -0,0 +1,57 @@
+/*
+*  AVLtree bulk construction benchmark
+*
+*  Loads N keys into an AVLtree three ways: N calls to insert(), assign_sorted() on
+*  sorted keys, and the range constructor on shuffled keys (parallel_sort + bulk build).
+*
+*  Usage: ./avl_bulk_bench [N]
+*/
+#include "../containers/AVLtree.hpp"
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
+template<typename Function>
+void run(const char* name, Function function) {
+	auto start = std::chrono::steady_clock::now();
+	size_t checksum = function();
+	auto stop = std::chrono::steady_clock::now();
+
+	double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+	std::cout << "  " << name << ": " << ms << " ms  (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+
+	Vector<long long> sorted;
+	Vector<long long> shuffled;
+	sorted.reserve(count);
+	shuffled.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		sorted.push_back(static_cast<long long>(i));
+		//Multiplication by a prime modulo count visits every key once
+		shuffled.push_back(static_cast<long long>(i * 1000003 % count));
+	}
+
+	std::cout << count << " keys\n";
+	run("insert() one by one        ", [&] {
+		AVLtree<long long> tree;
+		for (size_t i = 0; i < count; ++i) {
+			tree.insert(sorted[i]);
+		}
+		return tree.size();
+	});
+	run("assign_sorted()            ", [&] {
+		AVLtree<long long> tree;
+		tree.assign_sorted(sorted.data(), sorted.data() + count);
+		return tree.size();
+	});
+	run("range constructor, shuffled", [&] {
+		AVLtree<long long> tree(shuffled.data(), shuffled.data() + count);
+		return tree.size();
+	});
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*
+*  AVLtree hinted insertion benchmark
+*
+*  Loads N time-series keys that arrive almost sorted (every 16th key is a few steps
+*  late) three ways: insert() from the root, insert(end(), key) with the end hint, and
+*  append_max() for the in-order keys with insert() for the late ones. Keys are
+*  String timestamps, so every comparison a descent saves is a string compare.
+*
+*  Usage: ./avl_hint_bench [N]
+*/
+#include "../containers/AVLtree.hpp"
+#include "../containers/String.hpp"
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+
+template<typename Function>
+void run(const char* name, Function function) {
+	auto start = std::chrono::steady_clock::now();
+	size_t checksum = function();
+	auto stop = std::chrono::steady_clock::now();
+
+	double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+	std::cout << "  " << name << ": " << ms << " ms  (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+	Vector<String> keys;
+	Vector<bool> late;
+	keys.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		//Every 16th key is 3 positions late
+		size_t stamp = i % 16 == 15 ? i - 3 : i;
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "2024-01-01T%012zu", stamp);
+		keys.push_back(String(buffer));
+		late.push_back(i % 16 == 15);
+	}
+
+	std::cout << count << " keys\n";
+	run("insert() from the root      ", [&] {
+		AVLtree<String> tree;
+		for (size_t i = 0; i < count; ++i) {
+			tree.insert(keys[i]);
+		}
+		return tree.size();
+	});
+	run("insert(end(), key)          ", [&] {
+		AVLtree<String> tree;
+		for (size_t i = 0; i < count; ++i) {
+			tree.insert(tree.end(), keys[i]);
+		}
+		return tree.size();
+	});
+	run("append_max(), late insert()", [&] {
+		AVLtree<String> tree;
+		for (size_t i = 0; i < count; ++i) {
+			if (late[i]) {
+				tree.insert(keys[i]);
+			}
+			else {
+				tree.append_max(keys[i]);
+			}
+		}
+		return tree.size();
+	});
+	return 0;
+}
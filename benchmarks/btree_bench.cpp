@@ -0,0 +1,63 @@
+/*
+*  BTree vs AVLtree benchmark
+*
+*  For N = 1K, 10K, ... up to max_keys: inserts N int keys in shuffled order, runs 1M
+*  random successful lookups (contains()) and scans the whole container in order.
+*  Throughput is in million operations (elements for the scan) per second.
+*
+*  Usage: ./btree_bench [max_keys]   (default 10M; 100M needs about 8 GB for AVLtree)
+*/
+#include "../containers/AVLtree.hpp"
+#include "../containers/BTree.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
+template<typename Function>
+double seconds(Function function) {
+	auto start = std::chrono::steady_clock::now();
+	function();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(stop - start).count();
+}
+
+template<typename Tree>
+void run(const char* name, size_t count) {
+	const size_t lookups = 1000000;
+	size_t checksum = 0;
+	Tree tree;
+
+	//Multiplication by a prime modulo count visits every key once
+	double insert = seconds([&] {
+		for (size_t i = 0; i < count; ++i) {
+			tree.insert(static_cast<int>(i * 1000003 % count));
+		}
+	});
+	double lookup = seconds([&] {
+		unsigned seed = 12345;
+		for (size_t i = 0; i < lookups; ++i) {
+			seed = seed * 1103515245u + 12345u;
+			checksum += tree.contains(static_cast<int>(((static_cast<size_t>(seed) << 16) ^ i) % count));
+		}
+	});
+	double scan = seconds([&] {
+		for (int value : tree) {
+			checksum += static_cast<size_t>(value);
+		}
+	});
+
+	std::cout << "  " << name << "  insert " << count / insert / 1e6 << " M/s   lookup "
+		<< lookups / lookup / 1e6 << " M/s   scan " << count / scan / 1e6 << " M/s   (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t max_keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+	for (size_t count = 1000; count <= max_keys; count *= 10) {
+		std::cout << count << " keys\n";
+		run<AVLtree<int>>("AVLtree", count);
+		run<BTree<int>>("BTree  ", count);
+	}
+	return 0;
+}
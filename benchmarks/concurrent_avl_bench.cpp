@@ -0,0 +1,135 @@
+/*
+*  ConcurrentAVLtree reader scaling benchmark
+*
+*  For R = 1, 2, 4, ... up to the number of hardware threads: R reader threads run random
+*  lookups for a fixed time while one writer thread keeps inserting and erasing keys.
+*  Compares ConcurrentAVLtree (lock-free snapshot reads) with an AVLtree behind a std::mutex.
+*  Throughput is the total number of lookups of all readers per second.
+*
+*  Usage: ./concurrent_avl_bench [N] [milliseconds]   (default 1M keys, 500 ms per run)
+*/
+#include "../containers/AVLtree.hpp"
+#include "../containers/ConcurrentAVLtree.hpp"
+#include "../containers/Vector.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+
+struct MutexTree {
+	AVLtree<int> tree;
+	mutable std::mutex mutex;
+
+	bool contains(int key) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return tree.contains(key);
+	}
+	void insert(int key) {
+		std::lock_guard<std::mutex> lock(mutex);
+		tree.insert(key);
+	}
+	void erase(int key) {
+		std::lock_guard<std::mutex> lock(mutex);
+		tree.erase(key);
+	}
+};
+
+struct SnapshotTree {
+	ConcurrentAVLtree<int> tree;
+
+	//A reader pins one snapshot per batch of lookups, as a request handler would
+	size_t containsBatch(const int* keys, size_t count) const {
+		auto snapshot = tree.snapshot();
+		size_t hits = 0;
+		for (size_t i = 0; i < count; ++i) {
+			hits += snapshot.contains(keys[i]);
+		}
+		return hits;
+	}
+	void insert(int key) { tree.insert(key); }
+	void erase(int key) { tree.erase(key); }
+};
+
+size_t lookupBatch(const MutexTree& tree, const int* keys, size_t count) {
+	size_t hits = 0;
+	for (size_t i = 0; i < count; ++i) {
+		hits += tree.contains(keys[i]);
+	}
+	return hits;
+}
+
+size_t lookupBatch(const SnapshotTree& tree, const int* keys, size_t count) {
+	return tree.containsBatch(keys, count);
+}
+
+template<typename Tree>
+void run(const char* name, size_t count, size_t readers, int milliseconds) {
+	const size_t batch = 64;
+	Tree tree;
+	for (size_t i = 0; i < count; ++i) {
+		tree.insert(static_cast<int>(2 * i));
+	}
+
+	std::atomic<bool> done(false);
+	std::atomic<size_t> lookups(0);
+	std::atomic<size_t> writes(0);
+	std::atomic<size_t> hits(0);
+	Vector<std::thread> threads;
+	for (size_t r = 0; r < readers; ++r) {
+		threads.emplace_back([&, r] {
+			unsigned long long seed = 12345 + r;
+			int keys[batch];
+			size_t done_lookups = 0;
+			size_t found = 0;
+			while (!done.load(std::memory_order_relaxed)) {
+				for (size_t i = 0; i < batch; ++i) {
+					seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+					keys[i] = static_cast<int>((seed >> 33) % (2 * count));
+				}
+				found += lookupBatch(tree, keys, batch);
+				done_lookups += batch;
+			}
+			lookups += done_lookups;
+			hits += found;
+		});
+	}
+	//The writer moves odd keys in and out
+	threads.emplace_back([&] {
+		size_t done_writes = 0;
+		for (size_t i = 0; !done.load(std::memory_order_relaxed); ++i) {
+			int key = static_cast<int>(2 * (i * 1000003 % count) + 1);
+			tree.insert(key);
+			tree.erase(key);
+			done_writes += 2;
+		}
+		writes += done_writes;
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+	done = true;
+	for (size_t i = 0; i < threads.size(); ++i) {
+		threads[i].join();
+	}
+	double seconds = milliseconds / 1000.0;
+	std::cout << "  " << name << "  " << readers << " readers: " << lookups / seconds / 1e6
+		<< " M lookups/s   writer " << writes / seconds / 1e6 << " M writes/s   (hits " << hits << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	int milliseconds = argc > 2 ? std::atoi(argv[2]) : 500;
+	size_t max_readers = std::thread::hardware_concurrency();
+	if (max_readers == 0) {
+		max_readers = 1;
+	}
+
+	std::cout << count << " keys, " << milliseconds << " ms per run\n";
+	for (size_t readers = 1; readers <= max_readers; readers *= 2) {
+		run<MutexTree>("AVLtree + mutex  ", count, readers, milliseconds);
+		run<SnapshotTree>("ConcurrentAVLtree", count, readers, milliseconds);
+	}
+	return 0;
+}
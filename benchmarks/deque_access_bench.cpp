@@ -0,0 +1,89 @@
+/*
+*  Deque access benchmark
+*
+*  Fills a Vector<int> and a Deque<int> with the same N values (the deque from both ends,
+*  so its front sits in the middle of a block) and times a sum through operator[] in order,
+*  a sum through iterators, a sum at random positions and a copy of the whole container.
+*
+*  Usage: ./deque_access_bench [N] [rounds]
+*/
+#include "../containers/Deque.hpp"
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
+template<typename Function>
+void run(const char* name, size_t rounds, Function function) {
+	auto start = std::chrono::steady_clock::now();
+	long long checksum = 0;
+	for (size_t r = 0; r < rounds; ++r) {
+		checksum += function();
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+	double ms = std::chrono::duration<double, std::milli>(stop - start).count() / rounds;
+	std::cout << "  " << name << ": " << ms << " ms  (checksum " << checksum << ")\n";
+}
+
+template<typename Container>
+void measure(const char* label, Container& container, const Vector<size_t>& positions, size_t rounds) {
+	size_t count = container.size();
+	std::cout << label << "\n";
+	run("operator[] in order", rounds, [&] {
+		long long sum = 0;
+		for (size_t i = 0; i < count; ++i) {
+			sum += container[i];
+		}
+		return sum;
+	});
+	run("iterators          ", rounds, [&] {
+		long long sum = 0;
+		for (auto it = container.begin(); it != container.end(); ++it) {
+			sum += *it;
+		}
+		return sum;
+	});
+	run("operator[] random  ", rounds, [&] {
+		long long sum = 0;
+		for (size_t i = 0; i < positions.size(); ++i) {
+			sum += container[positions[i]];
+		}
+		return sum;
+	});
+	run("copy               ", rounds, [&] {
+		Container copy = container;
+		return static_cast<long long>(copy.size());
+	});
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+
+	Vector<int> vector;
+	Deque<int> deque;
+	for (size_t i = 0; i < count; ++i) {
+		vector.push_back(static_cast<int>(i));
+	}
+	for (size_t i = count / 2; i < count; ++i) {
+		deque.push_back(static_cast<int>(i));
+	}
+	for (size_t i = count / 2; i > 0; --i) {
+		deque.push_front(static_cast<int>(i - 1));
+	}
+
+	Vector<size_t> positions;
+	positions.reserve(count);
+	unsigned long long seed = 12345;
+	for (size_t i = 0; i < count; ++i) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		positions.push_back(static_cast<size_t>((seed >> 33) % count));
+	}
+
+	std::cout << count << " ints, " << rounds << " rounds\n";
+	measure("Vector<int>", vector, positions, rounds);
+	measure("Deque<int>", deque, positions, rounds);
+	return 0;
+}
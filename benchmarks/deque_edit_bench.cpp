@@ -0,0 +1,66 @@
+/*
+*  Deque middle edit benchmark
+*
+*  Inserts an element at a fixed distance from the front (near the front, the middle, near
+*  the back) of N-element containers and erases it again, K times. Vector always shifts the
+*  tail; Deque shifts whichever side of the position is shorter, with memmove for int.
+*
+*  Usage: ./deque_edit_bench [N] [K]
+*/
+#include "../containers/Deque.hpp"
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+
+template<typename Function>
+void run(const char* name, size_t edits, Function function) {
+	auto start = std::chrono::steady_clock::now();
+	function();
+	auto stop = std::chrono::steady_clock::now();
+
+	double us = std::chrono::duration<double, std::micro>(stop - start).count() / edits;
+	std::cout << "    " << name << ": " << us << " us per insert+erase\n";
+}
+
+template<typename T, typename Make>
+void measure(const char* label, size_t count, size_t edits, Make make) {
+	Vector<T> vector;
+	Deque<T> deque;
+	for (size_t i = 0; i < count; ++i) {
+		vector.push_back(make(i));
+		deque.push_back(make(i));
+	}
+
+	std::cout << label << "\n";
+	const size_t positions[] = { 10, count / 2, count - 10 };
+	const char* names[] = { "near the front", "middle", "near the back" };
+	for (size_t p = 0; p < 3; ++p) {
+		size_t pos = positions[p];
+		std::cout << "  " << names[p] << " (position " << pos << ")\n";
+		run("Vector", edits, [&] {
+			for (size_t i = 0; i < edits; ++i) {
+				vector.insert(make(i), vector.begin() + pos);
+				vector.erase(vector.begin() + pos);
+			}
+		});
+		run("Deque ", edits, [&] {
+			for (size_t i = 0; i < edits; ++i) {
+				deque.insert(deque.begin() + pos, make(i));
+				deque.erase(deque.begin() + pos);
+			}
+		});
+	}
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	size_t edits = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+
+	std::cout << count << " elements, " << edits << " edits\n";
+	measure<int>("int", count, edits, [](size_t i) { return static_cast<int>(i); });
+	measure<std::string>("std::string", count, edits / 10, [](size_t i) { return std::to_string(i); });
+	return 0;
+}
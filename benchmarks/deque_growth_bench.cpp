@@ -0,0 +1,60 @@
+/*
+*  Deque growth benchmark
+*
+*  Pushes N work items (an id and a short std::string tag) into a Vector, which moves every
+*  element when it doubles, and into the block-map Deque at its back and at its front.
+*  Prints the total time and the slowest single push: the Vector stalls at each doubling,
+*  the Deque only allocates a block or grows its map of block pointers.
+*
+*  Usage: ./deque_growth_bench [N]
+*/
+#include "../containers/Deque.hpp"
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+
+struct WorkItem {
+	long long id;
+	std::string tag;
+};
+
+template<typename Push>
+void run(const char* name, size_t count, Push push) {
+	using Clock = std::chrono::steady_clock;
+	double worst = 0;
+	auto start = Clock::now();
+	auto last = start;
+	for (size_t i = 0; i < count; ++i) {
+		push(WorkItem{ static_cast<long long>(i), "task" });
+		auto now = Clock::now();
+		double elapsed = std::chrono::duration<double, std::milli>(now - last).count();
+		if (elapsed > worst) {
+			worst = elapsed;
+		}
+		last = now;
+	}
+	double total = std::chrono::duration<double, std::milli>(last - start).count();
+	std::cout << "  " << name << ": total " << total << " ms, slowest push " << worst << " ms\n";
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+
+	std::cout << count << " pushes of " << sizeof(WorkItem) << "-byte items\n";
+	{
+		Vector<WorkItem> vector;
+		run("Vector::push_back", count, [&](const WorkItem& item) { vector.push_back(item); });
+	}
+	{
+		Deque<WorkItem> deque;
+		run("Deque::push_back ", count, [&](const WorkItem& item) { deque.push_back(item); });
+	}
+	{
+		Deque<WorkItem> deque;
+		run("Deque::push_front", count, [&](const WorkItem& item) { deque.push_front(item); });
+	}
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+*  FrozenSet lookup benchmark
+*
+*  Builds an AVLtree of N int keys, freezes it and runs the same random lookups (half of
+*  them hits) with AVLtree::contains(), FrozenSet::contains() and FrozenSet::contains_many().
+*
+*  Usage: ./frozen_set_bench [N] [lookups]
+*/
+#include "../containers/AVLtree.hpp"
+#include "../containers/FrozenSet.hpp"
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
+template<typename Function>
+void run(const char* name, size_t lookups, Function function) {
+	auto start = std::chrono::steady_clock::now();
+	size_t hits = function();
+	auto stop = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cout << "  " << name << ": " << lookups / seconds / 1e6 << " M lookups/s  (hits " << hits << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+	size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4000000;
+
+	//Even keys are stored, the lookups draw from twice the range
+	Vector<int> keys;
+	keys.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		keys.push_back(static_cast<int>(2 * i));
+	}
+	AVLtree<int> tree(keys.data(), keys.data() + count);
+	FrozenSet<int> frozen = tree.freeze();
+
+	Vector<int> queries;
+	queries.reserve(lookups);
+	unsigned long long seed = 12345;
+	for (size_t i = 0; i < lookups; ++i) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		queries.push_back(static_cast<int>((seed >> 33) % (2 * count)));
+	}
+
+	std::cout << count << " keys, " << lookups << " lookups\n";
+	run("AVLtree::contains       ", lookups, [&] {
+		size_t hits = 0;
+		for (size_t i = 0; i < lookups; ++i) {
+			hits += tree.contains(queries[i]);
+		}
+		return hits;
+	});
+	run("FrozenSet::contains     ", lookups, [&] {
+		size_t hits = 0;
+		for (size_t i = 0; i < lookups; ++i) {
+			hits += frozen.contains(queries[i]);
+		}
+		return hits;
+	});
+	run("FrozenSet::contains_many", lookups, [&] {
+		Vector<bool> found;
+		found.reserve(lookups);
+		for (size_t i = 0; i < lookups; ++i) {
+			found.push_back(false);
+		}
+		frozen.contains_many(queries.data(), lookups, found.data());
+		size_t hits = 0;
+		for (size_t i = 0; i < lookups; ++i) {
+			hits += found[i];
+		}
+		return hits;
+	});
+	return 0;
+}
@@ -0,0 +1,88 @@
+/*
+*  IntervalTree and range_sum benchmark
+*
+*  Overlap queries on N random intervals: a linear scan of a Vector (what a plain list of
+*  bookings does) vs IntervalTree::for_each_overlapping(). Then range sums over N keys:
+*  for_each_in_range() adding up the elements vs range_sum() of an AVLSum-augmented tree.
+*
+*  Usage: ./interval_tree_bench [N] [queries]   (default 100K intervals, 10K queries)
+*/
+#include "../containers/AVLtree.hpp"
+#include "../containers/IntervalTree.hpp"
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
+template<typename Function>
+void run(const char* name, size_t queries, Function function) {
+	auto start = std::chrono::steady_clock::now();
+	long long checksum = function();
+	auto stop = std::chrono::steady_clock::now();
+
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cout << "  " << name << ": " << queries / seconds / 1e3 << " K queries/s  (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+	const long range = 1000000000;
+
+	//Intervals up to 1/1000 of the range long, queries of the same length
+	unsigned long long seed = 12345;
+	auto random = [&](long limit) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		return static_cast<long>((seed >> 33) % static_cast<unsigned long long>(limit));
+	};
+	Vector<Interval<long>> intervals;
+	IntervalTree<long> tree;
+	AVLtree<long, std::less<long>, PoolAllocator<long>, AVLIdentity, AVLSum<long long>> sums;
+	for (size_t i = 0; i < count; ++i) {
+		long low = random(range);
+		intervals.push_back({ low, low + random(range / 1000) });
+		tree.insert(intervals.back());
+		sums.insert(low);
+	}
+	Vector<Interval<long>> probes;
+	for (size_t i = 0; i < queries; ++i) {
+		long low = random(range);
+		probes.push_back({ low, low + random(range / 1000) });
+	}
+
+	std::cout << count << " intervals, " << queries << " queries\n";
+	run("linear scan                 ", queries, [&] {
+		long long found = 0;
+		for (size_t q = 0; q < queries; ++q) {
+			for (size_t i = 0; i < intervals.size(); ++i) {
+				found += intervals[i].low <= probes[q].high && probes[q].low <= intervals[i].high;
+			}
+		}
+		return found;
+	});
+	run("IntervalTree overlapping    ", queries, [&] {
+		long long found = 0;
+		for (size_t q = 0; q < queries; ++q) {
+			tree.for_each_overlapping(probes[q].low, probes[q].high, [&](const Interval<long>&) { ++found; });
+		}
+		return found;
+	});
+
+	//Range sums over windows of 1/10 of the key range
+	run("for_each_in_range sum       ", queries, [&] {
+		long long total = 0;
+		for (size_t q = 0; q < queries; ++q) {
+			sums.for_each_in_range(probes[q].low, probes[q].low + range / 10, [&](long value) { total += value; });
+		}
+		return total;
+	});
+	run("range_sum (AVLSum)          ", queries, [&] {
+		long long total = 0;
+		for (size_t q = 0; q < queries; ++q) {
+			total += sums.range_sum(probes[q].low, probes[q].low + range / 10);
+		}
+		return total;
+	});
+	return 0;
+}
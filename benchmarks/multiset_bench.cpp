@@ -0,0 +1,56 @@
+/*
+*  AVLmultiset histogram benchmark
+*
+*  Inserts M keys drawn from K distinct values into an AVLtree (one node per element) and
+*  into an AVLmultiset (one node per distinct key), then counts the copies of every key.
+*
+*  Usage: ./multiset_bench [M] [K]   (default 10M inserts of 1000 distinct keys)
+*/
+#include "../containers/AVLmultiset.hpp"
+#include "../containers/AVLtree.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
+template<typename Function>
+double seconds(Function function) {
+	auto start = std::chrono::steady_clock::now();
+	function();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(stop - start).count();
+}
+
+template<typename Tree, typename CountKey>
+void run(const char* name, size_t inserts, size_t distinct, bool node_per_element, CountKey count_key) {
+	Tree tree;
+	size_t checksum = 0;
+	double insert = seconds([&] {
+		unsigned long long seed = 12345;
+		for (size_t i = 0; i < inserts; ++i) {
+			seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+			tree.insert(static_cast<int>((seed >> 33) % distinct));
+		}
+	});
+	double count = seconds([&] {
+		for (size_t key = 0; key < distinct; ++key) {
+			checksum += count_key(tree, static_cast<int>(key));
+		}
+	});
+	std::cout << "  " << name << "  insert " << inserts / insert / 1e6 << " M/s   count all keys "
+		<< count * 1e3 << " ms   nodes " << (node_per_element ? inserts : distinct) << "   (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t inserts = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	size_t distinct = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+
+	std::cout << inserts << " inserts, " << distinct << " distinct keys\n";
+	run<AVLtree<int>>("AVLtree     ", inserts, distinct, true, [](const AVLtree<int>& tree, int key) {
+		return tree.count_range(key, key);
+	});
+	run<AVLmultiset<int>>("AVLmultiset ", inserts, distinct, false, [](const AVLmultiset<int>& tree, int key) {
+		return tree.count(key);
+	});
+	return 0;
+}
@@ -0,0 +1,92 @@
+/*
+*  NodePool benchmark
+*
+*  Insert/erase churn on List and AVLtree, once with the plain Allocator<T> (one
+*  ::operator new per node) and once with the default PoolAllocator<T> (nodes from
+*  NodePool chunks). Every round fills a container, removes half of the elements,
+*  refills it and clears it, so freed nodes are reused and clear() can drop the pool.
+*
+*  Usage: ./node_pool_bench [elements] [rounds]
+*/
+#include "../containers/List.hpp"
+#include "../containers/AVLtree.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+
+
+template<typename ListType>
+long long list_churn(size_t elements) {
+	ListType list;
+	for (size_t i = 0; i < elements; ++i) {
+		list.push_back(static_cast<long long>(i));
+	}
+	for (size_t i = 0; i < elements / 2; ++i) {
+		list.pop_front();
+	}
+	for (size_t i = 0; i < elements / 2; ++i) {
+		list.push_front(static_cast<long long>(i));
+	}
+
+	long long checksum = 0;
+	for (long long value : list) {
+		checksum += value;
+	}
+	list.clear();
+	return checksum;
+}
+
+template<typename TreeType>
+long long tree_churn(size_t elements) {
+	TreeType tree;
+	//Multiplicative hashing spreads the keys, so the tree is not built in order
+	for (size_t i = 0; i < elements; ++i) {
+		tree.insert(static_cast<long long>(i * 2654435761u % 1000003));
+	}
+	for (size_t i = 0; i < elements; i += 2) {
+		auto* node = tree.find(static_cast<long long>(i * 2654435761u % 1000003));
+		if (node) {
+			tree.remove(node);
+		}
+	}
+	for (size_t i = 0; i < elements; i += 2) {
+		tree.insert(static_cast<long long>(i * 2654435761u % 1000003));
+	}
+
+	long long checksum = static_cast<long long>(tree.size());
+	tree.clear();
+	return checksum;
+}
+
+template<typename Function>
+void run(const char* name, size_t rounds, Function function) {
+	long long checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < rounds; ++r) {
+		checksum += function();
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+	double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+	std::cout << "  " << name << ": " << ms << " ms  (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	size_t rounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20;
+
+	using PlainList = List<long long, Allocator<long long>>;
+	using PoolList = List<long long>;
+	using PlainTree = AVLtree<long long, std::less<long long>, Allocator<long long>>;
+	using PoolTree = AVLtree<long long>;
+
+	std::cout << "List, " << elements << " elements, " << rounds << " rounds\n";
+	run("Allocator    ", rounds, [&] { return list_churn<PlainList>(elements); });
+	run("PoolAllocator", rounds, [&] { return list_churn<PoolList>(elements); });
+
+	std::cout << "AVLtree, " << elements << " elements, " << rounds << " rounds\n";
+	run("Allocator    ", rounds, [&] { return tree_churn<PlainTree>(elements); });
+	run("PoolAllocator", rounds, [&] { return tree_churn<PoolTree>(elements); });
+	return 0;
+}
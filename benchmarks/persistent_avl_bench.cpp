@@ -0,0 +1,97 @@
+/*
+*  PersistentAVLtree history benchmark
+*
+*  Keeps `versions` historical versions of an N-key ordered index, each one insert after
+*  the previous: as AVLtree copies (copy constructor, then insert) and as PersistentAVLtree
+*  versions (insert() returns the next version). Prints the time per version and the bytes
+*  held by all versions together.
+*
+*  Usage: ./persistent_avl_bench [N] [versions]   (default 100K keys, 200 versions)
+*/
+#include "../containers/AVLtree.hpp"
+#include "../containers/PersistentAVLtree.hpp"
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
+//Bytes currently allocated through any CountingAlloc
+static size_t live_bytes = 0;
+
+template<typename T>
+struct CountingAlloc {
+	using value_type = T;
+
+	CountingAlloc() = default;
+
+	template<typename U>
+	CountingAlloc(const CountingAlloc<U>&) {}
+
+	T* allocate(size_t count) {
+		live_bytes += count * sizeof(T);
+		return static_cast<T*>(::operator new(count * sizeof(T)));
+	}
+
+	void deallocate(T* ptr, size_t count) {
+		live_bytes -= count * sizeof(T);
+		::operator delete(ptr);
+	}
+
+	template<typename U>
+	bool operator==(const CountingAlloc<U>&) const { return true; }
+
+	template<typename U>
+	bool operator!=(const CountingAlloc<U>&) const { return false; }
+};
+
+template<typename Function>
+double seconds(Function function) {
+	auto start = std::chrono::steady_clock::now();
+	function();
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(stop - start).count();
+}
+
+template<typename Tree, typename Build, typename NextVersion>
+void run(const char* name, size_t count, size_t versions, Build build, NextVersion next) {
+	size_t before = live_bytes;
+	{
+		Vector<Tree> history;
+		history.reserve(versions + 1);
+		history.push_back(Tree());
+		for (size_t i = 0; i < count; ++i) {
+			build(history[0], static_cast<int>(i * 1000003 % count));
+		}
+
+		double time = seconds([&] {
+			for (size_t i = 0; i < versions; ++i) {
+				history.push_back(next(history.back(), static_cast<int>(count + i)));
+			}
+		});
+		std::cout << "  " << name << "  " << time / versions * 1e6 << " us/version   "
+			<< (live_bytes - before) / 1e6 << " MB for " << versions + 1 << " versions (last has "
+			<< history.back().size() << " keys)\n";
+	}
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	size_t versions = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+
+	using Copied = AVLtree<int, std::less<int>, CountingAlloc<int>>;
+	using Persistent = PersistentAVLtree<int, std::less<int>, CountingAlloc<int>>;
+
+	std::cout << count << " keys, " << versions << " versions\n";
+	run<Copied>("AVLtree copies   ", count, versions,
+		[](Copied& tree, int key) { tree.insert(key); },
+		[](const Copied& tree, int key) {
+			Copied next(tree);
+			next.insert(key);
+			return next;
+		});
+	run<Persistent>("PersistentAVLtree", count, versions,
+		[](Persistent& tree, int key) { tree = std::move(tree).insert(key); },
+		[](const Persistent& tree, int key) { return tree.insert(key); });
+	return 0;
+}
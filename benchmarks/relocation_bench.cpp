@@ -0,0 +1,77 @@
+/*
+*  Relocation benchmark
+*
+*  Grows Vector<double> and Vector<int64_t> by push_back up to N elements (default 100M)
+*  and compares it with the element-wise doubling the containers used before
+*  Relocate.hpp (new T[] for the new buffer, then a loop of assignments).
+*
+*  Usage: ./relocation_bench [N]
+*/
+#include "../containers/Vector.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+
+//The pre-relocation growth strategy, kept here as the baseline
+template<typename T>
+class ElementwiseBuffer {
+private:
+	size_t _size = 0;
+	size_t _capacity = 10;
+	T* _data = new T[10];
+
+public:
+	~ElementwiseBuffer() {
+		delete[] _data;
+	}
+
+	void push_back(const T& value) {
+		if (_size == _capacity) {
+			T* new_data = new T[_capacity * 2];
+			for (size_t i = 0; i < _size; ++i) {
+				new_data[i] = std::move(_data[i]);
+			}
+			delete[] _data;
+			_data = new_data;
+			_capacity *= 2;
+		}
+		_data[_size++] = value;
+	}
+
+	const T& operator[](size_t index) const {
+		return _data[index];
+	}
+};
+
+template<typename Container, typename T>
+double fill_ms(size_t count, T& checksum) {
+	auto start = std::chrono::steady_clock::now();
+	Container container;
+	for (size_t i = 0; i < count; ++i) {
+		container.push_back(static_cast<T>(i));
+	}
+	checksum += container[count - 1];
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+template<typename T>
+void run(const char* name, size_t count) {
+	T checksum = 0;
+	double baseline = fill_ms<ElementwiseBuffer<T>>(count, checksum);
+	double relocated = fill_ms<Vector<T>>(count, checksum);
+
+	std::cout << name << ": element-wise " << baseline << " ms, relocated " << relocated
+		<< " ms, speedup x" << baseline / relocated << "  (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+	std::cout << "Growth to " << count << " elements\n";
+
+	run<double>("Vector<double> ", count);
+	run<int64_t>("Vector<int64_t>", count);
+	return 0;
+}
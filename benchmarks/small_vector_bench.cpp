@@ -0,0 +1,76 @@
+/*
+*  SmallVector benchmark
+*
+*  Builds many short-lived containers of 1..16 elements, the typical per-request
+*  workload, and reports heap allocations and time for Vector and SmallVector<T, 8>.
+*  Allocations are counted by replacing the global operator new, so the payload is a
+*  type with a user-provided copy constructor (buffers of trivially relocatable types
+*  come from malloc and would not be seen).
+*
+*  Usage: ./small_vector_bench [rounds]
+*/
+#include "../containers/Vector.hpp"
+#include "../containers/SmallVector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+
+static size_t allocation_count = 0;
+
+void* operator new(size_t size) {
+	++allocation_count;
+	void* ptr = std::malloc(size ? size : 1);
+	if (!ptr) { throw std::bad_alloc(); }
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+
+struct Order {
+	long long id;
+	double price;
+
+	Order(long long id_, double price_) : id(id_), price(price_) {}
+	Order(const Order& other) : id(other.id), price(other.price) {}
+	Order& operator=(const Order& other) = default;
+};
+
+template<typename Container>
+void run(const char* name, size_t rounds, size_t elements) {
+	size_t allocations_before = allocation_count;
+	double checksum = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < rounds; ++r) {
+		Container container;
+		for (size_t i = 0; i < elements; ++i) {
+			container.emplace_back(static_cast<long long>(r + i), 1.5);
+		}
+		checksum += container[elements - 1].price;
+	}
+	auto stop = std::chrono::steady_clock::now();
+
+	double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+	std::cout << "  " << name << ": " << (allocation_count - allocations_before) / double(rounds)
+		<< " allocations/container, " << ms << " ms  (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char** argv) {
+	size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+	for (size_t elements = 1; elements <= 16; elements *= 2) {
+		std::cout << elements << " element(s), " << rounds << " containers\n";
+		run<Vector<Order>>("Vector        ", rounds, elements);
+		run<SmallVector<Order, 8>>("SmallVector<8>", rounds, elements);
+	}
+	return 0;
+}
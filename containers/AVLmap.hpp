@@ -0,0 +1,162 @@
+/*
+*  AVLmap Documentation
+*
+*  AVLmap<K, V, Compare> is an ordered key/value map on the AVLtree engine. The entries
+*  are std::pair<const K, V>, AVLtree compares only their keys (KeyOf = AVLSelectFirst),
+*  so rotations, balancing, order statistics, bounds, split/join and set operations are
+*  the AVLtree ones.
+*
+*  Key Features:
+*    - Unique keys: insert() and try_emplace() leave an existing entry alone,
+*      insert_or_assign() overwrites its value, operator[] inserts V() if the key is missing.
+*    - try_emplace() builds the entry in place from the key and the value arguments, and
+*      only if the key is not there yet.
+*    - Heterogeneous lookup: with a transparent Compare (std::less<>) find(), contains(),
+*      at(), lower_bound(), upper_bound(), equal_range() and rank() take any type the
+*      comparator accepts, for example const char* or std::string_view for String keys,
+*      and never build a K. Without it the key is converted to K once per lookup.
+*    - Iterators dereference to std::pair<const K, V>.
+*
+*  Notes:
+*    - Everything inherited from AVLtree is available. append_max() rejects a key equal to
+*      the maximum; assign_sorted() and join() do not check for duplicate keys, the caller
+*      must keep them unique.
+*    - Nodes come from Alloc rebound to the node type, PoolAllocator by default.
+*    - Not thread-safe for concurrent modification.
+*/
+#pragma once
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "AVLtree.hpp"
+
+
+template<typename K, typename V, typename Compare = std::less<K>, typename Alloc = PoolAllocator<std::pair<const K, V>>>
+class AVLmap : public AVLtree<std::pair<const K, V>, Compare, Alloc, AVLSelectFirst> {
+private:
+	using Base = AVLtree<std::pair<const K, V>, Compare, Alloc, AVLSelectFirst>;
+	using Node = typename Base::Node;
+
+	template<typename Key>
+	using LookupKey = typename Base::template LookupKey<Key>;
+
+	template<typename Key, typename... Args>
+	std::pair<typename Base::Iterator, bool> _try_emplace(Key&& key, Args&&... args) {
+		//The key is compared first, it is moved into the entry only if the entry is created
+		auto result = this->emplaceUnique(static_cast<const K&>(key), std::in_place, std::piecewise_construct,
+			std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return { typename Base::Iterator(result.first, this), result.second };
+	}
+
+	template<typename Key, typename M>
+	std::pair<typename Base::Iterator, bool> _insert_or_assign(Key&& key, M&& value) {
+		auto result = this->emplaceUnique(static_cast<const K&>(key), std::in_place,
+			std::forward<Key>(key), std::forward<M>(value));
+		if (!result.second) {
+			result.first->data.second = std::forward<M>(value);
+		}
+		return { typename Base::Iterator(result.first, this), result.second };
+	}
+
+	template<typename Key>
+	Node* _find_or_throw(const Key& key) const {
+		const LookupKey<Key>& lookup = key;
+		Node* node = this->findNode(lookup);
+		if (!node) {
+			throw std::out_of_range("AVLmap: key not found");
+		}
+		return node;
+	}
+
+public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<const K, V>;
+	using Iterator = typename Base::Iterator;
+	using ConstIterator = typename Base::ConstIterator;
+
+	//Constructors
+	AVLmap() = default;
+	explicit AVLmap(const Alloc& alloc) : Base(alloc) {}
+
+	//Later duplicates of a key are ignored, as in insert()
+	AVLmap(std::initializer_list<value_type> init, const Alloc& alloc = Alloc()) : Base(alloc) {
+		for (const value_type& entry : init) {
+			insert(entry);
+		}
+	}
+
+	AVLmap(const AVLmap& other) = default;
+	AVLmap(AVLmap&& other) = default;
+	AVLmap& operator=(const AVLmap& other) = default;
+	AVLmap& operator=(AVLmap&& other) = default;
+
+	//Inserts a copy of entry unless its key exists, returns the entry with that key
+	//and whether it was inserted
+	std::pair<Iterator, bool> insert(const value_type& entry) {
+		auto result = this->emplaceUnique(entry.first, entry);
+		return { Iterator(result.first, this), result.second };
+	}
+
+	//Appends entry as the new largest key from the cached rightmost node. Keys stay unique:
+	//throws std::invalid_argument unless the key is greater than every key in the map.
+	Iterator append_max(const value_type& entry) {
+		if (this->rightmost && !this->comp(this->rightmost->data.first, entry.first)) {
+			throw std::invalid_argument("AVLmap::append_max: key is not greater than the maximum");
+		}
+		return Base::append_max(entry);
+	}
+
+	//Builds the entry from key and V(args...) only if key is missing
+	template<typename... Args>
+	std::pair<Iterator, bool> try_emplace(const K& key, Args&&... args) {
+		return _try_emplace(key, std::forward<Args>(args)...);
+	}
+
+	template<typename... Args>
+	std::pair<Iterator, bool> try_emplace(K&& key, Args&&... args) {
+		return _try_emplace(std::move(key), std::forward<Args>(args)...);
+	}
+
+	//Inserts the entry, or assigns value to the existing one; the second member is true on insertion
+	template<typename M>
+	std::pair<Iterator, bool> insert_or_assign(const K& key, M&& value) {
+		return _insert_or_assign(key, std::forward<M>(value));
+	}
+
+	template<typename M>
+	std::pair<Iterator, bool> insert_or_assign(K&& key, M&& value) {
+		return _insert_or_assign(std::move(key), std::forward<M>(value));
+	}
+
+	V& operator[](const K& key) {
+		return try_emplace(key).first->second;
+	}
+
+	V& operator[](K&& key) {
+		return try_emplace(std::move(key)).first->second;
+	}
+
+	//Value of the entry with key, throws std::out_of_range if there is none
+	template<typename Key = K>
+	V& at(const Key& key) {
+		return _find_or_throw(key)->data.second;
+	}
+
+	template<typename Key = K>
+	const V& at(const Key& key) const {
+		return _find_or_throw(key)->data.second;
+	}
+
+	//Replaces the contents with [first, last), later duplicates of a key are ignored.
+	//For sorted input with unique keys AVLtree::assign_sorted() is O(n).
+	template<typename InputIt>
+	void assign(InputIt first, InputIt last) {
+		this->clear();
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+
+};
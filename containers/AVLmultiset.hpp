@@ -0,0 +1,272 @@
+/*
+*  AVLmultiset Documentation
+*
+*  AVLmultiset<T, Compare> is an ordered multiset that keeps one node per distinct key with
+*  its multiplicity, instead of one node per element as AVLtree does with equal elements.
+*  Memory and rebalancing scale with the number of distinct keys, which suits histogram-like
+*  workloads that insert the same keys over and over.
+*
+*  Key Features:
+*    - insert(key, n) adds n copies in O(log d) (d = distinct keys), count(key) reads the
+*      multiplicity, erase_one(key) removes one copy and erase(key) all of them.
+*    - size() is the number of elements counting copies, distinct_size() the number of keys.
+*    - Iteration yields every copy: the iterator steps through the copies of a key before
+*      moving to the next node, nothing is materialized.
+*    - rank(key) counts copies too in O(log d): the tree is an AVLtree augmented with the
+*      sum of the multiplicities (AVLSum), so every subtree knows how many elements it holds.
+*    - for_each_distinct(f) visits each key once with its multiplicity.
+*
+*  Notes:
+*    - The nodes hold std::pair<const T, size_t>; Alloc is rebound to the node type,
+*      PoolAllocator by default.
+*    - Changing a multiplicity refreshes the subtree sums on the path to the root, O(log d).
+*    - Iterators to the copies of a key are invalidated when its last copy is erased.
+*    - Not thread-safe for concurrent modification.
+*/
+#pragma once
+#include <initializer_list>
+#include <utility>
+#include "AVLtree.hpp"
+
+
+//Get for the augmentation: the multiplicity stored next to the key
+struct AVLSelectSecond {
+	template<typename Pair>
+	const typename Pair::second_type& operator()(const Pair& pair) const {
+		return pair.second;
+	}
+};
+
+
+template<typename T, typename Compare = std::less<T>, typename Alloc = PoolAllocator<T>>
+class AVLmultiset : private AVLtree<std::pair<const T, size_t>, Compare,
+	rebind_alloc_t<Alloc, std::pair<const T, size_t>>, AVLSelectFirst, AVLSum<size_t, AVLSelectSecond>> {
+private:
+	using Base = AVLtree<std::pair<const T, size_t>, Compare,
+		rebind_alloc_t<Alloc, std::pair<const T, size_t>>, AVLSelectFirst, AVLSum<size_t, AVLSelectSecond>>;
+	using Node = typename Base::Node;
+
+	template<typename K>
+	using LookupKey = typename Base::template LookupKey<K>;
+
+	static size_t totalOf(const Node* node) {
+		return node ? node->summary : 0;
+	}
+
+	//The multiplicity changed: the path to the root gets its sums recomputed, the
+	//heights do not change so nothing rotates
+	void refreshCounts(Node* node) {
+		this->balancing(node);
+	}
+
+public:
+	using key_type = T;
+	using value_type = T;
+	using allocator_type = Alloc;
+
+	//---------------------------------- I T E R A T O R ----------------------------------
+	//Forward iterator over all copies: (node, copy index within the node)
+	class ConstIterator {
+	private:
+		const Node* node;
+		size_t copy;
+
+		friend class AVLmultiset;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const T*;
+		using reference = const T&;
+
+		ConstIterator(const Node* _node = nullptr, size_t _copy = 0) : node(_node), copy(_copy) {}
+
+		void is_valid() const {
+			if (!node) {
+				throw std::runtime_error("Iterator equal nullptr");
+			}
+		}
+
+		const T& operator*() const {
+			is_valid();
+			return node->data.first;
+		}
+
+		const T* operator->() const {
+			is_valid();
+			return &node->data.first;
+		}
+
+		ConstIterator& operator++() {
+			is_valid();
+			if (++copy == node->data.second) {
+				node = node->next();
+				copy = 0;
+			}
+			return *this;
+		}
+
+		ConstIterator operator++(int) {
+			ConstIterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		bool operator==(const ConstIterator& other) const {
+			return node == other.node && copy == other.copy;
+		}
+
+		bool operator!=(const ConstIterator& other) const {
+			return !(*this == other);
+		}
+	};
+	//-------------------------------------------------------------------------------------
+
+	//Constructors
+	AVLmultiset() = default;
+	explicit AVLmultiset(const Alloc& alloc) : Base(typename Base::allocator_type(alloc)) {}
+
+	//count copies of value in a single node
+	AVLmultiset(size_t count, const T& value, const Alloc& alloc = Alloc()) : AVLmultiset(alloc) {
+		insert(value, count);
+	}
+
+	AVLmultiset(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : AVLmultiset(init.begin(), init.end(), alloc) {}
+
+	template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+	AVLmultiset(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : AVLmultiset(alloc) {
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+
+	AVLmultiset(const AVLmultiset& other) = default;
+	AVLmultiset(AVLmultiset&& other) = default;
+	AVLmultiset& operator=(const AVLmultiset& other) = default;
+	AVLmultiset& operator=(AVLmultiset&& other) = default;
+
+	//Adds count copies of key, O(log d)
+	void insert(const T& key, size_t count = 1) {
+		if (count == 0) {
+			return;
+		}
+		auto result = this->emplaceUnique(key, std::in_place, key, count);
+		if (!result.second) {
+			result.first->data.second += count;
+			refreshCounts(result.first);
+		}
+	}
+
+	//Removes one copy of key, false if there is none
+	template<typename K = T>
+	bool erase_one(const K& key) {
+		const LookupKey<K>& lookup = key;
+		Node* node = this->findNode(lookup);
+		if (!node) {
+			return false;
+		}
+		if (node->data.second > 1) {
+			--node->data.second;
+			refreshCounts(node);
+		}
+		else {
+			this->removeNode(node);
+		}
+		return true;
+	}
+
+	//Removes every copy of key, returns how many there were
+	template<typename K = T>
+	size_t erase(const K& key) {
+		const LookupKey<K>& lookup = key;
+		Node* node = this->findNode(lookup);
+		if (!node) {
+			return 0;
+		}
+		size_t removed = node->data.second;
+		this->removeNode(node);
+		return removed;
+	}
+
+	//Multiplicity of key, 0 if it is missing
+	template<typename K = T>
+	size_t count(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		Node* node = this->findNode(lookup);
+		return node ? node->data.second : 0;
+	}
+
+	template<typename K = T>
+	bool contains(const K& key) const {
+		return Base::contains(key);
+	}
+
+	//Number of elements less than key, copies included, O(log d)
+	template<typename K = T>
+	size_t rank(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		size_t result = 0;
+		for (const Node* current = this->root; current;) {
+			if (this->comp(current->data.first, lookup)) {
+				result += totalOf(current->left) + current->data.second;
+				current = current->right;
+			}
+			else {
+				current = current->left;
+			}
+		}
+		return result;
+	}
+
+	//First copy of the first key not less than key (greater than key for upper_bound)
+	template<typename K = T>
+	ConstIterator lower_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(this->boundNode(lookup, false));
+	}
+
+	template<typename K = T>
+	ConstIterator upper_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(this->boundNode(lookup, true));
+	}
+
+	//Calls function(key, multiplicity) for every distinct key in order
+	template<typename Function>
+	void for_each_distinct(Function&& function) const {
+		for (const auto& entry : static_cast<const Base&>(*this)) {
+			function(entry.first, entry.second);
+		}
+	}
+
+	//Elements counting copies, O(1)
+	size_t size() const {
+		return totalOf(this->root);
+	}
+
+	size_t distinct_size() const {
+		return Base::size();
+	}
+
+	bool empty() const {
+		return Base::empty();
+	}
+
+	void clear() {
+		Base::clear();
+	}
+
+	Alloc get_allocator() const {
+		return Alloc(Base::get_allocator());
+	}
+
+	ConstIterator begin() const {
+		return ConstIterator(this->leftmost);
+	}
+
+	ConstIterator end() const {
+		return ConstIterator();
+	}
+
+};
@@ -7,25 +7,51 @@
 *
 *  Key Features:
 *    - Automatic balancing via single and double rotations (left/right)
-*    - Support for insert, remove, and search operations
-*    - Iterator with element access
+*    - Support for insert, erase (by iterator or key), and search operations
+*    - Removal relinks nodes and never copies or moves an element, it invalidates only
+*      iterators to the removed element
+*    - Iterator and ConstIterator with element access
+*    - Hinted insert(hint, value) and append_max(value) skip the descent from the root
+*      when the position is known (nearly sorted input); begin() is O(1), the smallest
+*      and largest nodes are cached
+*    - Ordered queries: lower_bound, upper_bound, equal_range and for_each_in_range,
+*      O(log n) to find the start plus the elements visited
 *    - Height tracking and parent-pointer support for efficient upward traversal
+*    - split(key) and join(left, key, right) in O(log n) using the stored heights, and on top
+*      of them union_with, intersect_with and difference_with in O(m log(n / m + 1)),
+*      with independent subtrees processed on default_thread_pool() (ThreadPool.hpp)
+*    - Bulk construction: AVLtree(first, last), assign() and assign_sorted() build a perfectly
+*      balanced tree from sorted input in O(n), unsorted input is sorted with parallel_sort()
+*    - Order statistics: every node stores the size of its subtree, so rank(), select(),
+*      nth(), count_range() and iterator += / -= are O(log n)
+*    - Augmentation: with an Augment (AVLSum, AVLMin, AVLMax or a custom one) every node
+*      also keeps a summary of its subtree, maintained wherever height and size are;
+*      summary() and range_sum(low, high) read it in O(1) and O(log n). IntervalTree
+*      (IntervalTree.hpp) is built on it.
+*    - freeze() copies the tree into a read-only FrozenSet (FrozenSet.hpp), a contiguous
+*      Eytzinger array with branch-free, prefetching and batched lookups
 *    - Full support for deep copy and move semantics
-*    - Memory-safe node management using recursive destruction
+*    - Memory-safe node management: clear, destruction and copying are iterative and need
+*      no stack or extra memory, so deep trees are safe on small-stack threads
 *
 *  Implementation Notes:
-*    - Node structure includes parent pointer and subtree height
+*    - Node structure includes parent pointer, subtree height and subtree size
 *    - Balancing is handled bottom-up after insertions and deletions
-*    - Rotations correctly update all parent/child relationships and height
-*    - Iterator supports basic arithmetic, dereferencing, and comparison
-*    - Tree uses recursive functions for destruction and copying
+*    - Rotations correctly update all parent/child relationships, height and size
+*    - Iterator supports arithmetic in O(log n), dereferencing, and comparison
+*    - Destruction rotates the tree into a list on the fly, copying walks the parent
+*      pointers of source and copy together; both are O(n)
 *    - T must support default constructor, comparisons, and move semantics
+*    - Nodes come from Alloc rebound to the node type. The default PoolAllocator<T>
+*      (NodePool.hpp) cuts them from contiguous chunks owned by this tree, and clear()
+*      drops whole chunks instead of freeing every node when the tree owns the pool alone.
+*      Copy/move assignment follow the propagate_on_container_* traits of Alloc.
 *
 *  Limitations:
-*    - Iterators become invalid after structural modifications (insert/remove)
+*    - Iterators to a removed element become invalid (all others stay valid)
+*    - An element must not be changed in place in a way that changes its Augment summary
 *    - Not thread-safe for concurrent modification or access
-*    - No support for custom allocators or memory pooling
-*    - There is no support for constant objects
+*    - find() and get_root() return raw Node pointers
 *
 *  Usage Recommendations:
 *    - Suitable for ordered data where fast insertion/deletion and lookup is needed
@@ -34,75 +60,350 @@
 */
 #pragma once 
 #include <stdexcept>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Allocator.hpp"
+#include "NodePool.hpp"
+#include "ParallelSort.hpp"
+#include "ThreadPool.hpp"
+#include "Vector.hpp"
+
+//Set operations split the work across threads only for subtrees of at least this many nodes
+inline constexpr size_t parallel_set_cutoff = 4096;
+
+//KeyOf for sets: the element is its own key
+struct AVLIdentity {
+	template<typename T>
+	const T& operator()(const T& value) const {
+		return value;
+	}
+};
 
-template<typename T, typename Compare = std::less<T>>
-class AVLtree {
-private:
-	struct Node {
-		T data;
-		Node* left;
-		Node* right;
-		Node* parent;
-		int height = 1;
+//KeyOf for maps: the key is the first member of the stored pair
+struct AVLSelectFirst {
+	template<typename Pair>
+	const typename Pair::first_type& operator()(const Pair& pair) const {
+		return pair.first;
+	}
+};
+
+//Augment of a tree without per-node summaries
+struct AVLNoAugment {};
+
+//Augments keep in every node a summary of its subtree, recomputed wherever the height is:
+//summary_type, of(element), combine(left part, right part) (associative) and identity().
+//Get picks the summarized value out of the element.
+template<typename S, typename Get = AVLIdentity>
+struct AVLSum {
+	using summary_type = S;
+
+	template<typename T>
+	static S of(const T& value) {
+		return static_cast<S>(Get()(value));
+	}
+
+	static S combine(const S& a, const S& b) {
+		return a + b;
+	}
+
+	static S identity() {
+		return S();
+	}
+};
+
+template<typename S, typename Get = AVLIdentity>
+struct AVLMin {
+	using summary_type = S;
+
+	template<typename T>
+	static S of(const T& value) {
+		return static_cast<S>(Get()(value));
+	}
+
+	static S combine(const S& a, const S& b) {
+		return b < a ? b : a;
+	}
+
+	static S identity() {
+		return std::numeric_limits<S>::max();
+	}
+};
+
+template<typename S, typename Get = AVLIdentity>
+struct AVLMax {
+	using summary_type = S;
+
+	template<typename T>
+	static S of(const T& value) {
+		return static_cast<S>(Get()(value));
+	}
+
+	static S combine(const S& a, const S& b) {
+		return a < b ? b : a;
+	}
+
+	static S identity() {
+		return std::numeric_limits<S>::lowest();
+	}
+};
 
-		Node() : left(nullptr), right(nullptr), parent(nullptr), height(1) {}
-		Node(const T& _data, Node* _left = nullptr, Node* _right = nullptr, Node* _parent = nullptr, int _height = 1) :
-			data(_data), left(_left), right(_right), parent(_parent), height(_height) {}
-		Node(const Node& node) :
-			data(node.data), left(node.left), right(node.right), parent(node.parent), height(node.height) {}
-		~Node() = default;
+//Summary stored in the node, nothing for AVLNoAugment
+template<typename Augment>
+struct AVLAugmentBase {
+	typename Augment::summary_type summary = Augment::identity();
+};
+
+template<>
+struct AVLAugmentBase<AVLNoAugment> {};
+
+//Read-only Eytzinger-ordered copy made by AVLtree::freeze() (FrozenSet.hpp)
+template<typename T, typename Compare = std::less<T>, typename Alloc = Allocator<T>, typename KeyOf = AVLIdentity>
+class FrozenSet;
+
+template<typename Compare, typename = void>
+struct is_transparent_compare : std::false_type {};
+
+template<typename Compare>
+struct is_transparent_compare<Compare, std::void_t<typename Compare::is_transparent>> : std::true_type {};
+
+//The node lives outside of AVLtree so that the allocator base class can be rebound to it
+template<typename T, typename Augment = AVLNoAugment>
+struct AVLNode : AVLAugmentBase<Augment> {
+	T data;
+	AVLNode* left;
+	AVLNode* right;
+	AVLNode* parent;
+	int height = 1;
+	size_t size = 1;        // Number of nodes in the subtree rooted here
+
+	AVLNode() : left(nullptr), right(nullptr), parent(nullptr), height(1), size(1) {}
+	AVLNode(const T& _data, AVLNode* _left = nullptr, AVLNode* _right = nullptr, AVLNode* _parent = nullptr, int _height = 1) :
+		data(_data), left(_left), right(_right), parent(_parent), height(_height), size(1) {}
+	AVLNode(const AVLNode& node) : AVLAugmentBase<Augment>(node),
+		data(node.data), left(node.left), right(node.right), parent(node.parent), height(node.height), size(node.size) {}
+	//Builds data from args, for example the key and value of an AVLmap entry
+	template<typename... Args>
+	explicit AVLNode(std::in_place_t, Args&&... args) :
+		data(std::forward<Args>(args)...), left(nullptr), right(nullptr), parent(nullptr), height(1), size(1) {}
+	~AVLNode() = default;
+
+	static size_t sizeOf(const AVLNode* node) {
+		return node ? node->size : 0;
+	}
+
+	//Calculates the balance factor of the current node, that is, the difference between the height of the right and left subtree.
+	int balance() const {
+		return ((right) ? right->height : 0) - ((left) ? left->height : 0);
+	}
+
+	//Updates the height field of the current node based on the heights of its children.
+	void updateHeight() {
+		height = std::max(((right) ? right->height : 0), ((left) ? left->height : 0)) + 1;
+	}
+
+	//Updates the subtree size from the children, must follow every change of left or right
+	void updateSize() {
+		size = sizeOf(left) + sizeOf(right) + 1;
+	}
 
-		//Calculates the balance factor of the current node, that is, the difference between the height of the right and left subtree.
-		int balance() const {
-			return ((right) ? right->height : 0) - ((left) ? left->height : 0);
+	//Recomputes the Augment summary from the element and the children's summaries
+	void updateSummary() {
+		if constexpr (!std::is_same_v<Augment, AVLNoAugment>) {
+			auto summary = Augment::of(data);
+			if (left) {
+				summary = Augment::combine(left->summary, summary);
+			}
+			if (right) {
+				summary = Augment::combine(summary, right->summary);
+			}
+			this->summary = std::move(summary);
 		}
+	}
+
+	void update() {
+		updateHeight();
+		updateSize();
+		updateSummary();
+	}
 
-		//Updates the height field of the current node based on the heights of its children.
-		void updateHeight() {
-			height = std::max(((right) ? right->height : 0), ((left) ? left->height : 0)) + 1;
+	//Position of this node in the in-order sequence of the whole tree, O(log n)
+	size_t index() const {
+		size_t result = sizeOf(left);
+		const AVLNode* current = this;
+		for (const AVLNode* p = parent; p; current = p, p = p->parent) {
+			if (current == p->right) {
+				result += sizeOf(p->left) + 1;
+			}
 		}
+		return result;
+	}
 
-		Node* minNode() {
-			Node* current = this;
-			while (current->left) {
-				current = current->left;
+	AVLNode* minNode() {
+		AVLNode* current = this;
+		while (current->left) {
+			current = current->left;
+		}
+		return current;
+	}
+
+	AVLNode* maxNode() {
+		AVLNode* current = this;
+		while (current->right) {
+			current = current->right;
+		}
+		return current;
+	}
+
+	bool isLeaf() const {
+		return (!left) && (!right);
+	}
+
+	AVLNode* next() const {
+		if (right) {
+			return right->minNode();
+		}
+		const AVLNode* current = this;
+		AVLNode* p = parent;
+		while (p) {
+			if (current == p->left) {
+				break;
 			}
-			return current;
+			current = p;
+			p = current->parent;
+		}
+		return p;
+	}
+
+	AVLNode* prev() const {
+		if (left) {
+			return left->maxNode();
+		}
+		const AVLNode* current = this;
+		AVLNode* p = parent;
+		while (p && current == p->left) {
+			current = p;
+			p = current->parent;
 		}
+		return p;
+	}
+
+};
+
+
+template<typename T, typename Compare = std::less<T>, typename Alloc = PoolAllocator<T>, typename KeyOf = AVLIdentity, typename Augment = AVLNoAugment>
+class AVLtree : private AllocatorHolder<rebind_alloc_t<Alloc, AVLNode<T, Augment>>> {
+public:
+	using key_type = std::decay_t<decltype(KeyOf()(std::declval<const T&>()))>;
+	using value_type = T;
 
-		Node* maxNode() {
-			Node* current = this;
-			while (current->right) {
+protected:
+	using Node = AVLNode<T, Augment>;
+	using NodeAlloc = rebind_alloc_t<Alloc, Node>;
+	using NodeOps = AllocatorOps<NodeAlloc>;
+	using Key = key_type;
+
+	//With a transparent Compare lookups use the given key as it is, otherwise it is
+	//converted to Key once per call instead of once per comparison
+	template<typename K>
+	using LookupKey = std::conditional_t<is_transparent_compare<Compare>::value, K, Key>;
+
+	Node* root = nullptr;
+	Node* leftmost = nullptr;     // Smallest and largest node, nullptr when empty
+	Node* rightmost = nullptr;
+	size_t count = 0;
+	Compare comp;
+
+	static const Key& keyOf(const T& value) {
+		return KeyOf()(value);
+	}
+
+	//Node with the given key or nullptr
+	template<typename K>
+	Node* findNode(const K& key) const {
+		Node* current = root;
+		while (current) {
+			if (comp(key, keyOf(current->data))) {
+				current = current->left;
+			}
+			else if (comp(keyOf(current->data), key)) {
 				current = current->right;
 			}
-			return current;
+			else {
+				return current;
+			}
 		}
+		return nullptr;
+	}
 
-		bool isLeaf() const {
-			return (!left) && (!right);
+	//Links a new node built from args under parent (nullptr for the root) and rebalances
+	template<typename... Args>
+	Node* linkNode(Node* parent, bool left, Args&&... args) {
+		Node* node = createNode(std::forward<Args>(args)...);
+		node->parent = parent;
+		if (!parent) {
+			root = node;
+			leftmost = rightmost = node;
+		}
+		else if (left) {
+			parent->left = node;
+			leftmost = parent == leftmost ? node : leftmost;
 		}
+		else {
+			parent->right = node;
+			rightmost = parent == rightmost ? node : rightmost;
+		}
+		++count;
+		balancing(node);
+		return node;
+	}
 
-		Node* next() const {
-			if (right) {
-				return right->minNode();
+	//Descends from the root, equal elements go after the existing ones
+	Node* insertDescending(const T& value) {
+		Node* parent = nullptr;
+		bool left = false;
+		for (Node* current = root; current; current = left ? current->left : current->right) {
+			parent = current;
+			left = comp(keyOf(value), keyOf(current->data));
+		}
+		return linkNode(parent, left, value);
+	}
+
+	//Inserts a node built from args unless an element with this key exists,
+	//returns that element and false then. args are only used if the node is created.
+	template<typename K, typename... Args>
+	std::pair<Node*, bool> emplaceUnique(const K& key, Args&&... args) {
+		Node* parent = nullptr;
+		bool left = false;
+		Node* current = root;
+		while (current) {
+			parent = current;
+			if (comp(key, keyOf(current->data))) {
+				left = true;
+				current = current->left;
 			}
-			Node* current = this;
-			Node* p = parent;
-			while (p) {
-				if (current == p->left) {
-					break;
-				}
-				current = p;
-				p = current->parent;
+			else if (comp(keyOf(current->data), key)) {
+				left = false;
+				current = current->right;
+			}
+			else {
+				return { current, false };
 			}
-			return p;
 		}
+		return { linkNode(parent, left, std::forward<Args>(args)...), true };
+	}
 
-	};
+	template<typename... Args>
+	Node* createNode(Args&&... args) {
+		return NodeOps::create(this->_allocator(), std::forward<Args>(args)...);
+	}
 
-	Node* root = nullptr;
-	size_t count = 0;
-	Compare comp;
+	void destroyNode(Node* node) {
+		NodeOps::destroy(this->_allocator(), node);
+	}
 
 	//Rotation functions
 	Node* rightRotate(Node* b) {
@@ -129,8 +430,8 @@ private:
 		}
 		a->right = b;
 		a->parent = b_parent;
-		b->updateHeight();
-		a->updateHeight();
+		b->update();
+		a->update();
 		return a;
 	}
 	Node* leftRotate(Node* b) {
@@ -157,8 +458,8 @@ private:
 		a->left = b;
 		b->parent = a;
 		a->parent = b_parent;
-		b->updateHeight();
-		a->updateHeight();
+		b->update();
+		a->update();
 		return a;
 	}
 	Node* doubleRightRotate(Node* b) {
@@ -197,9 +498,9 @@ private:
 		b->parent = c;
 		c->parent = b_parent;
 
-		a->updateHeight();
-		b->updateHeight();
-		c->updateHeight();
+		a->update();
+		b->update();
+		c->update();
 		return c;
 	}
 	Node* doubleLeftRotate(Node* b) {
@@ -237,27 +538,62 @@ private:
 		a->parent = c;
 		b->parent = c;
 
-		a->updateHeight();
-		b->updateHeight();
-		c->updateHeight();
+		a->update();
+		b->update();
+		c->update();
 		return c;
 	}
 
-	//Function for copy constructor and copy =
+	//Function for copy constructor and copy =. One iterative pre-order pass: the walk
+	//follows the parent pointers of the source and of the copy side by side, every new
+	//node is linked to its copied parent as soon as it exists.
 	Node* copyThree(Node* node) {
 		if (!node) {
 			return nullptr;
 		}
-		Node* newNode = new Node(*node);
-		newNode->left = copyThree(node->left);
-		newNode->right = copyThree(node->right);
-		return newNode;
+		Node* copy = createNode(*node);
+		copy->left = copy->right = copy->parent = nullptr;
+
+		Node* source = node;
+		Node* target = copy;
+		try {
+			while (true) {
+				if (source->left && !target->left) {
+					target->left = createNode(*source->left);
+					target->left->left = target->left->right = nullptr;
+					target->left->parent = target;
+					source = source->left;
+					target = target->left;
+					continue;
+				}
+				if (source->right && !target->right) {
+					target->right = createNode(*source->right);
+					target->right->left = target->right->right = nullptr;
+					target->right->parent = target;
+					source = source->right;
+					target = target->right;
+					continue;
+				}
+				//Both subtrees are done, climb back towards the first node that still has one
+				if (source == node) {
+					break;
+				}
+				source = source->parent;
+				target = target->parent;
+			}
+		}
+		catch (...) {
+			//The copy holds only linked, fully built nodes
+			clear(copy);
+			throw;
+		}
+		return copy;
 	}
 	
-	//Function for balancing a tree
+	//Function for balancing a tree, also refreshes the subtree sizes on the way to the root
 	void balancing(Node* current) {
 		while (current) {
-			current->updateHeight();
+			current->update();
 			if (current->balance() == -2) {
 				if (current->left && current->left->balance() == 1) {
 					current = doubleRightRotate(current);
@@ -278,104 +614,605 @@ private:
 		}
 	}
 
-	//The remove_uc (uncountable) function does not take count into account because additional recursion is called
-	void remove_uc(Node* node) {
-		if (!node) {
-			return;
+	//Puts replacement (may be nullptr) where node hangs in the tree
+	void transplant(Node* node, Node* replacement) {
+		if (!node->parent) {
+			root = replacement;
+		}
+		else if (node == node->parent->left) {
+			node->parent->left = replacement;
+		}
+		else {
+			node->parent->right = replacement;
 		}
+		if (replacement) {
+			replacement->parent = node->parent;
+		}
+	}
 
-		Node* node_parent = node->parent;
-		if (!node->left && !node->right) {
-			if (node->parent) {
-				if (node->parent->right == node) {
-					node->parent->right = nullptr;
-				}
-				else {
-					node->parent->left = nullptr;
-				}
+	//Unlinks and destroys node, returns its in-order successor. A node with two children
+	//is replaced by relinking its successor into its place: no element is copied or moved,
+	//and only iterators to the removed node are invalidated. No recursion.
+	Node* removeNode(Node* node) {
+		Node* successor = node->next();
+		Node* rebalance_from;
+		if (node == leftmost) {
+			leftmost = successor;
+		}
+		if (node == rightmost) {
+			rightmost = node->prev();
+		}
+
+		if (node->left && node->right) {
+			//successor is the leftmost node of the right subtree, it has no left child
+			if (successor->parent == node) {
+				rebalance_from = successor;
 			}
 			else {
-				root = nullptr;
+				rebalance_from = successor->parent;
+				transplant(successor, successor->right);
+				successor->right = node->right;
+				successor->right->parent = successor;
 			}
-			delete node;
-		}
-		else if (node->left && node->right) {
-			Node* min = findMin(node->right);
-			node->data = min->data;
-			remove_uc(min);
+			transplant(node, successor);
+			successor->left = node->left;
+			successor->left->parent = successor;
 		}
 		else {
-			if (node->parent) {
-				if (node->parent->right == node) {
-					if (node->right) {
-						node->right->parent = node->parent;
-						node->parent->right = node->right;
-					}
-					else {
-						node->left->parent = node->parent;
-						node->parent->right = node->left;
-					}
-				}
-				else {
-					if (node->right) {
-						node->right->parent = node->parent;
-						node->parent->left = node->right;
-					}
-					else {
-						node->left->parent = node->parent;
-						node->parent->left = node->left;
-					}
-				}
+			rebalance_from = node->parent;
+			transplant(node, node->left ? node->left : node->right);
+		}
+
+		destroyNode(node);
+		--count;
+		balancing(rebalance_from);
+		return successor;
+	}
+
+
+	//Summary of the elements not less than low in the subtree
+	auto summaryFrom(Node* current, const Key& low) const {
+		auto result = Augment::identity();
+		while (current) {
+			if (comp(keyOf(current->data), low)) {
+				current = current->right;
 			}
-			else
-			{
-				if (node->right) {
-					root = node->right;
-					node->right->parent = nullptr;
+			else {
+				auto inside = Augment::of(current->data);
+				if (current->right) {
+					inside = Augment::combine(inside, current->right->summary);
 				}
-				else {
-					root = node->left;
-					node->left->parent = nullptr;
+				result = Augment::combine(inside, result);
+				current = current->left;
+			}
+		}
+		return result;
+	}
+
+	//Summary of the elements not greater than high in the subtree
+	auto summaryUpTo(Node* current, const Key& high) const {
+		auto result = Augment::identity();
+		while (current) {
+			if (comp(high, keyOf(current->data))) {
+				current = current->left;
+			}
+			else {
+				auto inside = Augment::of(current->data);
+				if (current->left) {
+					inside = Augment::combine(current->left->summary, inside);
 				}
+				result = Augment::combine(result, inside);
+				current = current->right;
+			}
+		}
+		return result;
+	}
+
+	//k-th node in order (0-based), nullptr if k >= count
+	Node* nodeAt(size_t k) const {
+		Node* current = root;
+		while (current) {
+			size_t left_size = Node::sizeOf(current->left);
+			if (k < left_size) {
+				current = current->left;
+			}
+			else if (k == left_size) {
+				return current;
+			}
+			else {
+				k -= left_size + 1;
+				current = current->right;
+			}
+		}
+		return nullptr;
+	}
+
+	//First node not less than key (upper == false) or greater than key (upper == true)
+	template<typename K>
+	Node* boundNode(const K& key, bool upper) const {
+		Node* result = nullptr;
+		Node* current = root;
+		while (current) {
+			bool after = upper ? comp(key, keyOf(current->data)) : !comp(keyOf(current->data), key);
+			if (after) {
+				result = current;
+				current = current->left;
+			}
+			else {
+				current = current->right;
+			}
+		}
+		return result;
+	}
+
+	//Number of elements less than key, or not greater than key if inclusive
+	template<typename K>
+	size_t countBelow(const K& key, bool inclusive) const {
+		size_t result = 0;
+		Node* current = root;
+		while (current) {
+			bool below = inclusive ? !comp(key, keyOf(current->data)) : comp(keyOf(current->data), key);
+			if (below) {
+				result += Node::sizeOf(current->left) + 1;
+				current = current->right;
+			}
+			else {
+				current = current->left;
 			}
-			delete node;
+		}
+		return result;
+	}
+
+	//Builds a perfectly balanced subtree from the next count elements of a sorted sequence,
+	//O(count). The left half is built first so the elements are consumed in order.
+	template<typename ForwardIt>
+	Node* buildSorted(ForwardIt& it, size_t count) {
+		if (count == 0) {
+			return nullptr;
+		}
+
+		Node* left = buildSorted(it, count / 2);
+		Node* node;
+		try {
+			node = createNode(*it);
+		}
+		catch (...) {
+			clear(left);
+			throw;
+		}
+		++it;
+		node->left = left;
+		if (left) {
+			left->parent = node;
 		}
 
-		if (!node_parent) {
-			balancing(root);
+		try {
+			node->right = buildSorted(it, count - count / 2 - 1);
+		}
+		catch (...) {
+			clear(node);
+			throw;
+		}
+		if (node->right) {
+			node->right->parent = node;
+		}
+		node->update();
+		return node;
+	}
+
+	//Not every iterator of this library has std::iterator_traits, so no std::distance
+	template<typename ForwardIt>
+	static size_t distance(ForwardIt first, ForwardIt last) {
+		size_t result = 0;
+		for (; first != last; ++first) {
+			++result;
+		}
+		return result;
+	}
+
+	template<typename ForwardIt>
+	bool isSorted(ForwardIt first, ForwardIt last) const {
+		if (first == last) {
+			return true;
+		}
+		for (ForwardIt prev = first++; first != last; prev = first++) {
+			if (comp(keyOf(*first), keyOf(*prev))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//---------------------------- S P L I T  /  J O I N ----------------------------------
+	//These work on detached subtrees: the returned root has no parent, the root of a
+	//subtree passed in may still point to its old parent. They never allocate or free,
+	//so independent subtrees can be processed on different threads.
+
+	static int heightOf(const Node* node) {
+		return node ? node->height : 0;
+	}
+
+	//Makes left and right the children of node, returns node as a detached root
+	static Node* attach(Node* left, Node* node, Node* right) {
+		node->left = left;
+		node->right = right;
+		if (left) {
+			left->parent = node;
+		}
+		if (right) {
+			right->parent = node;
+		}
+		node->parent = nullptr;
+		node->update();
+		return node;
+	}
+
+	static Node* detachedLeftRotate(Node* node) {
+		Node* right = node->right;
+		return attach(attach(node->left, node, right->left), right, right->right);
+	}
+
+	static Node* detachedRightRotate(Node* node) {
+		Node* left = node->left;
+		return attach(left->left, left, attach(left->right, node, node->right));
+	}
+
+	//join for heightOf(left) > heightOf(right) + 1: node goes down the right spine of left
+	static Node* joinRight(Node* left, Node* node, Node* right) {
+		Node* outer = left->left;
+		Node* inner = left->right;
+		if (heightOf(inner) <= heightOf(right) + 1) {
+			Node* joined = attach(inner, node, right);
+			if (heightOf(joined) <= heightOf(outer) + 1) {
+				return attach(outer, left, joined);
+			}
+			return detachedLeftRotate(attach(outer, left, detachedRightRotate(joined)));
+		}
+
+		Node* joined = joinRight(inner, node, right);
+		Node* result = attach(outer, left, joined);
+		if (heightOf(joined) <= heightOf(outer) + 1) {
+			return result;
+		}
+		return detachedLeftRotate(result);
+	}
+
+	//Mirror of joinRight() for heightOf(right) > heightOf(left) + 1
+	static Node* joinLeft(Node* left, Node* node, Node* right) {
+		Node* outer = right->right;
+		Node* inner = right->left;
+		if (heightOf(inner) <= heightOf(left) + 1) {
+			Node* joined = attach(left, node, inner);
+			if (heightOf(joined) <= heightOf(outer) + 1) {
+				return attach(joined, right, outer);
+			}
+			return detachedRightRotate(attach(detachedLeftRotate(joined), right, outer));
+		}
+
+		Node* joined = joinLeft(left, node, inner);
+		Node* result = attach(joined, right, outer);
+		if (heightOf(joined) <= heightOf(outer) + 1) {
+			return result;
+		}
+		return detachedRightRotate(result);
+	}
+
+	//Concatenates left, node and right (every element of left <= node <= every element of right),
+	//O(|height(left) - height(right)| + 1)
+	static Node* joinNodes(Node* left, Node* node, Node* right) {
+		if (heightOf(left) > heightOf(right) + 1) {
+			return joinRight(left, node, right);
+		}
+		if (heightOf(right) > heightOf(left) + 1) {
+			return joinLeft(left, node, right);
+		}
+		return attach(left, node, right);
+	}
+
+	//Cuts the largest node out of a non-empty subtree, returns the rest
+	static Node* splitLast(Node* node, Node*& last) {
+		if (!node->right) {
+			last = node;
+			Node* rest = node->left;
+			if (rest) {
+				rest->parent = nullptr;
+			}
+			return rest;
+		}
+		Node* rest = splitLast(node->right, last);
+		return joinNodes(node->left, node, rest);
+	}
+
+	//Concatenates two subtrees (every element of left <= every element of right)
+	static Node* joinTrees(Node* left, Node* right) {
+		if (!left || !right) {
+			Node* result = left ? left : right;
+			if (result) {
+				result->parent = nullptr;
+			}
+			return result;
+		}
+		Node* last;
+		Node* rest = splitLast(left, last);
+		return joinNodes(rest, last, right);
+	}
+
+	//Splits a subtree into the nodes for which goesLeft(data) is true and the others.
+	//goesLeft must be true for a prefix of the in-order sequence. O(log n).
+	template<typename Predicate>
+	static void splitNodes(Node* node, const Predicate& goesLeft, Node*& left, Node*& right) {
+		if (!node) {
+			left = nullptr;
+			right = nullptr;
+			return;
+		}
+		Node* node_left = node->left;
+		Node* node_right = node->right;
+		if (goesLeft(node->data)) {
+			Node* rest;
+			splitNodes(node_right, goesLeft, rest, right);
+			left = joinNodes(node_left, node, rest);
 		}
 		else {
-			balancing(node_parent);
+			Node* rest;
+			splitNodes(node_left, goesLeft, left, rest);
+			right = joinNodes(rest, node, node_right);
+		}
+	}
+
+	//Splits a subtree into the nodes less than, equal to and greater than key
+	void splitThreeWay(Node* node, const Key& key, Node*& less, Node*& equal, Node*& greater) const {
+		Node* rest;
+		splitNodes(node, [&](const T& data) { return comp(keyOf(data), key); }, less, rest);
+		splitNodes(rest, [&](const T& data) { return !comp(key, keyOf(data)); }, equal, greater);
+	}
+
+	//Subtrees dropped by the set operations, chained through the parent pointer of their
+	//roots. Freed by the calling thread once the parallel part is over.
+	struct Garbage {
+		Node* head = nullptr;
+		Node* tail = nullptr;
+
+		void add(Node* subtree) {
+			if (!subtree) {
+				return;
+			}
+			subtree->parent = nullptr;
+			if (tail) {
+				tail->parent = subtree;
+			}
+			else {
+				head = subtree;
+			}
+			tail = subtree;
+		}
+
+		void append(Garbage& other) {
+			if (!other.head) {
+				return;
+			}
+			if (tail) {
+				tail->parent = other.head;
+			}
+			else {
+				head = other.head;
+			}
+			tail = other.tail;
+		}
+	};
+
+	void freeGarbage(Garbage& garbage) {
+		Node* subtree = garbage.head;
+		while (subtree) {
+			Node* next = subtree->parent;
+			clear(subtree);
+			subtree = next;
+		}
+		garbage.head = nullptr;
+		garbage.tail = nullptr;
+	}
+
+	//Runs left() on the thread pool and right() here if the driving subtree is big enough
+	template<typename Left, typename Right>
+	static void forkJoin(size_t work, Left&& left, Right&& right) {
+		if (work < parallel_set_cutoff || default_thread_pool().size() == 0) {
+			left();
+			right();
+			return;
+		}
+		TaskGroup group;
+		group.run([&] { left(); });
+		try {
+			right();
+		}
+		catch (...) {
+			group.wait();
+			throw;
+		}
+		group.wait();
+	}
+
+	//Walks the nodes of a tree in order, stopping only at the first node of each key
+	class DistinctNodes {
+	public:
+		DistinctNodes(const Node* first, const Compare& compare) : current(first), comp(&compare) {}
+
+		const T& operator*() const {
+			return current->data;
+		}
+
+		DistinctNodes& operator++() {
+			const Key& key = keyOf(current->data);
+			do {
+				current = current->next();
+			} while (current && !(*comp)(key, keyOf(current->data)));
+			return *this;
+		}
+
+		bool done() const {
+			return !current;
+		}
+
+	private:
+		const Node* current;
+		const Compare* comp;
+	};
+
+	//Union of a subtree of this tree with a subtree copied from the other tree, both are consumed.
+	//theirs holds distinct keys: every key of this tree stays (with its duplicates), a key of
+	//theirs is kept only if this tree does not have it.
+	Node* unionNodes(Node* mine, Node* theirs, Garbage& garbage) const {
+		if (!theirs) {
+			return mine;
+		}
+		if (!mine) {
+			theirs->parent = nullptr;
+			return theirs;
+		}
+
+		Node* theirs_left = theirs->left;
+		Node* theirs_right = theirs->right;
+		Node *less, *equal, *greater;
+		splitThreeWay(mine, keyOf(theirs->data), less, equal, greater);
+
+		Node* left;
+		Node* right;
+		Garbage right_garbage;
+		forkJoin(theirs->size,
+			[&] { left = unionNodes(less, theirs_left, garbage); },
+			[&] { right = unionNodes(greater, theirs_right, right_garbage); });
+		garbage.append(right_garbage);
+
+		if (!equal) {
+			return joinNodes(left, theirs, right);
+		}
+		theirs->left = nullptr;
+		theirs->right = nullptr;
+		garbage.add(theirs);
+		return joinTrees(joinTrees(left, equal), right);
+	}
+
+	//Keeps the nodes of mine whose key occurs in theirs (a subtree of another tree, read only)
+	Node* intersectNodes(Node* mine, const Node* theirs, Garbage& garbage) const {
+		if (!mine) {
+			return nullptr;
+		}
+		if (!theirs) {
+			garbage.add(mine);
+			return nullptr;
+		}
+
+		Node *less, *equal, *greater;
+		splitThreeWay(mine, keyOf(theirs->data), less, equal, greater);
+
+		Node* left;
+		Node* right;
+		Garbage right_garbage;
+		forkJoin(theirs->size,
+			[&] { left = intersectNodes(less, theirs->left, garbage); },
+			[&] { right = intersectNodes(greater, theirs->right, right_garbage); });
+		garbage.append(right_garbage);
+		return joinTrees(joinTrees(left, equal), right);
+	}
+
+	//Drops the nodes of mine whose key occurs in theirs (a subtree of another tree, read only)
+	Node* differenceNodes(Node* mine, const Node* theirs, Garbage& garbage) const {
+		if (!mine || !theirs) {
+			return mine;
+		}
+
+		Node *less, *equal, *greater;
+		splitThreeWay(mine, keyOf(theirs->data), less, equal, greater);
+		garbage.add(equal);
+
+		Node* left;
+		Node* right;
+		Garbage right_garbage;
+		forkJoin(theirs->size,
+			[&] { left = differenceNodes(less, theirs->left, garbage); },
+			[&] { right = differenceNodes(greater, theirs->right, right_garbage); });
+		garbage.append(right_garbage);
+		return joinTrees(left, right);
+	}
+
+	//Installs the result of a split/join operation as the whole tree
+	void setRoot(Node* node) {
+		root = node;
+		if (root) {
+			root->parent = nullptr;
 		}
+		count = Node::sizeOf(root);
+		refreshEnds();
+	}
+
+	//Finds the smallest and largest node again after root was replaced, O(log n)
+	void refreshEnds() {
+		leftmost = root ? root->minNode() : nullptr;
+		rightmost = root ? root->maxNode() : nullptr;
+	}
+
+	//Visits every node of the subtree once in O(n) without a stack: a node with a left
+	//child is rotated right until the top has none, then the top is handed to visit() and
+	//the walk goes on with its right subtree. The subtree is taken apart on the way, so
+	//visit() must destroy the node; parent pointers are neither read nor written.
+	template<typename Visit>
+	static void dismantle(Node* node, Visit visit) {
+		while (node) {
+			if (Node* left = node->left) {
+				node->left = left->right;
+				left->right = node;
+				node = left;
+				continue;
+			}
+			Node* right = node->right;
+			visit(node);
+			node = right;
+		}
+	}
+
+	//Runs the node destructors without returning the memory (see clear())
+	void destroyValues(Node* node) {
+		dismantle(node, [](Node* current) { current->~Node(); });
 	}
 
 	//Function for destructor
 	void clear(Node* node) {
-		if (!node) { return; }
-		clear(node->left);
-		clear(node->right);
-		node->left = nullptr;
-		node->right = nullptr;
-		delete node;
+		dismantle(node, [this](Node* current) { destroyNode(current); });
 	}
 
 public:
+	using allocator_type = Alloc;
+
 	//Constructor and destructor
-	AVLtree() : root(nullptr), count(0) {}
-	AVLtree(size_t _count, const T& value) {
+	//Built in place, a default-constructed pool allocator does not allocate anything
+	AVLtree() : AllocatorHolder<NodeAlloc>(NodeAlloc()), root(nullptr), count(0) {}
+	explicit AVLtree(const Alloc& alloc) : AllocatorHolder<NodeAlloc>(NodeAlloc(alloc)), root(nullptr), count(0) {}
+	AVLtree(size_t _count, const T& value, const Alloc& alloc = Alloc()) : AVLtree(alloc) {
 		while (count < _count) {
-			insert(value);
+			append_max(value);
 		}
 	}
 	AVLtree(size_t count) : AVLtree(count, T()) {}
-	AVLtree(const AVLtree& other) {
+	//Sorted input is built in O(n), anything else is sorted first (see assign())
+	template<typename ForwardIt, typename = std::enable_if_t<!std::is_integral_v<ForwardIt>>>
+	AVLtree(ForwardIt first, ForwardIt last, const Alloc& alloc = Alloc()) : AVLtree(alloc) {
+		assign(first, last);
+	}
+	AVLtree(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : AVLtree(alloc) {
+		assign(init.begin(), init.end());
+	}
+	AVLtree(const AVLtree& other) : AVLtree(other, Alloc(NodeOps::copy_for_container(other._allocator()))) {}
+	AVLtree(const AVLtree& other, const Alloc& alloc) : AllocatorHolder<NodeAlloc>(NodeAlloc(alloc)), comp(other.comp) {
 		root = copyThree(other.root);
 		count = other.count;
+		refreshEnds();
 	}
-	AVLtree(AVLtree&& other) {
+	AVLtree(AVLtree&& other) : AllocatorHolder<NodeAlloc>(std::move(other._allocator())), comp(other.comp) {
 		root = other.root;
+		leftmost = other.leftmost;
+		rightmost = other.rightmost;
 		count = other.count;
-		other.root = nullptr;
+		other.root = other.leftmost = other.rightmost = nullptr;
 		other.count = 0;
 	}
 	~AVLtree() {
@@ -383,45 +1220,49 @@ public:
 	}
 
 	//--------------------------------- I T E R A T O R -----------------------------------
-	class Iterator {
+	//Iterator gives T&, ConstIterator const T&. An Iterator converts to a ConstIterator.
+	template<bool Const>
+	class BasicIterator {
 	private:
 		Node* current;
-		AVLtree* parent_three;
+		const AVLtree* parent_three;
+
+		template<bool>
+		friend class BasicIterator;
+		friend class AVLtree;
 
 	public:
-		Iterator() = delete;
-		Iterator(Node* _current, AVLtree* _parent_three) : current(_current), parent_three(_parent_three) {}
-		Iterator(const Iterator& other) : current(other.current), parent_three(other.parent_three) {}
+		using reference = std::conditional_t<Const, const T&, T&>;
+		using pointer = std::conditional_t<Const, const T*, T*>;
+
+		BasicIterator() = delete;
+		BasicIterator(Node* _current, const AVLtree* _parent_three) : current(_current), parent_three(_parent_three) {}
+		BasicIterator(const BasicIterator& other) : current(other.current), parent_three(other.parent_three) {}
+
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		BasicIterator(const BasicIterator<OtherConst>& other) : current(other.current), parent_three(other.parent_three) {}
+
+		BasicIterator& operator=(const BasicIterator& other) = default;
 
-		void is_valid() {
+		void is_valid() const {
 			if (!current) {
 				throw std::runtime_error("Iterator equal nullptr");
 			}
 		}
 
-		T& operator*() {
+		reference operator*() const {
 			is_valid();
 			return (current->data);
 		}
 
-		T* operator->() {
-			is_valid();
-			return &(current->data);
-		}
-
-		const T& operator*() const {
-			is_valid();
-			return (current->data);
-		}
-
-		const T* operator->() const {
+		pointer operator->() const {
 			is_valid();
 			return &(current->data);
 		}
 
 
 		// Increment/Decrement ------------------------------------------------
-		Iterator& operator++() {
+		BasicIterator& operator++() {
 			is_valid();
 			if (current->right) {
 				current = current->right;
@@ -439,13 +1280,13 @@ public:
 			return *this;
 		}
 
-		Iterator operator++(int) {
-			Iterator tmp(*this);
+		BasicIterator operator++(int) {
+			BasicIterator tmp(*this);
 			++(*this);
 			return tmp;
 		}
 
-		Iterator& operator--() {
+		BasicIterator& operator--() {
 			is_valid();
 			if (current->left) {
 				current = current->left;
@@ -463,122 +1304,368 @@ public:
 			return *this;
 		}
 
-		Iterator operator--(int) {
-			Iterator tmp(*this);
+		BasicIterator operator--(int) {
+			BasicIterator tmp(*this);
 			--(*this);
 			return tmp;
 		}
 
 
 		// Arithmetic operations --------------------------------------------
-		Iterator& operator+=(size_t n) {
-			for (size_t i = 0; i < n; ++i) {
-				++(*this);
-			}
+		//O(log n) through the subtree sizes, moving past either end gives end()
+		BasicIterator& operator+=(size_t n) {
+			size_t index = current ? current->index() : parent_three->count;
+			current = parent_three->nodeAt(index + n);
+			return *this;
 		}
 
-		Iterator& operator-=(size_t n) {
-			for (size_t i = 0; i < n; ++i) {
-				--(*this);
-			}
+		BasicIterator& operator-=(size_t n) {
+			size_t index = current ? current->index() : parent_three->count;
+			current = (n > index) ? nullptr : parent_three->nodeAt(index - n);
+			return *this;
 		}
 
-		Iterator operator+(size_t n) const {
-			Iterator tmp(*this);
+		BasicIterator operator+(size_t n) const {
+			BasicIterator tmp(*this);
 			tmp += n;
 			return tmp;
 		}
 
-		Iterator operator-(size_t n) const {
-			Iterator tmp(*this);
+		BasicIterator operator-(size_t n) const {
+			BasicIterator tmp(*this);
 			tmp -= n;
 			return tmp;
 		}
 
 
 		// Comparison ---------------------------------------------------------
-		bool operator==(const Iterator& other) const {
+		template<bool OtherConst>
+		bool operator==(const BasicIterator<OtherConst>& other) const {
 			return current == other.current;
 		}
 
-		bool operator!=(const Iterator& other) const {
+		template<bool OtherConst>
+		bool operator!=(const BasicIterator<OtherConst>& other) const {
 			return !(current == other.current);
 		}
 
 	};
+
+	using Iterator = BasicIterator<false>;
+	using ConstIterator = BasicIterator<true>;
 	//-------------------------------------------------------------------------------------
 
+	//Removes the element of node (as returned by find()), nullptr is ignored
 	void remove(Node* node) {
-		remove_uc(node);
-		--count;
+		if (node) {
+			removeNode(node);
+		}
+	}
+
+	//Removes the element at position, returns the iterator to the next one
+	Iterator erase(ConstIterator position) {
+		if (!position.current || position.parent_three != this) {
+			throw std::out_of_range("Iterator out of bounds");
+		}
+		return Iterator(removeNode(position.current), this);
+	}
+
+	Iterator erase(Iterator position) {
+		return erase(ConstIterator(position));
+	}
+
+	//Removes every element with this key, returns how many there were
+	template<typename K = Key>
+	size_t erase(const K& key) {
+		const LookupKey<K>& lookup = key;
+		size_t removed = 0;
+		Node* node = boundNode(lookup, false);
+		while (node && !comp(lookup, keyOf(node->data))) {
+			node = removeNode(node);
+			++removed;
+		}
+		return removed;
 	}
 
+	//Equal elements are all kept, a new one goes after the existing ones
 	void insert(const T& value) {
-		if (!root) {
-			root = new Node(value);
-			++count;
-			return;
+		insertDescending(value);
+	}
+
+	//Inserts value just before hint if it belongs there (prev <= value <= *hint), otherwise
+	//like insert(value). With the right hint no key is compared beyond the two neighbours:
+	//end() for ascending input, the next element for descending. The subtree sizes are
+	//still refreshed up to the root, that walk compares nothing.
+	Iterator insert(ConstIterator hint, const T& value) {
+		if (hint.parent_three != this) {
+			throw std::out_of_range("Iterator out of bounds");
+		}
+		Node* next = hint.current;
+		Node* prev = next ? next->prev() : rightmost;
+		if ((next && comp(keyOf(next->data), keyOf(value))) || (prev && comp(keyOf(value), keyOf(prev->data)))) {
+			return Iterator(insertDescending(value), this);
 		}
+		if (next && !next->left) {
+			return Iterator(linkNode(next, true, value), this);
+		}
+		return Iterator(linkNode(prev, false, value), this);
+	}
 
-		Node* current = root;
-		while (current) {
-			if (!comp(value , current->data)) {
-				if (!current->right) { 
-					current->right = new Node(value, nullptr, nullptr, current);
-					current = current->right;
-					break;
-				}
-				current = current->right;
-			}
-			else {
-				if (!current->left) { 
-					current->left = new Node(value,nullptr,nullptr,current);
-					current = current->left;
-					break; 
-				}
-				current = current->left;
-			}
+	//Appends value as the new largest element from the cached rightmost node, O(1) before
+	//the size refresh. Throws std::invalid_argument if value is less than the current maximum.
+	Iterator append_max(const T& value) {
+		if (rightmost && comp(keyOf(value), keyOf(rightmost->data))) {
+			throw std::invalid_argument("AVLtree::append_max: value is less than the maximum");
 		}
-		++count;
-		balancing(current);
+		return Iterator(linkNode(rightmost, false, value), this);
 	}
 
-	bool contains(const T& value) const {
-		Node* current = root;
-		while (current) {
-			if (!comp(value, current->data) && !comp(current->data, value)) {
-				return true;
-			}
-			if (comp(current->data, value)) {
-				if (!current->right) {
-					return false;
-				}
-				current = current->right;
-			}
-			else {
-				if (!current->left) {
-					return false;
-				}
-				current = current->left;
-			}
+	//Lookups below take a Key, or any type Compare accepts if it is transparent
+	template<typename K = Key>
+	bool contains(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return findNode(lookup) != nullptr;
+	}
+
+	template<typename K = Key>
+	Node* find(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return findNode(lookup);
+	}
+
+	//First element not less than key, end() if there is none, O(log n)
+	template<typename K = Key>
+	Iterator lower_bound(const K& key) {
+		const LookupKey<K>& lookup = key;
+		return Iterator(boundNode(lookup, false), this);
+	}
+
+	template<typename K = Key>
+	ConstIterator lower_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(boundNode(lookup, false), this);
+	}
+
+	//First element greater than key, end() if there is none, O(log n)
+	template<typename K = Key>
+	Iterator upper_bound(const K& key) {
+		const LookupKey<K>& lookup = key;
+		return Iterator(boundNode(lookup, true), this);
+	}
+
+	template<typename K = Key>
+	ConstIterator upper_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(boundNode(lookup, true), this);
+	}
+
+	//All elements equal to key, as [first, second)
+	template<typename K = Key>
+	std::pair<Iterator, Iterator> equal_range(const K& key) {
+		const LookupKey<K>& lookup = key;
+		return { Iterator(boundNode(lookup, false), this), Iterator(boundNode(lookup, true), this) };
+	}
+
+	template<typename K = Key>
+	std::pair<ConstIterator, ConstIterator> equal_range(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return { ConstIterator(boundNode(lookup, false), this), ConstIterator(boundNode(lookup, true), this) };
+	}
+
+	//Calls function(element) for every element in [low, high] in order, O(log n + k):
+	//the walk starts at lower_bound(low) and stops at the first element above high
+	template<typename Function>
+	void for_each_in_range(const Key& low, const Key& high, Function&& function) const {
+		for (Node* current = boundNode(low, false); current && !comp(high, keyOf(current->data)); current = current->next()) {
+			function(static_cast<const T&>(current->data));
+		}
+	}
+
+	//Number of elements less than key, O(log n)
+	template<typename K = Key>
+	size_t rank(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return countBelow(lookup, false);
+	}
+
+	//The k-th smallest element (0-based), O(log n)
+	const T& select(size_t k) const {
+		Node* node = nodeAt(k);
+		if (!node) {
+			throw std::out_of_range("Index out of range");
+		}
+		return node->data;
+	}
+
+	//Iterator to the k-th smallest element, end() if k >= size()
+	Iterator nth(size_t k) {
+		return Iterator(nodeAt(k), this);
+	}
+
+	//Number of elements in [low, high], O(log n)
+	size_t count_range(const Key& low, const Key& high) const {
+		if (comp(high, low)) {
+			return 0;
 		}
-		return false;
+		return countBelow(high, true) - countBelow(low, false);
+	}
+
+	//Augment summary of the whole tree, Augment::identity() if it is empty, O(1)
+	template<typename A = Augment, typename = std::enable_if_t<!std::is_same_v<A, AVLNoAugment>>>
+	typename A::summary_type summary() const {
+		return root ? root->summary : A::identity();
 	}
 
-	Node* find(const T& value) const {
+	//Augment summary of the elements in [low, high] (their sum with AVLSum), O(log n):
+	//the summaries of the subtrees that lie inside the range are combined
+	template<typename A = Augment, typename = std::enable_if_t<!std::is_same_v<A, AVLNoAugment>>>
+	typename A::summary_type range_sum(const Key& low, const Key& high) const {
 		Node* current = root;
 		while (current) {
-			if (comp(value, current->data)) {
-				current = current->left;
-			}
-			else if (comp(current->data, value)) {
+			if (comp(keyOf(current->data), low)) {
 				current = current->right;
 			}
+			else if (comp(high, keyOf(current->data))) {
+				current = current->left;
+			}
 			else {
-				return current;
+				//The paths to low and high part here
+				auto result = Augment::combine(summaryFrom(current->left, low), Augment::of(current->data));
+				return Augment::combine(result, summaryUpTo(current->right, high));
 			}
 		}
-		return nullptr;
+		return Augment::identity();
+	}
+
+	//Replaces the contents with the sorted range [first, last), O(n).
+	//The result is perfectly balanced. Throws std::invalid_argument if the range is not sorted.
+	template<typename ForwardIt>
+	void assign_sorted(ForwardIt first, ForwardIt last) {
+		if (!isSorted(first, last)) {
+			throw std::invalid_argument("AVLtree::assign_sorted: range is not sorted");
+		}
+		clear();
+		size_t total = distance(first, last);
+		root = buildSorted(first, total);
+		count = total;
+		refreshEnds();
+	}
+
+	//Replaces the contents with [first, last) in any order. Sorted input is built directly,
+	//unsorted input is copied and sorted with parallel_sort() first: O(n log n) on several threads.
+	template<typename ForwardIt>
+	void assign(ForwardIt first, ForwardIt last) {
+		if (isSorted(first, last)) {
+			assign_sorted(first, last);
+			return;
+		}
+
+		Vector<T> values;
+		values.reserve(distance(first, last));
+		for (; first != last; ++first) {
+			values.push_back(*first);
+		}
+		parallel_sort(values.data(), values.data() + values.size(),
+			[this](const T& left, const T& right) { return comp(keyOf(left), keyOf(right)); });
+		assign_sorted(values.data(), values.data() + values.size());
+	}
+
+	//Copies the elements, in order and with duplicates, into a read-only FrozenSet whose
+	//lookups are several times faster than the tree's, O(n)
+	template<typename FrozenAlloc = Allocator<T>>
+	FrozenSet<T, Compare, FrozenAlloc, KeyOf> freeze(const FrozenAlloc& alloc = FrozenAlloc()) const {
+		FrozenSet<T, Compare, FrozenAlloc, KeyOf> result(comp, alloc);
+		result.assign_sorted(begin(), end());
+		return result;
+	}
+
+	//Moves every element not less than key into the returned tree, this tree keeps the
+	//smaller ones. O(log n). The returned tree shares this tree's allocator.
+	AVLtree split(const Key& key) {
+		AVLtree result(Alloc(this->_allocator()));
+		result.comp = comp;
+		Node* less;
+		Node* rest;
+		splitNodes(root, [&](const T& data) { return comp(keyOf(data), key); }, less, rest);
+		setRoot(less);
+		result.setRoot(rest);
+		return result;
+	}
+
+	//Concatenates left, key and right into one tree, every element of left must be
+	//<= key <= every element of right (std::invalid_argument otherwise). The result uses
+	//left's allocator. O(|height(left) - height(right)| + 1) if right's nodes can be adopted,
+	//i.e. the allocators compare equal (as after split()), otherwise right is copied first.
+	static AVLtree join(AVLtree&& left, const T& key, AVLtree&& right) {
+		if ((left.root && left.comp(keyOf(key), keyOf(left.findMax(left.root)->data)))
+			|| (right.root && left.comp(keyOf(right.findMin(right.root)->data), keyOf(key)))) {
+			throw std::invalid_argument("AVLtree::join: trees are not ordered around the key");
+		}
+
+		AVLtree result(std::move(left));
+		Node* right_nodes;
+		if (NodeOps::equal(result._allocator(), right._allocator())) {
+			right_nodes = right.root;
+			right.root = nullptr;
+			right.count = 0;
+		}
+		else {
+			right_nodes = result.copyThree(right.root);
+			right.clear();
+		}
+
+		Node* node;
+		try {
+			node = result.createNode(key);
+		}
+		catch (...) {
+			result.clear(right_nodes);
+			throw;
+		}
+		result.setRoot(joinNodes(result.root, node, right_nodes));
+		return result;
+	}
+
+	//Adds one copy of every key of other that this tree does not contain yet,
+	//O(m log(n / m + 1)) plus an O(m) copy of the distinct keys of other.
+	//Big inputs are processed on default_thread_pool().
+	void union_with(const AVLtree& other) {
+		if (this == &other || !other.root) {
+			return;
+		}
+		size_t distinct = 0;
+		for (DistinctNodes it(other.leftmost, comp); !it.done(); ++it) {
+			++distinct;
+		}
+		DistinctNodes first(other.leftmost, comp);
+		Node* theirs = buildSorted(first, distinct);
+		Garbage garbage;
+		Node* result = unionNodes(root, theirs, garbage);
+		setRoot(result);
+		freeGarbage(garbage);
+	}
+
+	//Keeps only the elements whose key occurs in other, O(m log(n / m + 1))
+	void intersect_with(const AVLtree& other) {
+		if (this == &other) {
+			return;
+		}
+		Garbage garbage;
+		Node* result = intersectNodes(root, other.root, garbage);
+		setRoot(result);
+		freeGarbage(garbage);
+	}
+
+	//Removes every element whose key occurs in other, O(m log(n / m + 1))
+	void difference_with(const AVLtree& other) {
+		if (this == &other) {
+			clear();
+			return;
+		}
+		Garbage garbage;
+		Node* result = differenceNodes(root, other.root, garbage);
+		setRoot(result);
+		freeGarbage(garbage);
 	}
 
 	Node* findMin(Node* node) const {
@@ -604,8 +1691,18 @@ public:
 	}
 
 	void clear() {
-		clear(root);
-		root = nullptr;
+		if (NodeOps::can_release_all(this->_allocator(), count)) {
+			//Every live block of the pool is one of our nodes: the chunks are dropped at once,
+			//the tree is walked only if the values need their destructors
+			if constexpr (!std::is_trivially_destructible_v<Node>) {
+				destroyValues(root);
+			}
+			NodeOps::release_all(this->_allocator(), count);
+		}
+		else {
+			clear(root);
+		}
+		root = leftmost = rightmost = nullptr;
 		count = 0;
 	}
 
@@ -617,34 +1714,34 @@ public:
 		return count;
 	}
 
+	//Reads the height cached in the node, O(1)
 	size_t height(Node* node) const {
-		if (!node) {
-			return 0;
-		}
-
-		return std::max(height(node->left), height(node->right)) + 1;
+		return node ? node->height : 0;
 	}
 
+	//O(1), the smallest node is cached
 	Iterator begin() {
-		if (!root) {
-			return end();
-		}
-		return Iterator(root->minNode(), this);
+		return Iterator(leftmost, this);
 	}
 
 	Iterator end() {
 		return Iterator(nullptr, this);
 	}
 
-	const Iterator begin() const {
-		if (!root) {
-			return end();
-		}
-		return Iterator(root->minNode(), this);
+	ConstIterator begin() const {
+		return ConstIterator(leftmost, this);
 	}
 
-	const Iterator end() const {
-		return Iterator(nullptr, this);
+	ConstIterator end() const {
+		return ConstIterator(nullptr, this);
+	}
+
+	ConstIterator cbegin() const {
+		return begin();
+	}
+
+	ConstIterator cend() const {
+		return end();
 	}
 
 	//getter
@@ -652,22 +1749,49 @@ public:
 		return root;
 	}
 
+	Alloc get_allocator() const {
+		return Alloc(this->_allocator());
+	}
+
 	//--------------------------------- O P E A T O R S -------------------------------------
 
 	AVLtree& operator=(const AVLtree& other) {
-		clear();
-		root = copyThree(other.root);
-		count = other.count;
+		if (this != &other) {
+			//Every node goes back to the allocator it came from before the allocator may change
+			clear();
+			NodeOps::on_copy_assignment(this->_allocator(), other._allocator());
+			comp = other.comp;
+			root = copyThree(other.root);
+			count = other.count;
+			refreshEnds();
+		}
+		return *this;
 	}
 
 	AVLtree& operator=(AVLtree&& other) {
-		clear();
-		root = other.root;
-		count = other.count;
-		other.root = nullptr;
-		other.count = 0;
+		if (this != &other) {
+			clear();
+			comp = other.comp;
+			if (!NodeOps::propagate_on_move && !NodeOps::equal(this->_allocator(), other._allocator())) {
+				//The nodes of other cannot be adopted, they are copied into this tree's memory
+				root = copyThree(other.root);
+				count = other.count;
+				refreshEnds();
+				other.clear();
+				return *this;
+			}
+
+			NodeOps::on_move_assignment(this->_allocator(), other._allocator());
+			root = other.root;
+			leftmost = other.leftmost;
+			rightmost = other.rightmost;
+			count = other.count;
+			other.root = other.leftmost = other.rightmost = nullptr;
+			other.count = 0;
+		}
+		return *this;
 	}
 
 };
 
-
+#include "FrozenSet.hpp"
@@ -0,0 +1,252 @@
+/*
+*  Allocator Documentation
+*
+*  Every container takes an Alloc template parameter with std::allocator semantics
+*  (value_type, allocate(n), deallocate(p, n), rebind through std::allocator_traits).
+*  This file holds the default allocator and the glue the containers use to talk to it.
+*
+*  Allocator<T>:
+*    - The default for all containers, it reproduces the behaviour from before allocators
+*      existed: buffers come from Relocator<T> (malloc for trivially relocatable T,
+*      ::operator new otherwise) and grow with realloc where possible.
+*    - Stateless, always equal, propagates on move assignment.
+*
+*  AllocatorOps<Alloc>:
+*    - std::allocator_traits plus the optional reallocate() extension: an allocator that
+*      provides
+*          T* reallocate(T* ptr, size_t size, size_t old_capacity, size_t new_capacity)
+*      is asked to grow buffers itself, all others get allocate + relocate + deallocate.
+*    - Node helpers create()/destroy() for List and AVLtree.
+*    - The optional bulk-release extension (size_t live_blocks() const, void release(),
+*      bool pooled() const), provided by PoolAllocator (NodePool.hpp): release_all() lets
+*      a container that owns every live block drop its memory in one call instead of node
+*      by node. pooled() says whether every node of the container is such a block; nodes
+*      allocated elsewhere are not counted by live_blocks() and would not be released.
+*    - The propagate_on_container_* rules in one place: on_copy_assignment(),
+*      on_move_assignment(), on_swap().
+*
+*  AllocatorHolder<Alloc>:
+*    - Private base of the containers that stores the allocator. Stateless allocators
+*      are an empty base and do not make the container any bigger.
+*
+*  Notes:
+*    - Only allocators with raw pointers are supported (no fancy pointers).
+*    - Elements are still built with placement new, allocator construct() is not used.
+*    - See MemoryResource.hpp for the runtime-switchable PolymorphicAllocator.
+*/
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Relocate.hpp"
+
+
+template<typename T>
+class Allocator {
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using is_always_equal = std::true_type;
+
+	Allocator() noexcept = default;
+
+	template<typename U>
+	Allocator(const Allocator<U>&) noexcept {}
+
+	T* allocate(size_t count) {
+		return Relocator<T>::allocate(count);
+	}
+
+	void deallocate(T* ptr, size_t) noexcept {
+		Relocator<T>::deallocate(ptr);
+	}
+
+	//Extension used by AllocatorOps::reallocate(): realloc growth for relocatable T
+	T* reallocate(T* ptr, size_t size, size_t, size_t new_capacity) {
+		return Relocator<T>::reallocate(ptr, size, new_capacity);
+	}
+
+	template<typename U>
+	bool operator==(const Allocator<U>&) const noexcept {
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const Allocator<U>&) const noexcept {
+		return false;
+	}
+};
+
+
+template<typename Alloc, typename = void>
+struct has_reallocate : std::false_type {};
+
+template<typename Alloc>
+struct has_reallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+	std::declval<typename Alloc::value_type*>(), size_t(), size_t(), size_t()))>> : std::true_type {};
+
+
+template<typename Alloc, typename = void>
+struct has_bulk_release : std::false_type {};
+
+template<typename Alloc>
+struct has_bulk_release<Alloc, std::void_t<decltype(std::declval<const Alloc&>().live_blocks()),
+	decltype(std::declval<Alloc&>().release()), decltype(std::declval<const Alloc&>().pooled())>> : std::true_type {};
+
+template<typename Alloc, typename U>
+using rebind_alloc_t = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
+
+template<typename Alloc>
+struct AllocatorOps {
+	using traits = std::allocator_traits<Alloc>;
+	using T = typename traits::value_type;
+
+	static_assert(std::is_same_v<typename traits::pointer, T*>,
+		"Containers store raw pointers, allocators with fancy pointers are not supported");
+
+	static constexpr bool propagate_on_copy = traits::propagate_on_container_copy_assignment::value;
+	static constexpr bool propagate_on_move = traits::propagate_on_container_move_assignment::value;
+	static constexpr bool propagate_on_swap = traits::propagate_on_container_swap::value;
+	static constexpr bool always_equal = traits::is_always_equal::value;
+
+	//Empty buffers are nullptr, the allocator is never asked for zero bytes
+	static T* allocate(Alloc& alloc, size_t count) {
+		return count == 0 ? nullptr : traits::allocate(alloc, count);
+	}
+
+	static void deallocate(Alloc& alloc, T* ptr, size_t count) {
+		if (ptr) {
+			traits::deallocate(alloc, ptr, count);
+		}
+	}
+
+	//Returns a buffer of new_capacity slots holding the first size elements of ptr,
+	//ptr (old_capacity slots) is released or reused
+	static T* reallocate(Alloc& alloc, T* ptr, size_t size, size_t old_capacity, size_t new_capacity) {
+		if constexpr (has_reallocate<Alloc>::value) {
+			return alloc.reallocate(ptr, size, old_capacity, new_capacity);
+		}
+		else {
+			T* new_ptr = allocate(alloc, new_capacity);
+			Relocator<T>::relocate(ptr, size, new_ptr);
+			deallocate(alloc, ptr, old_capacity);
+			return new_ptr;
+		}
+	}
+
+	//Allocates one slot and constructs the object in it
+	template<typename... Args>
+	static T* create(Alloc& alloc, Args&&... args) {
+		T* ptr = traits::allocate(alloc, 1);
+		try {
+			new (ptr) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			traits::deallocate(alloc, ptr, 1);
+			throw;
+		}
+		return ptr;
+	}
+
+	static void destroy(Alloc& alloc, T* ptr) {
+		ptr->~T();
+		traits::deallocate(alloc, ptr, 1);
+	}
+
+	//Releases all memory of alloc at once if the caller owns every live block (count of them),
+	//returns false (and does nothing) otherwise. The objects must already be destroyed.
+	static bool release_all(Alloc& alloc, size_t count) {
+		if constexpr (has_bulk_release<Alloc>::value) {
+			if (can_release_all(alloc, count)) {
+				alloc.release();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	//True if release_all() would succeed for a container of count nodes: all of them are
+	//pool blocks and nobody else holds one
+	static bool can_release_all(const Alloc& alloc, size_t count) {
+		if constexpr (has_bulk_release<Alloc>::value) {
+			return alloc.pooled() && alloc.live_blocks() == count;
+		}
+		else {
+			return false;
+		}
+	}
+
+	//Allocator of a copy-constructed container
+	static Alloc copy_for_container(const Alloc& alloc) {
+		return traits::select_on_container_copy_construction(alloc);
+	}
+
+	//Memory from one allocator may be released by the other
+	static bool equal(const Alloc& left, const Alloc& right) {
+		if constexpr (always_equal) {
+			return true;
+		}
+		else {
+			return left == right;
+		}
+	}
+
+	//The allocator follows the elements only where the propagate_on_container_* trait says so.
+	//The container must release its memory before the allocator is replaced.
+	static void on_copy_assignment(Alloc& dst, const Alloc& src) {
+		if constexpr (propagate_on_copy) {
+			dst = src;
+		}
+	}
+
+	static void on_move_assignment(Alloc& dst, Alloc& src) {
+		if constexpr (propagate_on_move) {
+			dst = std::move(src);
+		}
+	}
+
+	//Swapping containers with unequal, non-propagating allocators is undefined (as for std containers)
+	static void on_swap(Alloc& left, Alloc& right) {
+		if constexpr (propagate_on_swap) {
+			using std::swap;
+			swap(left, right);
+		}
+	}
+};
+
+
+template<typename Alloc, bool = std::is_empty_v<Alloc> && !std::is_final_v<Alloc>>
+class AllocatorHolder : private Alloc {
+protected:
+	explicit AllocatorHolder(const Alloc& alloc) : Alloc(alloc) {}
+	explicit AllocatorHolder(Alloc&& alloc) noexcept : Alloc(std::move(alloc)) {}
+
+	Alloc& _allocator() noexcept {
+		return *this;
+	}
+
+	const Alloc& _allocator() const noexcept {
+		return *this;
+	}
+};
+
+template<typename Alloc>
+class AllocatorHolder<Alloc, false> {
+private:
+	Alloc _alloc;
+
+protected:
+	explicit AllocatorHolder(const Alloc& alloc) : _alloc(alloc) {}
+	explicit AllocatorHolder(Alloc&& alloc) noexcept : _alloc(std::move(alloc)) {}
+
+	Alloc& _allocator() noexcept {
+		return _alloc;
+	}
+
+	const Alloc& _allocator() const noexcept {
+		return _alloc;
+	}
+};
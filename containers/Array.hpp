@@ -16,6 +16,8 @@
 *    - Maximum capacity defined by template parameter `N`
 *    - `push_back()` will throw if called beyond capacity
 *    - Iterator class supports forward and backward movement
+*    - With CONTAINERS_CHECKED=0 (see Config.hpp) Iterator is a plain T* and
+*      operator[] does no bounds check
 *    - Not thread-safe for concurrent use
 *    - There is no support for constant objects
 */
@@ -23,7 +25,9 @@
 #pragma once
 #include <stdexcept>
 #include <initializer_list>
+#include <type_traits>
 #include "String.hpp"
+#include "Config.hpp"
 
 template <typename T,const size_t N>
 class Array {
@@ -66,20 +70,20 @@ public:
     ~Array() = default;
     
     //--------------------------------- I T E R A T O R -----------------------------------
-    class Iterator {
+    class CheckedIterator {
     private:
         T* current;
         Array* parent_array;
 
     public:
-        Iterator() = delete;
-        Iterator(T* _current, Array* _parent_array) : current(_current), parent_array(_parent_array) {}
-        Iterator(const Iterator& other) : current(other.current), parent_array(other.parent_array) {}
+        CheckedIterator() = delete;
+        CheckedIterator(T* _current, Array* _parent_array) : current(_current), parent_array(_parent_array) {}
+        CheckedIterator(const CheckedIterator& other) : current(other.current), parent_array(other.parent_array) {}
 
         void is_valid() {
-            Iterator end = parent_array->end();
-            Iterator begin = parent_array->begin();
-            if (!current || current >= end.current || current < begin.current) {
+            T* begin = parent_array->data_;
+            T* end = begin + parent_array->size_;
+            if (!current || current >= end || current < begin) {
                 throw std::runtime_error("Iterator not valid");
             }
         }
@@ -110,19 +114,19 @@ public:
 
 
         // Increment/Decrement ------------------------------------------------
-        Iterator& operator++() {
+        CheckedIterator& operator++() {
             is_valid();
             ++current;
             return *this;
         }
 
-        Iterator operator++(int) {
-            Iterator tmp(*this);
+        CheckedIterator operator++(int) {
+            CheckedIterator tmp(*this);
             ++(*this);
             return tmp;
         }
 
-        Iterator& operator--() {
+        CheckedIterator& operator--() {
             if (!is_null()) {
                 --current;
             }
@@ -130,21 +134,21 @@ public:
             return *this;
         }
 
-        Iterator operator--(int) {
-            Iterator tmp(*this);
+        CheckedIterator operator--(int) {
+            CheckedIterator tmp(*this);
             --(*this);
             return tmp;
         }
 
 
         // Arithmetic operations --------------------------------------------
-        Iterator& operator+=(size_t n) {
+        CheckedIterator& operator+=(size_t n) {
             is_valid();
             current += n;
             return *this;
         }
 
-        Iterator& operator-=(size_t n) {
+        CheckedIterator& operator-=(size_t n) {
             if (!is_null()) {
                 current -= n;
             }
@@ -152,47 +156,62 @@ public:
             return *this;
         }
 
-        Iterator operator+(size_t n) const {
-            Iterator tmp(*this);
+        CheckedIterator operator+(size_t n) const {
+            CheckedIterator tmp(*this);
             tmp += n;
             return tmp;
         }
 
-        Iterator operator-(size_t n) const {
-            Iterator tmp(*this);
+        CheckedIterator operator-(size_t n) const {
+            CheckedIterator tmp(*this);
             tmp -= n;
             return tmp;
         }
 
 
         // Comparison ---------------------------------------------------------
-        bool operator==(const Iterator& other) const {
+        bool operator==(const CheckedIterator& other) const {
             return current == other.current;
         }
 
-        bool operator!=(const Iterator& other) const {
+        bool operator!=(const CheckedIterator& other) const {
             return !(current == other.current);
         }
 
-        bool operator<(const Iterator& other) const {
+        bool operator<(const CheckedIterator& other) const {
             return current < other.current;
         }
 
-        bool operator>(const Iterator& other) const {
+        bool operator>(const CheckedIterator& other) const {
             return current > other.current;
         }
 
-        bool operator<=(const Iterator& other) const {
+        bool operator<=(const CheckedIterator& other) const {
             return (current < other.current) || (current == other.current);
         }
 
-        bool operator>=(const Iterator& other) const {
+        bool operator>=(const CheckedIterator& other) const {
             return (current > other.current) || (current == other.current);
         }
 
     };
     //-------------------------------------------------------------------------------------
 
+    //Validating iterator in checked mode, raw pointer otherwise (see Config.hpp)
+    using Iterator = std::conditional_t<containers_checked, CheckedIterator, T*>;
+
+private:
+    Iterator _make_iterator(T* ptr) {
+        if constexpr (containers_checked) {
+            return Iterator(ptr, this);
+        }
+        else {
+            return ptr;
+        }
+    }
+
+public:
+
     T& front() {
         if (size_ < 1 || size_ > capacity_) {
             throw std::runtime_error("Outof bounds");
@@ -236,11 +255,11 @@ public:
     }
 
     Iterator begin() {
-        return Iterator(data_, this);
+        return _make_iterator(data_);
     }
 
     Iterator end() {
-        return Iterator(data_ + size_, this);
+        return _make_iterator(data_ + size_);
     }
 
     String toString() const {
@@ -296,15 +315,19 @@ public:
 
     //Accessing elements
     T& operator[](size_t index) {
-        if (index >= size_) {
-            throw std::out_of_range("Index out of range");
+        if constexpr (containers_checked) {
+            if (index >= size_) {
+                throw std::out_of_range("Index out of range");
+            }
         }
         return data_[index];
     }
 
     const T& operator[](size_t index) const {
-        if (index >= size_) {
-            throw std::out_of_range("Index out of range");
+        if constexpr (containers_checked) {
+            if (index >= size_) {
+                throw std::out_of_range("Index out of range");
+            }
         }
         return data_[index];
     }
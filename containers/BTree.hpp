@@ -0,0 +1,1219 @@
+/*
+*  BTree Documentation
+*
+*  BTree<T, Compare, NodeBytes> is an ordered container (sorted multiset, like AVLtree) that
+*  keeps up to Capacity elements side by side in one node instead of one element per node.
+*  A lookup touches about log_Capacity(n) nodes and reads each as a few consecutive cache
+*  lines, where AVLtree follows log2(n) pointers to scattered nodes.
+*
+*  Key Features:
+*    - The AVLtree interface: insert, erase (by iterator or key), contains, find, lower_bound,
+*      upper_bound, equal_range, for_each_in_range, rank, select, nth, count_range,
+*      assign_sorted, assign, bidirectional Iterator / ConstIterator with += and -=.
+*    - Nodes are aligned to 64-byte cache lines. A leaf takes about NodeBytes bytes (256 by
+*      default): the header plus Capacity = (NodeBytes - header) / sizeof(T) elements, at
+*      least 3. Inner nodes add Capacity + 1 child pointers.
+*    - In-node search: for arithmetic keys ordered by std::less or std::greater the position
+*      is found by counting the smaller keys of the node in one branch-free pass. With SSE2,
+*      sets of int, float and double (and 64-bit integers with SSE4.2) compare 16 bytes of
+*      keys per instruction. Other keys use a binary search inside the node.
+*    - Bulk loading: BTree(first, last), assign() and assign_sorted() fill the nodes
+*      directly from sorted input in O(n), unsorted input is sorted with parallel_sort().
+*    - Order statistics: every node stores the number of elements below it, so rank(),
+*      select(), nth(), count_range() and iterator += / -= are O(Capacity * log n).
+*    - Heterogeneous lookup with a transparent Compare, as in AVLtree.
+*
+*  Implementation Notes:
+*    - Classic B-tree: elements live in inner nodes too, every node except the root holds
+*      at least (Capacity - 1) / 2 of them and all leaves are on the same level.
+*    - Insertion splits a full node around its middle element and moves that element up,
+*      erasure borrows from a sibling or merges with it on the way back to the root.
+*    - Elements are moved inside and between nodes by relocation (move construction plus
+*      destruction, one memmove for trivially relocatable T), never by assignment, so
+*      std::pair<const K, V> entries work (see BTreeMap.hpp).
+*    - Copy, clear and the bulk build recurse once per level, the depth is the tree height.
+*
+*  Limitations:
+*    - insert() and erase() move elements between slots: they invalidate all iterators and
+*      element references (erase() returns a valid iterator to the next element).
+*    - No split/join or set operations (use AVLtree for those).
+*    - T's move constructor should not throw, elements are relocated during rebalancing.
+*    - Not thread-safe for concurrent modification.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "Allocator.hpp"
+#include "AVLtree.hpp"
+#include "ParallelSort.hpp"
+#include "Vector.hpp"
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+//Elements per node for a node of about NodeBytes bytes, the node header takes 24 of them
+template<typename T>
+constexpr size_t btree_node_capacity(size_t node_bytes) {
+	size_t fits = node_bytes > 24 ? (node_bytes - 24) / sizeof(T) : 0;
+	return fits < 3 ? 3 : (fits > 65535 ? 65535 : fits);
+}
+
+//Keys that are compared faster by scanning the whole node than by a binary search
+template<typename Key, typename Compare>
+struct btree_linear_search : std::bool_constant<std::is_arithmetic_v<Key> &&
+	(std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>> ||
+	 std::is_same_v<Compare, std::greater<Key>> || std::is_same_v<Compare, std::greater<>>)> {};
+
+namespace btree_detail {
+
+	//Keys the SSE compares below can handle
+	template<typename Key>
+	inline constexpr bool simd_key =
+#if defined(__SSE2__) || defined(_M_X64)
+		(std::is_integral_v<Key> && std::is_signed_v<Key> && sizeof(Key) == 4) ||
+#if defined(__SSE4_2__)
+		(std::is_integral_v<Key> && std::is_signed_v<Key> && sizeof(Key) == 8) ||
+#endif
+		std::is_same_v<Key, float> || std::is_same_v<Key, double>;
+#else
+		false;
+#endif
+
+	inline size_t bitCount(int mask) {
+		static const unsigned char bits[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+		return bits[mask & 15];
+	}
+
+	//Number of the first n values that are below key (above key if above), one 16-byte
+	//compare per step and a scalar loop for the rest
+	template<typename Key>
+	size_t countBeyond(const Key* values, size_t n, Key key, bool above) {
+		size_t result = 0;
+		size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+		if constexpr (std::is_integral_v<Key> && sizeof(Key) == 4) {
+			const __m128i pivot = _mm_set1_epi32(static_cast<int>(key));
+			for (; i + 4 <= n; i += 4) {
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+				__m128i mask = above ? _mm_cmpgt_epi32(block, pivot) : _mm_cmplt_epi32(block, pivot);
+				result += bitCount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+			}
+		}
+#if defined(__SSE4_2__)
+		else if constexpr (std::is_integral_v<Key> && sizeof(Key) == 8) {
+			const __m128i pivot = _mm_set1_epi64x(static_cast<long long>(key));
+			for (; i + 2 <= n; i += 2) {
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+				__m128i mask = above ? _mm_cmpgt_epi64(block, pivot) : _mm_cmpgt_epi64(pivot, block);
+				result += bitCount(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+			}
+		}
+#endif
+		else if constexpr (std::is_same_v<Key, float>) {
+			const __m128 pivot = _mm_set1_ps(key);
+			for (; i + 4 <= n; i += 4) {
+				__m128 block = _mm_loadu_ps(values + i);
+				result += bitCount(_mm_movemask_ps(above ? _mm_cmpgt_ps(block, pivot) : _mm_cmplt_ps(block, pivot)));
+			}
+		}
+		else if constexpr (std::is_same_v<Key, double>) {
+			const __m128d pivot = _mm_set1_pd(key);
+			for (; i + 2 <= n; i += 2) {
+				__m128d block = _mm_loadu_pd(values + i);
+				result += bitCount(_mm_movemask_pd(above ? _mm_cmpgt_pd(block, pivot) : _mm_cmplt_pd(block, pivot)));
+			}
+		}
+#endif
+		for (; i < n; ++i) {
+			result += above ? key < values[i] : values[i] < key;
+		}
+		return result;
+	}
+
+}
+
+template<typename T, size_t Capacity>
+struct BTreeInnerNode;
+
+template<typename T, size_t Capacity>
+struct alignas(64) BTreeNode {
+	BTreeNode* parent;
+	size_t size;        // Elements in this subtree
+	uint16_t count;     // Elements in this node
+	uint16_t position;  // Index in parent->children()
+	bool leaf;
+	alignas(T) unsigned char storage[Capacity * sizeof(T)];
+
+	explicit BTreeNode(bool _leaf = true) : parent(nullptr), size(0), count(0), position(0), leaf(_leaf) {}
+
+	T* values() {
+		return std::launder(reinterpret_cast<T*>(storage));
+	}
+
+	const T* values() const {
+		return std::launder(reinterpret_cast<const T*>(storage));
+	}
+
+	//Only for inner nodes: count + 1 children
+	BTreeNode** children() {
+		return static_cast<BTreeInnerNode<T, Capacity>*>(this)->child;
+	}
+
+	BTreeNode* const* children() const {
+		return static_cast<const BTreeInnerNode<T, Capacity>*>(this)->child;
+	}
+};
+
+template<typename T, size_t Capacity>
+struct BTreeInnerNode : BTreeNode<T, Capacity> {
+	BTreeNode<T, Capacity>* child[Capacity + 1];
+
+	BTreeInnerNode() : BTreeNode<T, Capacity>(false), child{} {}
+};
+
+
+template<typename T, typename Compare = std::less<T>, size_t NodeBytes = 256, typename Alloc = Allocator<T>, typename KeyOf = AVLIdentity>
+class BTree : private AllocatorHolder<rebind_alloc_t<Alloc, BTreeNode<T, btree_node_capacity<T>(NodeBytes)>>> {
+	static_assert(NodeBytes >= 64 && NodeBytes % 64 == 0, "BTree: NodeBytes must be a multiple of the 64-byte cache line");
+
+public:
+	using key_type = std::decay_t<decltype(KeyOf()(std::declval<const T&>()))>;
+	using value_type = T;
+	static constexpr size_t Capacity = btree_node_capacity<T>(NodeBytes);
+
+protected:
+	using Node = BTreeNode<T, Capacity>;
+	using InnerNode = BTreeInnerNode<T, Capacity>;
+	using LeafAlloc = rebind_alloc_t<Alloc, Node>;
+	using InnerAlloc = rebind_alloc_t<Alloc, InnerNode>;
+	using LeafOps = AllocatorOps<LeafAlloc>;
+	using InnerOps = AllocatorOps<InnerAlloc>;
+	using Key = key_type;
+
+	template<typename K>
+	using LookupKey = std::conditional_t<is_transparent_compare<Compare>::value, K, Key>;
+
+	static constexpr size_t minimum = (Capacity - 1) / 2;
+	static constexpr bool linear_search = btree_linear_search<Key, Compare>::value;
+
+	//An element: slot index of node, node == nullptr is the end
+	struct Position {
+		Node* node;
+		size_t index;
+	};
+
+	Node* root = nullptr;
+	size_t count = 0;
+	Compare comp;
+
+	static const Key& keyOf(const T& value) {
+		return KeyOf()(value);
+	}
+
+	Node* createLeaf() {
+		return LeafOps::create(this->_allocator());
+	}
+
+	Node* createInner() {
+		InnerAlloc alloc(this->_allocator());
+		return InnerOps::create(alloc);
+	}
+
+	//Destroys the elements of node and returns its memory, the children are left alone
+	void freeNode(Node* node) {
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			for (size_t i = 0; i < node->count; ++i) {
+				node->values()[i].~T();
+			}
+		}
+		if (node->leaf) {
+			LeafOps::destroy(this->_allocator(), node);
+		}
+		else {
+			InnerAlloc alloc(this->_allocator());
+			InnerOps::destroy(alloc, static_cast<InnerNode*>(node));
+		}
+	}
+
+	//Moves n elements from src to raw slots at dst, the ranges may overlap
+	static void moveValues(T* src, size_t n, T* dst) {
+		if (n == 0 || src == dst) {
+			return;
+		}
+		if constexpr (is_trivially_relocatable_v<T>) {
+			std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+		}
+		else if (dst < src) {
+			for (size_t i = 0; i < n; ++i) {
+				new (&dst[i]) T(std::move(src[i]));
+				src[i].~T();
+			}
+		}
+		else {
+			for (size_t i = n; i-- > 0;) {
+				new (&dst[i]) T(std::move(src[i]));
+				src[i].~T();
+			}
+		}
+	}
+
+	static void setChild(Node* parent, size_t index, Node* child) {
+		parent->children()[index] = child;
+		child->parent = parent;
+		child->position = static_cast<uint16_t>(index);
+	}
+
+	//Number of elements of node less than key, or not greater than key if upper
+	template<typename K>
+	size_t slotOf(const Node* node, const K& key, bool upper) const {
+		const T* values = node->values();
+		size_t n = node->count;
+		if constexpr (linear_search && std::is_same_v<T, Key> && std::is_same_v<K, Key> && btree_detail::simd_key<Key>) {
+			//The node is sorted, so counting the keys on one side of key gives the slot
+			constexpr bool ascending = std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>;
+			const Key& pivot = key;
+			if (upper) {
+				return n - btree_detail::countBeyond(values, n, pivot, ascending);
+			}
+			return btree_detail::countBeyond(values, n, pivot, !ascending);
+		}
+		else if constexpr (linear_search) {
+			//Same count without SIMD, no branch depends on the data
+			size_t slot = 0;
+			if (upper) {
+				for (size_t i = 0; i < n; ++i) {
+					slot += !comp(key, keyOf(values[i]));
+				}
+			}
+			else {
+				for (size_t i = 0; i < n; ++i) {
+					slot += comp(keyOf(values[i]), key);
+				}
+			}
+			return slot;
+		}
+		else {
+			size_t low = 0;
+			while (n > 0) {
+				size_t half = n / 2;
+				bool right = upper ? !comp(key, keyOf(values[low + half])) : comp(keyOf(values[low + half]), key);
+				if (right) {
+					low += half + 1;
+					n -= half + 1;
+				}
+				else {
+					n = half;
+				}
+			}
+			return low;
+		}
+	}
+
+	//First element not less than key (greater than key if upper)
+	template<typename K>
+	Position boundPosition(const K& key, bool upper) const {
+		//A hit deeper down is smaller than the ones above it and still not less than key
+		Position found{ nullptr, 0 };
+		for (Node* node = root; node;) {
+			size_t slot = slotOf(node, key, upper);
+			if (slot < node->count) {
+				found = { node, slot };
+			}
+			node = node->leaf ? nullptr : node->children()[slot];
+		}
+		return found;
+	}
+
+	template<typename K>
+	Position findPosition(const K& key) const {
+		Position position = boundPosition(key, false);
+		if (position.node && comp(key, keyOf(position.node->values()[position.index]))) {
+			return { nullptr, 0 };
+		}
+		return position;
+	}
+
+	static void next(Position& position) {
+		Node* node = position.node;
+		if (!node->leaf) {
+			node = node->children()[position.index + 1];
+			while (!node->leaf) {
+				node = node->children()[0];
+			}
+			position = { node, 0 };
+			return;
+		}
+		if (position.index + 1 < node->count) {
+			++position.index;
+			return;
+		}
+		while (node->parent && node->position == node->parent->count) {
+			node = node->parent;
+		}
+		position = node->parent ? Position{ node->parent, node->position } : Position{ nullptr, 0 };
+	}
+
+	void prev(Position& position) const {
+		Node* node = position.node;
+		if (!node) {
+			position = lastPosition();
+			return;
+		}
+		if (!node->leaf) {
+			node = node->children()[position.index];
+			while (!node->leaf) {
+				node = node->children()[node->count];
+			}
+			position = { node, node->count - 1u };
+			return;
+		}
+		if (position.index > 0) {
+			--position.index;
+			return;
+		}
+		while (node->parent && node->position == 0) {
+			node = node->parent;
+		}
+		position = node->parent ? Position{ node->parent, node->position - 1u } : Position{ nullptr, 0 };
+	}
+
+	Position firstPosition() const {
+		if (!root) {
+			return { nullptr, 0 };
+		}
+		Node* node = root;
+		while (!node->leaf) {
+			node = node->children()[0];
+		}
+		return { node, 0 };
+	}
+
+	Position lastPosition() const {
+		if (!root) {
+			return { nullptr, 0 };
+		}
+		Node* node = root;
+		while (!node->leaf) {
+			node = node->children()[node->count];
+		}
+		return { node, node->count - 1u };
+	}
+
+	//In-order index of an element, O(Capacity * log n)
+	static size_t rankOf(Position position) {
+		Node* node = position.node;
+		size_t rank = position.index;
+		if (!node->leaf) {
+			for (size_t i = 0; i <= position.index; ++i) {
+				rank += node->children()[i]->size;
+			}
+		}
+		for (; node->parent; node = node->parent) {
+			rank += node->position;
+			for (size_t i = 0; i < node->position; ++i) {
+				rank += node->parent->children()[i]->size;
+			}
+		}
+		return rank;
+	}
+
+	//The k-th smallest element, the end if k >= count
+	Position positionAt(size_t k) const {
+		if (k >= count) {
+			return { nullptr, 0 };
+		}
+		Node* node = root;
+		while (!node->leaf) {
+			for (size_t i = 0;; ++i) {
+				Node* child = node->children()[i];
+				if (k < child->size) {
+					node = child;
+					break;
+				}
+				k -= child->size;
+				if (k == 0) {
+					return { node, i };
+				}
+				--k;
+			}
+		}
+		return { node, k };
+	}
+
+	//Number of elements less than key (not greater if inclusive)
+	template<typename K>
+	size_t countBelow(const K& key, bool inclusive) const {
+		size_t result = 0;
+		for (Node* node = root; node;) {
+			size_t slot = slotOf(node, key, inclusive);
+			result += slot;
+			if (node->leaf) {
+				break;
+			}
+			for (size_t i = 0; i < slot; ++i) {
+				result += node->children()[i]->size;
+			}
+			node = node->children()[slot];
+		}
+		return result;
+	}
+
+	//Splits the full node around its middle element, which moves up into the parent
+	//(a full parent is split first). Returns the new right sibling.
+	Node* splitNode(Node* node) {
+		if (node->parent && node->parent->count == Capacity) {
+			splitNode(node->parent);
+		}
+
+		//Everything is allocated before the first element moves
+		Node* sibling = node->leaf ? createLeaf() : createInner();
+		Node* parent = node->parent;
+		if (!parent) {
+			try {
+				parent = createInner();
+			}
+			catch (...) {
+				freeNode(sibling);
+				throw;
+			}
+		}
+
+		const size_t middle = Capacity / 2;
+		const size_t moved = Capacity - middle - 1;
+		moveValues(node->values() + middle + 1, moved, sibling->values());
+		sibling->count = static_cast<uint16_t>(moved);
+		sibling->size = moved;
+		if (!node->leaf) {
+			for (size_t i = 0; i <= moved; ++i) {
+				Node* child = node->children()[middle + 1 + i];
+				setChild(sibling, i, child);
+				sibling->size += child->size;
+			}
+		}
+		node->count = static_cast<uint16_t>(middle);
+
+		if (!node->parent) {
+			moveValues(node->values() + middle, 1, parent->values());
+			parent->count = 1;
+			parent->size = node->size;
+			setChild(parent, 0, node);
+			setChild(parent, 1, sibling);
+			root = parent;
+		}
+		else {
+			size_t slot = node->position;
+			T* values = parent->values();
+			moveValues(values + slot, parent->count - slot, values + slot + 1);
+			moveValues(node->values() + middle, 1, values + slot);
+			for (size_t i = parent->count + 1; i > slot + 1; --i) {
+				setChild(parent, i, parent->children()[i - 1]);
+			}
+			setChild(parent, slot + 1, sibling);
+			++parent->count;
+		}
+		node->size -= sibling->size + 1;
+		return sibling;
+	}
+
+	//Builds an element from args at slot index of leaf (nullptr if the tree is empty)
+	template<typename... Args>
+	Position insertAt(Node* leaf, size_t index, Args&&... args) {
+		if (!leaf) {
+			root = leaf = createLeaf();
+		}
+		else if (leaf->count == Capacity) {
+			Node* sibling = splitNode(leaf);
+			if (index > leaf->count) {
+				index -= leaf->count + 1u;
+				leaf = sibling;
+			}
+		}
+
+		T* values = leaf->values();
+		moveValues(values + index, leaf->count - index, values + index + 1);
+		try {
+			new (values + index) T(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			moveValues(values + index + 1, leaf->count - index, values + index);
+			if (count == 0) {
+				freeNode(root);
+				root = nullptr;
+			}
+			throw;
+		}
+		++leaf->count;
+		for (Node* node = leaf; node; node = node->parent) {
+			++node->size;
+		}
+		++count;
+		return { leaf, index };
+	}
+
+	//Inserts an element built from args unless one with this key exists,
+	//returns that element and false then. args are only used if the element is created.
+	template<typename K, typename... Args>
+	std::pair<Position, bool> emplaceUnique(const K& key, Args&&... args) {
+		Node* node = root;
+		size_t slot = 0;
+		while (node) {
+			slot = slotOf(node, key, false);
+			if (slot < node->count && !comp(key, keyOf(node->values()[slot]))) {
+				return { Position{ node, slot }, false };
+			}
+			if (node->leaf) {
+				break;
+			}
+			node = node->children()[slot];
+		}
+		return { insertAt(node, slot, std::forward<Args>(args)...), true };
+	}
+
+	//Moves the last element of left up into slot sep of parent and the separator down into right
+	void rotateRight(Node* parent, size_t sep) {
+		Node* left = parent->children()[sep];
+		Node* right = parent->children()[sep + 1];
+		moveValues(right->values(), right->count, right->values() + 1);
+		moveValues(parent->values() + sep, 1, right->values());
+		moveValues(left->values() + left->count - 1, 1, parent->values() + sep);
+		size_t moved = 1;
+		if (!right->leaf) {
+			for (size_t i = right->count + 1u; i > 0; --i) {
+				setChild(right, i, right->children()[i - 1]);
+			}
+			Node* child = left->children()[left->count];
+			setChild(right, 0, child);
+			moved += child->size;
+		}
+		--left->count;
+		++right->count;
+		left->size -= moved;
+		right->size += moved;
+	}
+
+	//Mirror of rotateRight(): the first element of right goes up, the separator into left
+	void rotateLeft(Node* parent, size_t sep) {
+		Node* left = parent->children()[sep];
+		Node* right = parent->children()[sep + 1];
+		moveValues(parent->values() + sep, 1, left->values() + left->count);
+		moveValues(right->values(), 1, parent->values() + sep);
+		moveValues(right->values() + 1, right->count - 1u, right->values());
+		size_t moved = 1;
+		if (!left->leaf) {
+			Node* child = right->children()[0];
+			setChild(left, left->count + 1u, child);
+			for (size_t i = 0; i < right->count; ++i) {
+				setChild(right, i, right->children()[i + 1]);
+			}
+			moved += child->size;
+		}
+		++left->count;
+		--right->count;
+		left->size += moved;
+		right->size -= moved;
+	}
+
+	//Appends the separator in slot sep of parent and the whole right child to the left child
+	void mergeChildren(Node* parent, size_t sep) {
+		Node* left = parent->children()[sep];
+		Node* right = parent->children()[sep + 1];
+		moveValues(parent->values() + sep, 1, left->values() + left->count);
+		moveValues(right->values(), right->count, left->values() + left->count + 1);
+		if (!left->leaf) {
+			for (size_t i = 0; i <= right->count; ++i) {
+				setChild(left, left->count + 1u + i, right->children()[i]);
+			}
+		}
+		left->count += right->count + 1u;
+		left->size += right->size + 1;
+
+		moveValues(parent->values() + sep + 1, parent->count - sep - 1u, parent->values() + sep);
+		for (size_t i = sep + 1; i < parent->count; ++i) {
+			setChild(parent, i, parent->children()[i + 1]);
+		}
+		--parent->count;
+		right->count = 0;
+		freeNode(right);
+	}
+
+	//Refills underfull nodes from node up to the root
+	void rebalance(Node* node) {
+		while (node != root && node->count < minimum) {
+			Node* parent = node->parent;
+			size_t slot = node->position;
+			Node* left = slot > 0 ? parent->children()[slot - 1] : nullptr;
+			Node* right = slot < parent->count ? parent->children()[slot + 1] : nullptr;
+			if (left && left->count > minimum) {
+				rotateRight(parent, slot - 1);
+				return;
+			}
+			if (right && right->count > minimum) {
+				rotateLeft(parent, slot);
+				return;
+			}
+			mergeChildren(parent, left ? slot - 1 : slot);
+			node = parent;
+		}
+		if (root->count == 0) {
+			Node* old = root;
+			root = root->leaf ? nullptr : root->children()[0];
+			if (root) {
+				root->parent = nullptr;
+				root->position = 0;
+			}
+			freeNode(old);
+		}
+	}
+
+	void removeAt(Position position) {
+		Node* node = position.node;
+		T* values = node->values();
+		values[position.index].~T();
+		if (!node->leaf) {
+			//The predecessor (last element of the left subtree, always in a leaf) takes the slot
+			Node* leaf = node->children()[position.index];
+			while (!leaf->leaf) {
+				leaf = leaf->children()[leaf->count];
+			}
+			moveValues(leaf->values() + leaf->count - 1, 1, values + position.index);
+			node = leaf;
+		}
+		else {
+			moveValues(values + position.index + 1, node->count - position.index - 1, values + position.index);
+		}
+		--node->count;
+		for (Node* current = node; current; current = current->parent) {
+			--current->size;
+		}
+		--count;
+		rebalance(node);
+	}
+
+	//Removes the element, returns the position of the one after it
+	Position erasePosition(Position position) {
+		size_t rank = rankOf(position);
+		removeAt(position);
+		return positionAt(rank);
+	}
+
+	//Builds a subtree of the given height from the next total elements of it, as full as
+	//the height allows; every node gets at least minimum elements
+	template<typename ForwardIt>
+	Node* buildSorted(ForwardIt& it, size_t total, size_t height) {
+		Node* node = height == 1 ? createLeaf() : createInner();
+		try {
+			if (height == 1) {
+				for (T* values = node->values(); node->count < total; ++it) {
+					new (values + node->count) T(*it);
+					++node->count;
+				}
+			}
+			else {
+				//Fewest children that hold the elements, the elements spread evenly over them
+				size_t child_max = maxElements(height - 1);
+				size_t children = (total + 1 + child_max) / (child_max + 1);
+				size_t per_child = (total - (children - 1)) / children;
+				size_t extra = (total - (children - 1)) % children;
+				for (size_t i = 0; i < children; ++i) {
+					setChild(node, i, buildSorted(it, per_child + (i < extra ? 1 : 0), height - 1));
+					if (i + 1 < children) {
+						new (node->values() + i) T(*it);
+						++it;
+						++node->count;
+					}
+				}
+			}
+		}
+		catch (...) {
+			clear(node);
+			throw;
+		}
+		node->size = total;
+		return node;
+	}
+
+	//Elements of a full subtree of the given height: (Capacity + 1)^height - 1, saturated
+	static size_t maxElements(size_t height) {
+		size_t result = 1;
+		for (size_t i = 0; i < height; ++i) {
+			if (result > static_cast<size_t>(-1) / (Capacity + 1)) {
+				return static_cast<size_t>(-1);
+			}
+			result *= Capacity + 1;
+		}
+		return result - 1;
+	}
+
+	template<typename ForwardIt>
+	static size_t distance(ForwardIt first, ForwardIt last) {
+		size_t result = 0;
+		for (; first != last; ++first) {
+			++result;
+		}
+		return result;
+	}
+
+	template<typename ForwardIt>
+	bool isSorted(ForwardIt first, ForwardIt last) const {
+		if (first == last) {
+			return true;
+		}
+		for (ForwardIt next = first; ++next != last; first = next) {
+			if (comp(keyOf(*next), keyOf(*first))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//Copies a subtree, the depth of the recursion is its height
+	Node* copyNode(const Node* node) {
+		Node* copy = node->leaf ? createLeaf() : createInner();
+		try {
+			for (; copy->count < node->count; ++copy->count) {
+				new (copy->values() + copy->count) T(node->values()[copy->count]);
+			}
+			if (!node->leaf) {
+				for (size_t i = 0; i <= node->count; ++i) {
+					setChild(copy, i, copyNode(node->children()[i]));
+				}
+			}
+		}
+		catch (...) {
+			clear(copy);
+			throw;
+		}
+		copy->size = node->size;
+		return copy;
+	}
+
+	//Frees a subtree; children not built yet (nullptr) are skipped
+	void clear(Node* node) {
+		if (!node) {
+			return;
+		}
+		if (!node->leaf) {
+			for (size_t i = 0; i <= node->count; ++i) {
+				clear(node->children()[i]);
+			}
+		}
+		freeNode(node);
+	}
+
+public:
+	using allocator_type = Alloc;
+
+	//Constructor and destructor
+	BTree() : AllocatorHolder<LeafAlloc>(LeafAlloc()), root(nullptr), count(0) {}
+	explicit BTree(const Alloc& alloc) : AllocatorHolder<LeafAlloc>(LeafAlloc(alloc)), root(nullptr), count(0) {}
+	//Sorted input is built in O(n), anything else is sorted first (see assign())
+	template<typename ForwardIt, typename = std::enable_if_t<!std::is_integral_v<ForwardIt>>>
+	BTree(ForwardIt first, ForwardIt last, const Alloc& alloc = Alloc()) : BTree(alloc) {
+		assign(first, last);
+	}
+	BTree(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : BTree(alloc) {
+		assign(init.begin(), init.end());
+	}
+	BTree(const BTree& other) : BTree(other, Alloc(LeafOps::copy_for_container(other._allocator()))) {}
+	BTree(const BTree& other, const Alloc& alloc) : AllocatorHolder<LeafAlloc>(LeafAlloc(alloc)), comp(other.comp) {
+		root = other.root ? copyNode(other.root) : nullptr;
+		count = other.count;
+	}
+	BTree(BTree&& other) : AllocatorHolder<LeafAlloc>(std::move(other._allocator())), comp(other.comp) {
+		root = other.root;
+		count = other.count;
+		other.root = nullptr;
+		other.count = 0;
+	}
+	~BTree() {
+		clear();
+	}
+
+	//--------------------------------- I T E R A T O R -----------------------------------
+	//Iterator gives T&, ConstIterator const T&. An Iterator converts to a ConstIterator.
+	template<bool Const>
+	class BasicIterator {
+	private:
+		Position current;
+		const BTree* tree;
+
+		template<bool>
+		friend class BasicIterator;
+		friend class BTree;
+
+	public:
+		using reference = std::conditional_t<Const, const T&, T&>;
+		using pointer = std::conditional_t<Const, const T*, T*>;
+
+		BasicIterator() = delete;
+		BasicIterator(Position _current, const BTree* _tree) : current(_current), tree(_tree) {}
+		BasicIterator(const BasicIterator& other) : current(other.current), tree(other.tree) {}
+
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		BasicIterator(const BasicIterator<OtherConst>& other) : current(other.current), tree(other.tree) {}
+
+		BasicIterator& operator=(const BasicIterator& other) = default;
+
+		void is_valid() const {
+			if (!current.node) {
+				throw std::runtime_error("Iterator equal nullptr");
+			}
+		}
+
+		reference operator*() const {
+			is_valid();
+			return current.node->values()[current.index];
+		}
+
+		pointer operator->() const {
+			is_valid();
+			return &current.node->values()[current.index];
+		}
+
+
+		// Increment/Decrement ------------------------------------------------
+		BasicIterator& operator++() {
+			is_valid();
+			next(current);
+			return *this;
+		}
+
+		BasicIterator operator++(int) {
+			BasicIterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		//Decrementing end() gives the last element
+		BasicIterator& operator--() {
+			tree->prev(current);
+			return *this;
+		}
+
+		BasicIterator operator--(int) {
+			BasicIterator tmp(*this);
+			--(*this);
+			return tmp;
+		}
+
+
+		// Arithmetic operations --------------------------------------------
+		//O(Capacity * log n) through the subtree sizes, moving past either end gives end()
+		BasicIterator& operator+=(size_t n) {
+			size_t index = current.node ? rankOf(current) : tree->count;
+			current = tree->positionAt(index + n);
+			return *this;
+		}
+
+		BasicIterator& operator-=(size_t n) {
+			size_t index = current.node ? rankOf(current) : tree->count;
+			current = (n > index) ? Position{ nullptr, 0 } : tree->positionAt(index - n);
+			return *this;
+		}
+
+		BasicIterator operator+(size_t n) const {
+			BasicIterator tmp(*this);
+			tmp += n;
+			return tmp;
+		}
+
+		BasicIterator operator-(size_t n) const {
+			BasicIterator tmp(*this);
+			tmp -= n;
+			return tmp;
+		}
+
+
+		// Comparison ---------------------------------------------------------
+		template<bool OtherConst>
+		bool operator==(const BasicIterator<OtherConst>& other) const {
+			return current.node == other.current.node && current.index == other.current.index;
+		}
+
+		template<bool OtherConst>
+		bool operator!=(const BasicIterator<OtherConst>& other) const {
+			return !(*this == other);
+		}
+
+	};
+
+	using Iterator = BasicIterator<false>;
+	using ConstIterator = BasicIterator<true>;
+	//-------------------------------------------------------------------------------------
+
+	//Removes the element at position, returns the iterator to the next one
+	Iterator erase(ConstIterator position) {
+		if (!position.current.node || position.tree != this) {
+			throw std::out_of_range("Iterator out of bounds");
+		}
+		return Iterator(erasePosition(position.current), this);
+	}
+
+	Iterator erase(Iterator position) {
+		return erase(ConstIterator(position));
+	}
+
+	//Removes every element with this key, returns how many there were
+	template<typename K = Key>
+	size_t erase(const K& key) {
+		const LookupKey<K>& lookup = key;
+		size_t removed = 0;
+		Position position = boundPosition(lookup, false);
+		while (position.node && !comp(lookup, keyOf(position.node->values()[position.index]))) {
+			position = erasePosition(position);
+			++removed;
+		}
+		return removed;
+	}
+
+	//Equal elements are all kept, a new one goes after the existing ones
+	void insert(const T& value) {
+		Node* node = root;
+		size_t slot = 0;
+		while (node) {
+			slot = slotOf(node, keyOf(value), true);
+			if (node->leaf) {
+				break;
+			}
+			node = node->children()[slot];
+		}
+		insertAt(node, slot, value);
+	}
+
+	//Lookups below take a Key, or any type Compare accepts if it is transparent
+	template<typename K = Key>
+	bool contains(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return findPosition(lookup).node != nullptr;
+	}
+
+	//An element equal to key, end() if there is none
+	template<typename K = Key>
+	Iterator find(const K& key) {
+		const LookupKey<K>& lookup = key;
+		return Iterator(findPosition(lookup), this);
+	}
+
+	template<typename K = Key>
+	ConstIterator find(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(findPosition(lookup), this);
+	}
+
+	//First element not less than key, end() if there is none
+	template<typename K = Key>
+	Iterator lower_bound(const K& key) {
+		const LookupKey<K>& lookup = key;
+		return Iterator(boundPosition(lookup, false), this);
+	}
+
+	template<typename K = Key>
+	ConstIterator lower_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(boundPosition(lookup, false), this);
+	}
+
+	//First element greater than key, end() if there is none
+	template<typename K = Key>
+	Iterator upper_bound(const K& key) {
+		const LookupKey<K>& lookup = key;
+		return Iterator(boundPosition(lookup, true), this);
+	}
+
+	template<typename K = Key>
+	ConstIterator upper_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(boundPosition(lookup, true), this);
+	}
+
+	//All elements equal to key, as [first, second)
+	template<typename K = Key>
+	std::pair<Iterator, Iterator> equal_range(const K& key) {
+		const LookupKey<K>& lookup = key;
+		return { Iterator(boundPosition(lookup, false), this), Iterator(boundPosition(lookup, true), this) };
+	}
+
+	template<typename K = Key>
+	std::pair<ConstIterator, ConstIterator> equal_range(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return { ConstIterator(boundPosition(lookup, false), this), ConstIterator(boundPosition(lookup, true), this) };
+	}
+
+	//Calls function(element) for every element in [low, high] in order
+	template<typename Function>
+	void for_each_in_range(const Key& low, const Key& high, Function&& function) const {
+		for (Position position = boundPosition(low, false);
+			position.node && !comp(high, keyOf(position.node->values()[position.index])); next(position)) {
+			function(static_cast<const T&>(position.node->values()[position.index]));
+		}
+	}
+
+	//Number of elements less than key
+	template<typename K = Key>
+	size_t rank(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return countBelow(lookup, false);
+	}
+
+	//The k-th smallest element (0-based)
+	const T& select(size_t k) const {
+		Position position = positionAt(k);
+		if (!position.node) {
+			throw std::out_of_range("Index out of range");
+		}
+		return position.node->values()[position.index];
+	}
+
+	//Iterator to the k-th smallest element, end() if k >= size()
+	Iterator nth(size_t k) {
+		return Iterator(positionAt(k), this);
+	}
+
+	//Number of elements in [low, high]
+	size_t count_range(const Key& low, const Key& high) const {
+		if (comp(high, low)) {
+			return 0;
+		}
+		return countBelow(high, true) - countBelow(low, false);
+	}
+
+	//Replaces the contents with the sorted range [first, last), O(n).
+	//Throws std::invalid_argument if the range is not sorted.
+	template<typename ForwardIt>
+	void assign_sorted(ForwardIt first, ForwardIt last) {
+		if (!isSorted(first, last)) {
+			throw std::invalid_argument("BTree::assign_sorted: range is not sorted");
+		}
+		clear();
+		size_t total = distance(first, last);
+		if (total == 0) {
+			return;
+		}
+		size_t height = 1;
+		while (maxElements(height) < total) {
+			++height;
+		}
+		root = buildSorted(first, total, height);
+		count = total;
+	}
+
+	//Replaces the contents with [first, last) in any order, unsorted input is copied
+	//and sorted with parallel_sort() first
+	template<typename ForwardIt>
+	void assign(ForwardIt first, ForwardIt last) {
+		if (isSorted(first, last)) {
+			assign_sorted(first, last);
+			return;
+		}
+
+		Vector<T> values;
+		values.reserve(distance(first, last));
+		for (; first != last; ++first) {
+			values.push_back(*first);
+		}
+		parallel_sort(values.data(), values.data() + values.size(),
+			[this](const T& left, const T& right) { return comp(keyOf(left), keyOf(right)); });
+		assign_sorted(values.data(), values.data() + values.size());
+	}
+
+	void clear() {
+		clear(root);
+		root = nullptr;
+		count = 0;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	//Number of levels, 0 for an empty tree
+	size_t height() const {
+		size_t levels = 0;
+		for (const Node* node = root; node; node = node->leaf ? nullptr : node->children()[0]) {
+			++levels;
+		}
+		return levels;
+	}
+
+	Iterator begin() {
+		return Iterator(firstPosition(), this);
+	}
+
+	Iterator end() {
+		return Iterator(Position{ nullptr, 0 }, this);
+	}
+
+	ConstIterator begin() const {
+		return ConstIterator(firstPosition(), this);
+	}
+
+	ConstIterator end() const {
+		return ConstIterator(Position{ nullptr, 0 }, this);
+	}
+
+	ConstIterator cbegin() const {
+		return begin();
+	}
+
+	ConstIterator cend() const {
+		return end();
+	}
+
+	//getter
+	Node* get_root() const {
+		return root;
+	}
+
+	Alloc get_allocator() const {
+		return Alloc(this->_allocator());
+	}
+
+	//--------------------------------- O P E A T O R S -------------------------------------
+
+	BTree& operator=(const BTree& other) {
+		if (this != &other) {
+			clear();
+			LeafOps::on_copy_assignment(this->_allocator(), other._allocator());
+			comp = other.comp;
+			root = other.root ? copyNode(other.root) : nullptr;
+			count = other.count;
+		}
+		return *this;
+	}
+
+	BTree& operator=(BTree&& other) {
+		if (this != &other) {
+			clear();
+			comp = other.comp;
+			if (!LeafOps::propagate_on_move && !LeafOps::equal(this->_allocator(), other._allocator())) {
+				//The nodes of other cannot be adopted, they are copied into this tree's memory
+				root = other.root ? copyNode(other.root) : nullptr;
+				count = other.count;
+				other.clear();
+				return *this;
+			}
+
+			LeafOps::on_move_assignment(this->_allocator(), other._allocator());
+			root = other.root;
+			count = other.count;
+			other.root = nullptr;
+			other.count = 0;
+		}
+		return *this;
+	}
+
+};
@@ -0,0 +1,151 @@
+/*
+*  BTreeMap Documentation
+*
+*  BTreeMap<K, V, Compare, NodeBytes> is an ordered key/value map on the BTree engine, with
+*  the AVLmap interface. The entries are std::pair<const K, V>, BTree compares only their
+*  keys (KeyOf = AVLSelectFirst).
+*
+*  Key Features:
+*    - Unique keys: insert() and try_emplace() leave an existing entry alone,
+*      insert_or_assign() overwrites its value, operator[] inserts V() if the key is missing.
+*    - try_emplace() builds the entry in place from the key and the value arguments, and
+*      only if the key is not there yet.
+*    - Heterogeneous lookup with a transparent Compare (std::less<>), as in AVLmap.
+*    - Iterators dereference to std::pair<const K, V>.
+*
+*  Notes:
+*    - Everything inherited from BTree is available. assign_sorted() does not check for
+*      duplicate keys, the caller must keep them unique.
+*    - Entries are stored side by side, so the in-node search compares keys one by one
+*      (branch-free for arithmetic keys) instead of with the SIMD path of BTree sets.
+*    - insert() and erase() invalidate iterators and references to entries (see BTree).
+*    - Not thread-safe for concurrent modification.
+*/
+#pragma once
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "BTree.hpp"
+
+
+template<typename K, typename V, typename Compare = std::less<K>, size_t NodeBytes = 256, typename Alloc = Allocator<std::pair<const K, V>>>
+class BTreeMap : public BTree<std::pair<const K, V>, Compare, NodeBytes, Alloc, AVLSelectFirst> {
+private:
+	using Base = BTree<std::pair<const K, V>, Compare, NodeBytes, Alloc, AVLSelectFirst>;
+	using Position = typename Base::Position;
+
+	template<typename Key>
+	using LookupKey = typename Base::template LookupKey<Key>;
+
+	template<typename Key, typename... Args>
+	std::pair<typename Base::Iterator, bool> _try_emplace(Key&& key, Args&&... args) {
+		//The key is compared first, it is moved into the entry only if the entry is created
+		auto result = this->emplaceUnique(static_cast<const K&>(key), std::piecewise_construct,
+			std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return { typename Base::Iterator(result.first, this), result.second };
+	}
+
+	template<typename Key, typename M>
+	std::pair<typename Base::Iterator, bool> _insert_or_assign(Key&& key, M&& value) {
+		auto result = this->emplaceUnique(static_cast<const K&>(key), std::forward<Key>(key), std::forward<M>(value));
+		if (!result.second) {
+			result.first.node->values()[result.first.index].second = std::forward<M>(value);
+		}
+		return { typename Base::Iterator(result.first, this), result.second };
+	}
+
+	template<typename Key>
+	Position _find_or_throw(const Key& key) const {
+		const LookupKey<Key>& lookup = key;
+		Position position = this->findPosition(lookup);
+		if (!position.node) {
+			throw std::out_of_range("BTreeMap: key not found");
+		}
+		return position;
+	}
+
+public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<const K, V>;
+	using Iterator = typename Base::Iterator;
+	using ConstIterator = typename Base::ConstIterator;
+
+	//Constructors
+	BTreeMap() = default;
+	explicit BTreeMap(const Alloc& alloc) : Base(alloc) {}
+
+	//Later duplicates of a key are ignored, as in insert()
+	BTreeMap(std::initializer_list<value_type> init, const Alloc& alloc = Alloc()) : Base(alloc) {
+		for (const value_type& entry : init) {
+			insert(entry);
+		}
+	}
+
+	BTreeMap(const BTreeMap& other) = default;
+	BTreeMap(BTreeMap&& other) = default;
+	BTreeMap& operator=(const BTreeMap& other) = default;
+	BTreeMap& operator=(BTreeMap&& other) = default;
+
+	//Inserts a copy of entry unless its key exists, returns the entry with that key
+	//and whether it was inserted
+	std::pair<Iterator, bool> insert(const value_type& entry) {
+		auto result = this->emplaceUnique(entry.first, entry);
+		return { Iterator(result.first, this), result.second };
+	}
+
+	//Builds the entry from key and V(args...) only if key is missing
+	template<typename... Args>
+	std::pair<Iterator, bool> try_emplace(const K& key, Args&&... args) {
+		return _try_emplace(key, std::forward<Args>(args)...);
+	}
+
+	template<typename... Args>
+	std::pair<Iterator, bool> try_emplace(K&& key, Args&&... args) {
+		return _try_emplace(std::move(key), std::forward<Args>(args)...);
+	}
+
+	//Inserts the entry, or assigns value to the existing one; the second member is true on insertion
+	template<typename M>
+	std::pair<Iterator, bool> insert_or_assign(const K& key, M&& value) {
+		return _insert_or_assign(key, std::forward<M>(value));
+	}
+
+	template<typename M>
+	std::pair<Iterator, bool> insert_or_assign(K&& key, M&& value) {
+		return _insert_or_assign(std::move(key), std::forward<M>(value));
+	}
+
+	V& operator[](const K& key) {
+		return try_emplace(key).first->second;
+	}
+
+	V& operator[](K&& key) {
+		return try_emplace(std::move(key)).first->second;
+	}
+
+	//Value of the entry with key, throws std::out_of_range if there is none
+	template<typename Key = K>
+	V& at(const Key& key) {
+		Position position = _find_or_throw(key);
+		return position.node->values()[position.index].second;
+	}
+
+	template<typename Key = K>
+	const V& at(const Key& key) const {
+		Position position = _find_or_throw(key);
+		return position.node->values()[position.index].second;
+	}
+
+	//Replaces the contents with [first, last), later duplicates of a key are ignored.
+	//For sorted input with unique keys BTree::assign_sorted() is O(n).
+	template<typename InputIt>
+	void assign(InputIt first, InputIt last) {
+		this->clear();
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+
+};
@@ -0,0 +1,569 @@
+/*
+*  ConcurrentAVLtree Documentation
+*
+*  ConcurrentAVLtree<T, Compare> is an AVL tree for read-mostly sharing between threads:
+*  any number of readers search it without locks while writers, one at a time, publish new
+*  versions. A reader works on a Snapshot, a fixed point-in-time version of the tree.
+*
+*  Key Features:
+*    - snapshot() pins the current version: contains, find, lower_bound, upper_bound,
+*      for_each_in_range and in-order iteration see exactly the elements of that version,
+*      whatever the writers do meanwhile. contains() and size() on the tree itself use
+*      the latest version.
+*    - Readers take no lock and write to no shared cache line: each thread announces itself
+*      in its own 64-byte slot, so read throughput grows with the number of cores.
+*    - insert(), erase() and clear() copy the path from the root to the changed node
+*      (path copying) and publish the new root with one atomic store. All other subtrees
+*      are shared with the previous version.
+*    - Epoch-based reclamation: a node replaced by a commit is freed only when no reader
+*      that could still see it is left. Readers announce the global epoch they started in,
+*      the writer frees the nodes retired before the oldest announced epoch.
+*
+*  Implementation Notes:
+*    - Nodes have no parent pointer (they are shared between versions) and are never
+*      changed once published. A node built by the running commit is still private and is
+*      changed in place, so a commit copies each node at most once.
+*    - Writers are serialized by a mutex. The allocator is used only by the writer that
+*      holds it, so the default PoolAllocator needs no locking.
+*    - A commit that throws leaves the published version untouched and frees what it built.
+*    - Replacing a node with two children copies its in-order successor's value, the
+*      successor node itself may still be read by older snapshots.
+*
+*  Limitations:
+*    - A Snapshot must not outlive its tree. At most reader_slots snapshots are open at
+*      once, further readers wait for a free slot.
+*    - Memory of replaced nodes stays allocated while a snapshot from before the
+*      replacement is open.
+*    - Equal elements are kept (as in AVLtree), erase(key) removes all of them.
+*/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "Allocator.hpp"
+#include "AVLtree.hpp"
+#include "Deque.hpp"
+#include "NodePool.hpp"
+#include "PathIterator.hpp"
+#include "Vector.hpp"
+
+
+template<typename T>
+struct ConcurrentAVLNode {
+	T data;
+	ConcurrentAVLNode* left = nullptr;
+	ConcurrentAVLNode* right = nullptr;
+	int height = 1;
+	size_t size = 1;
+	uint64_t version = 0;    // Commit that built the node
+
+	template<typename... Args>
+	explicit ConcurrentAVLNode(uint64_t _version, std::in_place_t, Args&&... args) :
+		data(std::forward<Args>(args)...), version(_version) {}
+
+	ConcurrentAVLNode(uint64_t _version, const ConcurrentAVLNode& node) :
+		data(node.data), left(node.left), right(node.right), height(node.height), size(node.size), version(_version) {}
+
+	static int heightOf(const ConcurrentAVLNode* node) {
+		return node ? node->height : 0;
+	}
+
+	static size_t sizeOf(const ConcurrentAVLNode* node) {
+		return node ? node->size : 0;
+	}
+
+	int balance() const {
+		return heightOf(right) - heightOf(left);
+	}
+
+	void update() {
+		height = (heightOf(left) > heightOf(right) ? heightOf(left) : heightOf(right)) + 1;
+		size = sizeOf(left) + sizeOf(right) + 1;
+	}
+};
+
+
+template<typename T, typename Compare = std::less<T>, typename Alloc = PoolAllocator<T>, typename KeyOf = AVLIdentity>
+class ConcurrentAVLtree : private AllocatorHolder<rebind_alloc_t<Alloc, ConcurrentAVLNode<T>>> {
+public:
+	using key_type = std::decay_t<decltype(KeyOf()(std::declval<const T&>()))>;
+	using value_type = T;
+	//Snapshots that can be open at the same time
+	static constexpr size_t reader_slots = 128;
+
+private:
+	using Node = ConcurrentAVLNode<T>;
+	using NodeAlloc = rebind_alloc_t<Alloc, Node>;
+	using NodeOps = AllocatorOps<NodeAlloc>;
+	using Key = key_type;
+
+	template<typename K>
+	using LookupKey = std::conditional_t<is_transparent_compare<Compare>::value, K, Key>;
+
+	//Retired nodes are collected once this many have piled up
+	static constexpr size_t reclaim_batch = 256;
+
+	//0 while free, otherwise the epoch its reader started in
+	struct alignas(64) ReaderSlot {
+		std::atomic<uint64_t> epoch{ 0 };
+	};
+
+	struct Retired {
+		Node* node;
+		uint64_t epoch;
+	};
+
+	std::atomic<Node*> root{ nullptr };
+	std::atomic<size_t> count{ 0 };
+	std::atomic<uint64_t> epoch{ 1 };
+	mutable ReaderSlot readers[reader_slots];
+	Compare comp;
+
+	//Writer state, guarded by writer
+	std::mutex writer;
+	uint64_t version = 0;
+	Vector<Node*> created;     // Built by the running commit
+	Vector<Node*> replaced;    // Published nodes the running commit dropped
+	Vector<Node*> discarded;   // Nodes of the running commit that are garbage already
+	Deque<Retired> retired;    // Waiting for the readers, oldest first
+
+	static const Key& keyOf(const T& value) {
+		return KeyOf()(value);
+	}
+
+	//First slot a thread tries, different threads start in different slots
+	static size_t threadHint() {
+		static std::atomic<size_t> next_thread{ 0 };
+		thread_local size_t hint = next_thread.fetch_add(1, std::memory_order_relaxed);
+		return hint;
+	}
+
+	//Claims a reader slot announcing the current epoch, returns its index
+	size_t enter() const {
+		size_t slot = threadHint() % reader_slots;
+		for (size_t tries = 1;; ++tries, slot = (slot + 1) % reader_slots) {
+			uint64_t expected = 0;
+			//A stale (smaller) epoch only delays reclamation, it is never unsafe
+			if (readers[slot].epoch.compare_exchange_strong(expected, epoch.load())) {
+				return slot;
+			}
+			if (tries % reader_slots == 0) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void leave(size_t slot) const {
+		readers[slot].epoch.store(0, std::memory_order_release);
+	}
+
+	//------------------------------- W R I T E R -----------------------------------------
+
+	template<typename... Args>
+	Node* makeNode(Args&&... args) {
+		Node* node = NodeOps::create(this->_allocator(), version, std::forward<Args>(args)...);
+		try {
+			created.push_back(node);
+		}
+		catch (...) {
+			NodeOps::destroy(this->_allocator(), node);
+			throw;
+		}
+		return node;
+	}
+
+	//The node itself if this commit built it, otherwise a private copy that replaces it
+	Node* own(Node* node) {
+		if (node->version == version) {
+			return node;
+		}
+		Node* copy = makeNode(*node);
+		replaced.push_back(node);
+		return copy;
+	}
+
+	//Removes node from the new version
+	void drop(Node* node) {
+		if (node->version == version) {
+			discarded.push_back(node);
+		}
+		else {
+			replaced.push_back(node);
+		}
+	}
+
+	//Rotations and balancing work on private nodes, a child that moves is made private first
+	Node* rotateRight(Node* node) {
+		Node* left = own(node->left);
+		node->left = left->right;
+		left->right = node;
+		node->update();
+		left->update();
+		return left;
+	}
+
+	Node* rotateLeft(Node* node) {
+		Node* right = own(node->right);
+		node->right = right->left;
+		right->left = node;
+		node->update();
+		right->update();
+		return right;
+	}
+
+	Node* balance(Node* node) {
+		node->update();
+		if (node->balance() < -1) {
+			if (node->left->balance() > 0) {
+				node->left = rotateLeft(own(node->left));
+			}
+			return rotateRight(node);
+		}
+		if (node->balance() > 1) {
+			if (node->right->balance() < 0) {
+				node->right = rotateRight(own(node->right));
+			}
+			return rotateLeft(node);
+		}
+		return node;
+	}
+
+	//Equal elements go after the existing ones, as in AVLtree
+	Node* insertNode(Node* node, const T& value) {
+		if (!node) {
+			return makeNode(std::in_place, value);
+		}
+		node = own(node);
+		if (comp(keyOf(value), keyOf(node->data))) {
+			node->left = insertNode(node->left, value);
+		}
+		else {
+			node->right = insertNode(node->right, value);
+		}
+		return balance(node);
+	}
+
+	//Detaches the smallest node of the subtree as a private node
+	Node* removeMin(Node* node, Node*& min) {
+		if (!node->left) {
+			min = own(node);
+			return min->right;
+		}
+		node = own(node);
+		node->left = removeMin(node->left, min);
+		return balance(node);
+	}
+
+	//Removes one element equal to key, which must be in the subtree
+	template<typename K>
+	Node* removeNode(Node* node, const K& key) {
+		if (comp(key, keyOf(node->data))) {
+			node = own(node);
+			node->left = removeNode(node->left, key);
+			return balance(node);
+		}
+		if (comp(keyOf(node->data), key)) {
+			node = own(node);
+			node->right = removeNode(node->right, key);
+			return balance(node);
+		}
+
+		if (!node->left || !node->right) {
+			Node* child = node->left ? node->left : node->right;
+			drop(node);
+			return child;
+		}
+		Node* successor;
+		Node* right = removeMin(node->right, successor);
+		successor->left = node->left;
+		successor->right = right;
+		drop(node);
+		return balance(successor);
+	}
+
+	template<typename K>
+	static size_t countBelow(const Node* node, const K& key, bool inclusive, const Compare& comp) {
+		size_t result = 0;
+		while (node) {
+			bool right = inclusive ? !comp(key, keyOf(node->data)) : comp(keyOf(node->data), key);
+			if (right) {
+				result += Node::sizeOf(node->left) + 1;
+				node = node->right;
+			}
+			else {
+				node = node->left;
+			}
+		}
+		return result;
+	}
+
+	void collectSubtree(Node* node) {
+		for (; node; node = node->right) {
+			collectSubtree(node->left);
+			drop(node);
+		}
+	}
+
+	void destroySubtree(Node* node) {
+		while (node) {
+			destroySubtree(node->left);
+			Node* right = node->right;
+			NodeOps::destroy(this->_allocator(), node);
+			node = right;
+		}
+	}
+
+	//Frees the retired nodes no reader can reach any more
+	void reclaim() {
+		uint64_t oldest = epoch.load();
+		for (size_t i = 0; i < reader_slots; ++i) {
+			uint64_t announced = readers[i].epoch.load();
+			if (announced != 0 && announced < oldest) {
+				oldest = announced;
+			}
+		}
+		while (!retired.empty() && retired.front().epoch < oldest) {
+			NodeOps::destroy(this->_allocator(), retired.front().node);
+			retired.pop_front();
+		}
+	}
+
+	//Runs edit(root) -> new root under the writer lock and publishes the result
+	template<typename Edit>
+	void commit(Edit edit) {
+		std::lock_guard<std::mutex> lock(writer);
+		++version;
+		created.clear();
+		replaced.clear();
+		discarded.clear();
+
+		Node* updated;
+		try {
+			updated = edit(root.load(std::memory_order_relaxed));
+			for (size_t i = 0; i < replaced.size(); ++i) {
+				retired.push_back({ replaced[i], 0 });
+			}
+		}
+		catch (...) {
+			//Nothing was published: the new nodes go, the old ones stay where they are
+			for (size_t i = 0; i < replaced.size() && !retired.empty() && retired.back().epoch == 0; ++i) {
+				retired.pop_back();
+			}
+			for (size_t i = 0; i < created.size(); ++i) {
+				NodeOps::destroy(this->_allocator(), created[i]);
+			}
+			throw;
+		}
+
+		root.store(updated);
+		count.store(Node::sizeOf(updated), std::memory_order_relaxed);
+		//Readers that announce a later epoch start after the store and cannot reach the
+		//replaced nodes, the ones already inside have announced this epoch or an older one
+		uint64_t retired_in = epoch.fetch_add(1);
+		for (size_t i = retired.size(); i-- > 0 && retired[i].epoch == 0;) {
+			retired[i].epoch = retired_in;
+		}
+		for (size_t i = 0; i < discarded.size(); ++i) {
+			NodeOps::destroy(this->_allocator(), discarded[i]);
+		}
+		if (retired.size() >= reclaim_batch) {
+			reclaim();
+		}
+	}
+
+public:
+	using allocator_type = Alloc;
+
+	//--------------------------------- S N A P S H O T -----------------------------------
+	//A consistent version of the tree for one reader: lock-free, read-only, movable
+	class Snapshot {
+	private:
+		const ConcurrentAVLtree* tree;
+		size_t slot;
+		const Node* top;
+
+		friend class ConcurrentAVLtree;
+
+		explicit Snapshot(const ConcurrentAVLtree* _tree) : tree(_tree), slot(_tree->enter()) {
+			top = tree->root.load();
+		}
+
+		template<typename K>
+		const Node* findNode(const K& key) const {
+			const Node* node = top;
+			while (node) {
+				if (tree->comp(key, keyOf(node->data))) {
+					node = node->left;
+				}
+				else if (tree->comp(keyOf(node->data), key)) {
+					node = node->right;
+				}
+				else {
+					return node;
+				}
+			}
+			return nullptr;
+		}
+
+	public:
+		//Forward iterator over the snapshot, see PathIterator
+		using ConstIterator = PathIterator<Node, T>;
+
+		Snapshot(const Snapshot&) = delete;
+		Snapshot& operator=(const Snapshot&) = delete;
+
+		Snapshot(Snapshot&& other) : tree(other.tree), slot(other.slot), top(other.top) {
+			other.tree = nullptr;
+		}
+
+		~Snapshot() {
+			if (tree) {
+				tree->leave(slot);
+			}
+		}
+
+		size_t size() const {
+			return Node::sizeOf(top);
+		}
+
+		bool empty() const {
+			return top == nullptr;
+		}
+
+		template<typename K = Key>
+		bool contains(const K& key) const {
+			const LookupKey<K>& lookup = key;
+			return findNode(lookup) != nullptr;
+		}
+
+		//An element equal to key, nullptr if there is none
+		template<typename K = Key>
+		const T* find(const K& key) const {
+			const LookupKey<K>& lookup = key;
+			const Node* node = findNode(lookup);
+			return node ? &node->data : nullptr;
+		}
+
+		//First element not less than key (greater than key for upper_bound), end() if none
+		template<typename K = Key>
+		ConstIterator lower_bound(const K& key) const {
+			const LookupKey<K>& lookup = key;
+			return bound(lookup, false);
+		}
+
+		template<typename K = Key>
+		ConstIterator upper_bound(const K& key) const {
+			const LookupKey<K>& lookup = key;
+			return bound(lookup, true);
+		}
+
+		//Number of elements less than key
+		template<typename K = Key>
+		size_t rank(const K& key) const {
+			const LookupKey<K>& lookup = key;
+			return countBelow(top, lookup, false, tree->comp);
+		}
+
+		//Calls function(element) for every element in [low, high] in order
+		template<typename Function>
+		void for_each_in_range(const Key& low, const Key& high, Function&& function) const {
+			for (ConstIterator it = bound(low, false); it != end() && !tree->comp(high, keyOf(*it)); ++it) {
+				function(*it);
+			}
+		}
+
+		ConstIterator begin() const {
+			return ConstIterator::first(top);
+		}
+
+		ConstIterator end() const {
+			return ConstIterator();
+		}
+
+	private:
+		template<typename K>
+		ConstIterator bound(const K& key, bool upper) const {
+			return ConstIterator::template bound<KeyOf>(top, key, upper, tree->comp);
+		}
+	};
+	//-------------------------------------------------------------------------------------
+
+	//Constructor and destructor
+	ConcurrentAVLtree() : AllocatorHolder<NodeAlloc>(NodeAlloc()) {}
+	explicit ConcurrentAVLtree(const Alloc& alloc) : AllocatorHolder<NodeAlloc>(NodeAlloc(alloc)) {}
+	ConcurrentAVLtree(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : ConcurrentAVLtree(alloc) {
+		for (const T& value : init) {
+			insert(value);
+		}
+	}
+
+	ConcurrentAVLtree(const ConcurrentAVLtree&) = delete;
+	ConcurrentAVLtree& operator=(const ConcurrentAVLtree&) = delete;
+
+	//No snapshot may be open any more
+	~ConcurrentAVLtree() {
+		while (!retired.empty()) {
+			NodeOps::destroy(this->_allocator(), retired.front().node);
+			retired.pop_front();
+		}
+		destroySubtree(root.load());
+	}
+
+	//The current version for lock-free reads
+	Snapshot snapshot() const {
+		return Snapshot(this);
+	}
+
+	//Writers: each call is one commit, readers see all of it or nothing
+	void insert(const T& value) {
+		commit([&](Node* top) { return insertNode(top, value); });
+	}
+
+	//Removes every element with this key, returns how many there were
+	template<typename K = Key>
+	size_t erase(const K& key) {
+		const LookupKey<K>& lookup = key;
+		size_t removed = 0;
+		commit([&](Node* top) {
+			removed = countBelow(top, lookup, true, comp) - countBelow(top, lookup, false, comp);
+			for (size_t i = 0; i < removed; ++i) {
+				top = removeNode(top, lookup);
+			}
+			return top;
+		});
+		return removed;
+	}
+
+	void clear() {
+		commit([&](Node* top) {
+			collectSubtree(top);
+			return static_cast<Node*>(nullptr);
+		});
+	}
+
+	//Reads of the latest version
+	template<typename K = Key>
+	bool contains(const K& key) const {
+		return snapshot().contains(key);
+	}
+
+	size_t size() const {
+		return count.load(std::memory_order_relaxed);
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	Alloc get_allocator() const {
+		return Alloc(this->_allocator());
+	}
+
+};
@@ -0,0 +1,29 @@
+/*
+*  Config Documentation
+*
+*  Build-wide switches shared by all containers.
+*
+*  CONTAINERS_CHECKED:
+*    - 1: iterators and operator[] of Vector, Array, String and Deque check every access
+*         and throw std::out_of_range (the classic behaviour, useful for debugging).
+*    - 0: no checks on the hot path. Iterators of Vector, Array and String collapse to
+*         raw pointers, Deque iterators keep only the index arithmetic, operator[] is a
+*         plain load. Loops over the containers compile like loops over a raw array.
+*    - If not set explicitly it follows NDEBUG: checked in debug builds, unchecked in
+*      release builds. Override with -DCONTAINERS_CHECKED=0 or -DCONTAINERS_CHECKED=1.
+*
+*  Notes:
+*    - at() always checks, whatever the mode.
+*    - All translation units of one program must use the same mode.
+*/
+#pragma once
+
+#ifndef CONTAINERS_CHECKED
+#  ifdef NDEBUG
+#    define CONTAINERS_CHECKED 0
+#  else
+#    define CONTAINERS_CHECKED 1
+#  endif
+#endif
+
+inline constexpr bool containers_checked = CONTAINERS_CHECKED != 0;
@@ -0,0 +1,138 @@
+/*
+*  ContiguousIterator Documentation
+*
+*  Bounds-checked random-access iterator shared by the contiguous containers
+*  (Vector, SmallVector). It is used in checked mode only, see Config.hpp:
+*  with CONTAINERS_CHECKED=0 the containers use plain T* instead.
+*
+*  Requirements for Container:
+*    - T* data() and size_t size() const
+*
+*  Notes:
+*    - Throws std::out_of_range on out-of-bounds access.
+*    - Invalidated when the container reallocates.
+*/
+#pragma once
+#include <stdexcept>
+#include <cstddef>
+#include <iterator>
+
+
+template<typename Container, typename T>
+class ContiguousIterator {
+private:
+    Container* _container;  // Parent container
+    T* _ptr;                // Current position pointer
+
+    // Check for out-of-bounds access
+    void _check_bounds(size_t pos) const {
+        if (pos >= _container->size()) {
+            throw std::out_of_range("Iterator out of bounds");
+        }
+    }
+
+public:
+    // Types for STL compatibility
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    //difference_type is a safe and generic way to work with distances between iterators,
+    //supporting all possible scenarios, including negative values.
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    ContiguousIterator(Container& container, T* ptr)
+        : _container(&container), _ptr(ptr) {}
+
+    ~ContiguousIterator() = default;
+
+    // Basic operations ---------------------------------------------------
+    reference operator*() const {
+        _check_bounds(_ptr - _container->data());  // _container->data() points to the start of the array
+        return *_ptr;
+    }
+
+    // Increment/Decrement ------------------------------------------------
+    ContiguousIterator& operator++() {
+        //If iterator points to the last element(end() - 1), after increment it will become end() - this is valid
+        //If iterator is already end(), increment is invalid - check must be before change
+        _check_bounds(_ptr - _container->data());
+        ++_ptr;
+        return *this;
+    }
+
+    ContiguousIterator operator++(int) {
+        ContiguousIterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    ContiguousIterator& operator--() {
+        //If iterator is end(), decrement will move it to the last element - this is valid
+        //If iterator is begin(), decrement is invalid - check before change
+        _check_bounds(_ptr - _container->data());
+        --_ptr;
+        return *this;
+    }
+
+    ContiguousIterator operator--(int) {
+        ContiguousIterator tmp = *this;
+        --(*this);
+        return tmp;
+    }
+
+    // Arithmetic operations --------------------------------------------
+    ContiguousIterator operator+(difference_type n) const {
+        ContiguousIterator tmp = *this;
+        tmp += n;
+        return tmp;
+    }
+
+    ContiguousIterator operator-(difference_type n) const {
+        ContiguousIterator tmp = *this;
+        tmp -= n;
+        return tmp;
+    }
+
+    difference_type operator-(const ContiguousIterator& other) const {
+        return _ptr - other._ptr;
+    }
+
+    ContiguousIterator& operator+=(difference_type n) {
+        _ptr += n;
+        _check_bounds(_ptr - _container->data());
+        return *this;
+    }
+
+    ContiguousIterator& operator-=(difference_type n) {
+        _ptr -= n;
+        _check_bounds(_ptr - _container->data());
+        return *this;
+    }
+
+    // Comparison ---------------------------------------------------------
+    bool operator==(const ContiguousIterator& other) const {
+        return _ptr == other._ptr;
+    }
+
+    bool operator!=(const ContiguousIterator& other) const {
+        return !(*this == other);
+    }
+
+    bool operator<(const ContiguousIterator& other) const {
+        return _ptr < other._ptr;
+    }
+
+    bool operator>(const ContiguousIterator& other) const {
+        return other < *this;
+    }
+
+    bool operator<=(const ContiguousIterator& other) const {
+        return !(other < *this);
+    }
+
+    bool operator>=(const ContiguousIterator& other) const {
+        return !(*this < other);
+    }
+
+};
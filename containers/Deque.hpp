@@ -1,74 +1,447 @@
 /*
 *  Deque Documentation
 *
-*  The Deque class is a double-ended queue implementation using a dynamic circular buffer.
-*  Supports efficient insertion and deletion at both ends and provides random-access iterators.
+*  The Deque class is a double-ended queue made of fixed-size blocks and a map of block
+*  pointers. Supports efficient insertion and deletion at both ends and provides
+*  random-access iterators.
 *
 *  Key Features:
-*    - Dynamic memory expansion/shrinking for efficient storage.
+*    - Blocks are allocated as the deque grows at either end; an element never moves
+*      while elements are added or removed at the ends.
 *    - Bounds-checked element access via at() and operator[].
 *    - Support for random-access iterators with bounds checking.
-*    - Constant time insertion and deletion at both ends (amortized).
-*    - Capacity and size management (reserve, resize, shrink_to_fit).
+*    - Constant time insertion and deletion at both ends: at most one block allocation,
+*      plus a map growth that copies block pointers only.
+*    - Capacity and size management (reserve, resize, clear).
 *    - Full RAII compliance with proper copy/move semantics.
 *
 *  Notes:
-*    - Iterators throw std::out_of_range on out-of-bounds access.
-*    - Existing iterators are invalidated when capacity changes (reallocation occurs).
+*    - Iterators throw std::out_of_range on out-of-bounds access. With CONTAINERS_CHECKED=0
+*      (see Config.hpp) iterators and operator[] skip every check and only do index math.
+*    - References and pointers to elements stay valid under push_back/push_front and under
+*      pop of other elements. Iterators cache the slot of their element and are invalidated
+*      by any insertion or erasure.
+*    - Iterators step a pointer inside the current block and look up the map only when they
+*      cross into the next one, iteration runs at nearly the speed of a plain array.
+*    - insert() and erase() in the middle move the shorter side, the elements before the
+*      position or the ones after it: at most size()/2 moves, O(1) next to either end.
+*    - Bulk operations (copies, destruction, the shifts of insert/erase) walk the elements
+*      as contiguous runs, one per block; trivially copyable elements are copied with
+*      memcpy and shifted with memmove, trivially destructible ones are not destroyed.
 *    - Not thread-safe for concurrent modifications.
-*    - The underlying storage is a contiguous array (circular buffer).
-*    - When reallocation occurs, elements are rearranged to start at index 0.
+*    - A block holds about 4 KiB of elements (at least 16), a power of two, so a position
+*      splits into (block, slot) with a shift and a mask. The map is a ring of block
+*      pointers whose size is a power of two; a block emptied by a pop moves next to the
+*      other end and is reused, a queue that drains as fast as it fills allocates nothing.
+*    - max_size() is the number of slots in the allocated blocks.
+*    - Default-constructed and moved-from deques own no memory (max_size() == 0),
+*      the first insertion allocates.
+*    - Blocks and the map are raw memory from Alloc (Allocator<T> by default, rebound to
+*      T* for the map): only live slots hold constructed objects.
+*    - Copy/move assignment and swap follow the propagate_on_container_* traits of Alloc.
 */
+#pragma once
 #include <stdexcept>
 #include <initializer_list>
 #include <cstring>
 #include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Allocator.hpp"
+#include "Config.hpp"
 
 
-template<typename T>
-class Deque {
+//log2 of the elements per Deque block: about 4 KiB of them, at least 16
+constexpr size_t deque_block_shift(size_t element_size) {
+	size_t shift = 4;
+	while ((size_t(2) << shift) * element_size <= 4096) {
+		++shift;
+	}
+	return shift;
+}
+
+
+template<typename T, typename Alloc = Allocator<T>>
+class Deque : private AllocatorHolder<Alloc> {
 private:
+	using Ops = AllocatorOps<Alloc>;
+	using MapAlloc = rebind_alloc_t<Alloc, T*>;
+	using MapOps = AllocatorOps<MapAlloc>;
+
+	static constexpr size_t _block_shift = deque_block_shift(sizeof(T));
+	static constexpr size_t _block_size = size_t(1) << _block_shift;
+	static constexpr size_t _block_mask = _block_size - 1;
+	static constexpr size_t _min_map = 8;
+	static constexpr bool _trivial = std::is_trivially_copyable_v<T>;
+
+	T** _map;               // Ring of block pointers, nullptr where no block is allocated
+	size_t _map_capacity;   // Power of two
+	size_t _blocks;         // Allocated blocks
+	size_t _start;          // Ring position of the front, in [0, _map_capacity * _block_size)
 	size_t _size;
-	size_t _capacity;
 
-	size_t front_index;
-	size_t back_index;
+	size_t _ring_mask() const {
+		return (_map_capacity << _block_shift) - 1;
+	}
 
-	T* _data;
-public:
-	Deque() : _size(0), _capacity(10), front_index(0), back_index(0), _data(new T[_capacity]) {}
-	Deque(size_t capacity) : _size(0), _capacity(capacity), front_index(0), back_index(0), _data(new T[_capacity]) {}
-	Deque(const Deque& other) : _size(other._size), _capacity(other._capacity),
-		front_index(other.front_index), back_index(other.back_index), _data(new T[_capacity]) {
-		for (size_t i = front_index; i < _size;++i) {
-			_data[i] = other._data[i];
+	//Slot of the ring position p, the block must exist
+	T* _at_ring(size_t p) const {
+		return _map[p >> _block_shift] + (p & _block_mask);
+	}
+
+	//Slot of the logical position pos
+	T* _slot(size_t pos) const {
+		return _at_ring((_start + pos) & _ring_mask());
+	}
+
+	//Blocks touched by count slots that start at offset within the first block
+	static size_t _spanned(size_t offset, size_t count) {
+		return count == 0 ? 0 : ((offset + count - 1) >> _block_shift) + 1;
+	}
+
+	//Grows the map until it has room for blocks blocks in a row. Only block pointers move:
+	//the ring is unrolled from the front block, _start keeps its offset in that block.
+	void _grow_map(size_t blocks) {
+		if (blocks <= _map_capacity) {
+			return;
+		}
+		size_t new_capacity = _map_capacity ? _map_capacity * 2 : _min_map;
+		while (new_capacity < blocks) {
+			new_capacity *= 2;
+		}
+
+		MapAlloc map_alloc(this->_allocator());
+		T** new_map = MapOps::allocate(map_alloc, new_capacity);
+		size_t first = _start >> _block_shift;
+		for (size_t i = 0; i < _map_capacity; ++i) {
+			new_map[i] = _map[(first + i) & (_map_capacity - 1)];
+		}
+		for (size_t i = _map_capacity; i < new_capacity; ++i) {
+			new_map[i] = nullptr;
+		}
+		MapOps::deallocate(map_alloc, _map, _map_capacity);
+
+		_map = new_map;
+		_map_capacity = new_capacity;
+		_start &= _block_mask;
+	}
+
+	//Allocates the missing blocks under count ring positions from p
+	void _allocate_blocks(size_t p, size_t count) {
+		while (count > 0) {
+			T*& block = _map[p >> _block_shift];
+			if (!block) {
+				block = Ops::allocate(this->_allocator(), _block_size);
+				++_blocks;
+			}
+			size_t step = _block_size - (p & _block_mask);
+			if (step >= count) {
+				return;
+			}
+			count -= step;
+			p = (p + step) & _ring_mask();
+		}
+	}
+
+	//Room for count more elements after the back
+	void _reserve_back(size_t count) {
+		_grow_map(_spanned(_start & _block_mask, _size + count));
+		_allocate_blocks((_start + _size) & _ring_mask(), count);
+	}
+
+	//Room for count more elements before the front
+	void _reserve_front(size_t count) {
+		_grow_map(_spanned((_start - count) & _block_mask, _size + count));
+		_allocate_blocks((_start - count) & _ring_mask(), count);
+	}
+
+	//Moves the block at map index from, emptied by a pop, to the free map slot to if there
+	//is one: the other end grows into it next, so queue traffic keeps cycling the same blocks
+	void _recycle_block(size_t from, size_t to) {
+		if (!_map[to]) {
+			_map[to] = _map[from];
+			_map[from] = nullptr;
+		}
+	}
+
+	//Calls function(ptr, n) for the contiguous runs that make up count elements from pos,
+	//each run lies in one block
+	template<typename Function>
+	void _for_each_span(size_t pos, size_t count, Function&& function) const {
+		size_t p = (_start + pos) & _ring_mask();
+		while (count > 0) {
+			size_t n = _block_size - (p & _block_mask);
+			if (n > count) {
+				n = count;
+			}
+			function(_at_ring(p), n);
+			count -= n;
+			p = (p + n) & _ring_mask();
+		}
+	}
+
+	//Moves count elements from logical position src to dst, the ranges may overlap and every
+	//slot involved must be in an allocated block. One memmove per pair of contiguous runs.
+	void _move_trivial(size_t dst, size_t src, size_t count) {
+		static_assert(_trivial, "Only trivially copyable elements are moved as bytes");
+		const size_t mask = _ring_mask();
+		if (dst < src) {
+			size_t s = (_start + src) & mask;
+			size_t d = (_start + dst) & mask;
+			while (count > 0) {
+				size_t n = _block_size - (s & _block_mask);
+				size_t room = _block_size - (d & _block_mask);
+				n = n < room ? n : room;
+				n = n < count ? n : count;
+				std::memmove(static_cast<void*>(_at_ring(d)), static_cast<const void*>(_at_ring(s)), n * sizeof(T));
+				s = (s + n) & mask;
+				d = (d + n) & mask;
+				count -= n;
+			}
+		}
+		else if (dst > src) {
+			//Backwards from the ends, so the source is read before it is overwritten
+			size_t s = (_start + src + count) & mask;
+			size_t d = (_start + dst + count) & mask;
+			while (count > 0) {
+				size_t n = (s & _block_mask) ? (s & _block_mask) : _block_size;
+				size_t room = (d & _block_mask) ? (d & _block_mask) : _block_size;
+				n = n < room ? n : room;
+				n = n < count ? n : count;
+				s = (s - n) & mask;
+				d = (d - n) & mask;
+				std::memmove(static_cast<void*>(_at_ring(d)), static_cast<const void*>(_at_ring(s)), n * sizeof(T));
+				count -= n;
+			}
+		}
+	}
+
+	//Constructs count copies of value from position pos on, the slots are raw
+	void _fill(size_t pos, size_t count, const T& value) {
+		_for_each_span(pos, count, [&](T* ptr, size_t n) {
+			for (size_t i = 0; i < n; ++i) {
+				new (ptr + i) T(value);
+			}
+		});
+	}
+
+	//Destroys count elements from position pos on
+	void _destroy(size_t pos, size_t count) {
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			_for_each_span(pos, count, [](T* ptr, size_t n) {
+				for (size_t i = 0; i < n; ++i) {
+					ptr[i].~T();
+				}
+			});
+		}
+	}
+
+	void _destroy_elements() {
+		_destroy(0, _size);
+		_size = 0;
+	}
+
+	//Appends copies (or moves) of the elements of other, both deques get the same offset in
+	//their first block so the runs line up and trivially copyable runs are one memcpy each
+	template<typename Source>
+	void _append_from(Source& other) {
+		if (_map_capacity == 0) {
+			_start = other._start & _block_mask;
+		}
+		reserve(_size + other._size);
+		if constexpr (_trivial) {
+			if (((_start + _size) & _block_mask) == (other._start & _block_mask)) {
+				size_t pos = _size;
+				other._for_each_span(0, other._size, [&](T* src, size_t n) {
+					std::memcpy(static_cast<void*>(_slot(pos)), static_cast<const void*>(src), n * sizeof(T));
+					pos += n;
+				});
+				_size = pos;
+				return;
+			}
 		}
+		other._for_each_span(0, other._size, [&](T* src, size_t n) {
+			for (size_t i = 0; i < n; ++i) {
+				if constexpr (std::is_const_v<Source>) {
+					new (_slot(_size)) T(src[i]);
+				}
+				else {
+					new (_slot(_size)) T(std::move(src[i]));
+				}
+				++_size;
+			}
+		});
 	}
-	Deque(Deque&& other) noexcept : _size(other._size), _capacity(other._capacity),
-		front_index(other.front_index), back_index(other.back_index), _data(other._data) {
-		other._size = 0;
-		other._capacity = 10;
-		other.front_index = 0;
-		other.back_index = 0;
-		other._data = nullptr;
+
+	//Destroys all live elements and releases the blocks and the map
+	void _release() {
+		_destroy_elements();
+		for (size_t i = 0; i < _map_capacity; ++i) {
+			Ops::deallocate(this->_allocator(), _map[i], _block_size);
+		}
+		MapAlloc map_alloc(this->_allocator());
+		MapOps::deallocate(map_alloc, _map, _map_capacity);
+	}
+
+	//Opens a gap of count slots at pos by moving the shorter side outwards and fills it
+	//with copies of value: an edit next to either end moves only the few elements before it
+	void _insert(size_t pos, size_t count, const T& value) {
+		if (count == 0) {
+			return;
+		}
+		const T copy(value);   // value may be one of the elements that move
+		const bool front = pos < _size - pos;
+		if (front) {
+			_reserve_front(count);
+		}
+		else {
+			_reserve_back(count);
+		}
+		const size_t mask = _ring_mask();
+
+		if constexpr (_trivial) {
+			if (front) {
+				_start = (_start - count) & mask;
+				_move_trivial(0, count, pos);
+			}
+			else {
+				_move_trivial(pos + count, pos, _size - pos);
+			}
+			_fill(pos, count, copy);
+		}
+		else if (front) {
+			//Positions from the new front: slots below count are raw memory (constructed),
+			//the others hold live elements (assigned)
+			const size_t new_start = (_start - count) & mask;
+			auto slot = [&](size_t i) { return _at_ring((new_start + i) & mask); };
+			for (size_t i = 0; i < pos; ++i) {
+				T* src = slot(i + count);
+				if (i < count) {
+					new (slot(i)) T(std::move(*src));
+				}
+				else {
+					*slot(i) = std::move(*src);
+				}
+			}
+			for (size_t i = pos; i < pos + count; ++i) {
+				if (i < count) {
+					new (slot(i)) T(copy);
+				}
+				else {
+					*slot(i) = copy;
+				}
+			}
+			_start = new_start;
+		}
+		else {
+			//Slots with a logical index below _size hold live objects (assigned),
+			//the ones above are raw memory (constructed)
+			for (size_t i = _size; i > pos; --i) {
+				T* src = _slot(i - 1);
+				size_t dst = i - 1 + count;
+				if (dst >= _size) {
+					new (_slot(dst)) T(std::move(*src));
+				}
+				else {
+					*_slot(dst) = std::move(*src);
+				}
+			}
+			for (size_t i = pos; i < pos + count; ++i) {
+				if (i < _size) {
+					*_slot(i) = copy;
+				}
+				else {
+					new (_slot(i)) T(copy);
+				}
+			}
+		}
+		_size += count;
 	}
-	Deque(std::initializer_list<T> init) : _size(init.size()), _capacity(init.size() > 10 ? init.size() * 2 : 10),
-		front_index(0), back_index(init.size() - 1), _data(new T[_capacity]) {
 
-		size_t i = 0;
-		try {
-			for (const auto& it : init) {
-				_data[i] = it;
-				++i;
+	//Closes the gap of count elements at first by moving the shorter side inwards,
+	//the slots left over at that end are destroyed
+	void _erase(size_t first, size_t count) {
+		const size_t last = first + count;
+		if (first < _size - last) {
+			if constexpr (_trivial) {
+				_move_trivial(count, 0, first);
 			}
+			else {
+				for (size_t i = first; i > 0; --i) {
+					*_slot(i - 1 + count) = std::move(*_slot(i - 1));
+				}
+				_destroy(0, count);
+			}
+			_start = (_start + count) & _ring_mask();
 		}
-		catch (...) {
-			delete[] _data;
-			throw;
+		else {
+			if constexpr (_trivial) {
+				_move_trivial(first, last, _size - last);
+			}
+			else {
+				for (size_t i = last; i < _size; ++i) {
+					*_slot(i - count) = std::move(*_slot(i));
+				}
+				_destroy(_size - count, count);
+			}
+		}
+		_size -= count;
+	}
+
+	void _reset() noexcept {
+		_map = nullptr;
+		_map_capacity = 0;
+		_blocks = 0;
+		_start = 0;
+		_size = 0;
+	}
+
+	//Takes the storage of other, the allocators must be equal
+	void _steal(Deque& other) noexcept {
+		_map = other._map;
+		_map_capacity = other._map_capacity;
+		_blocks = other._blocks;
+		_start = other._start;
+		_size = other._size;
+		other._reset();
+	}
+
+	void _swap_storage(Deque& other) noexcept {
+		std::swap(_map, other._map);
+		std::swap(_map_capacity, other._map_capacity);
+		std::swap(_blocks, other._blocks);
+		std::swap(_start, other._start);
+		std::swap(_size, other._size);
+	}
+
+public:
+	using allocator_type = Alloc;
+
+	//No memory is allocated until the first insertion.
+	//The other constructors delegate here, so a throwing element copy is cleaned up by ~Deque
+	Deque() : Deque(Alloc()) {}
+	explicit Deque(const Alloc& alloc) : AllocatorHolder<Alloc>(alloc), _map(nullptr), _map_capacity(0),
+		_blocks(0), _start(0), _size(0) {}
+	Deque(size_t capacity, const Alloc& alloc = Alloc()) : Deque(alloc) {
+		reserve(capacity);
+	}
+	Deque(const Deque& other) : Deque(other, Ops::copy_for_container(other._allocator())) {}
+	Deque(const Deque& other, const Alloc& alloc) : Deque(alloc) {
+		_append_from(other);
+	}
+	Deque(Deque&& other) noexcept : AllocatorHolder<Alloc>(other._allocator()) {
+		_steal(other);
+	}
+	Deque(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : Deque(alloc) {
+		reserve(init.size());
+		for (const auto& it : init) {
+			new (_slot(_size)) T(it);
+			++_size;
 		}
 	}
 	~Deque() {
-		delete[] _data;
+		_release();
 	}
 
 
@@ -76,21 +449,25 @@ public:
 	class Iterator {
 	private:
 		Deque* _container;
-		T* _ptr;
-
-		size_t _get_logical_pos() const {
-			size_t current_index = _ptr - _container->_data;
-			if (current_index >= _container->front_index) {
-				return current_index - _container->front_index;
+		size_t _pos;          // Logical position
+		T* _ptr;              // Slot of _pos, nullptr outside [0, size())
+		T* _block_begin;      // Block of _ptr: ++ and -- only step a pointer inside it
+		T* _block_end;
+
+		void _seek() {
+			if (_pos < _container->_size) {
+				size_t p = (_container->_start + _pos) & _container->_ring_mask();
+				_block_begin = _container->_map[p >> _block_shift];
+				_block_end = _block_begin + _block_size;
+				_ptr = _block_begin + (p & _block_mask);
 			}
 			else {
-				return current_index + _container->_capacity - _container->front_index;
+				_ptr = _block_begin = _block_end = nullptr;
 			}
 		}
 
 		void _check_dereference() const {
-			size_t logical_pos = _get_logical_pos();
-			if (logical_pos >= _container->_size) {
+			if (_pos >= _container->_size) {
 				throw std::out_of_range("Dereferencing invalid iterator");
 			}
 		}
@@ -102,48 +479,58 @@ public:
 		}
 
 	public:
-		Iterator(T* ptr, Deque* container) : _ptr(ptr), _container(container) {}
+		Iterator(size_t pos, Deque* container) : _container(container), _pos(pos) {
+			_seek();
+		}
 
 		T& operator*() {
-			if (!_ptr || _ptr < _container->_data || _ptr >= _container->_data + _container->_capacity) {
-				size_t current_index = _ptr - _container->_data;
-				if (current_index >= _container->_capacity) {
-					throw std::out_of_range("Dereferencing invalid iterator");
-				}
-				return *_ptr;
+			if constexpr (containers_checked) {
+				_check_dereference();
 			}
 			return *_ptr;
 		}
 
 		T* operator->() {
-			_check_dereference();
-			return _ptr; 
+			if constexpr (containers_checked) {
+				_check_dereference();
+			}
+			return _ptr;
 		}
 
 		const T& operator*() const {
-			if (!_ptr || _ptr < _container->_data || _ptr >= _container->_data + _container->_capacity) {
-				size_t current_index = _ptr - _container->_data;
-				if (current_index >= _container->_capacity) {
-					throw std::out_of_range("Dereferencing invalid iterator");
-				}
-				return *_ptr;
+			if constexpr (containers_checked) {
+				_check_dereference();
 			}
 			return *_ptr;
 		}
 
 		const T* operator->() const {
-			_check_dereference();
-			return _ptr;  // Исправлено: было &_ptr
+			if constexpr (containers_checked) {
+				_check_dereference();
+			}
+			return _ptr;
 		}
 
 		//Increment/decrement --------------------------------------------------
 		Iterator& operator++() {
-			*this += 1;
+			if constexpr (containers_checked) {
+				_check_arithmetic(_pos + 1);
+			}
+			++_pos;
+			if (_ptr == _block_end || ++_ptr == _block_end) {
+				_seek();
+			}
 			return *this;
 		}
 
 		Iterator& operator--() {
-			*this -= 1;
+			--_pos;
+			if (_ptr == _block_begin) {
+				_seek();
+			}
+			else {
+				--_ptr;
+			}
 			return *this;
 		}
 
@@ -161,25 +548,18 @@ public:
 
 		//Arithmetic operations -----------------------------------------------
 		Iterator& operator+=(size_t n) {
-			size_t logical_pos = _get_logical_pos();
-			size_t new_logical_pos = logical_pos + n;
-			_check_arithmetic(new_logical_pos);
-
-			size_t new_physical_index = (new_logical_pos + _container->front_index) % _container->_capacity;
-			_ptr = _container->_data + new_physical_index;
+			if constexpr (containers_checked) {
+				_check_arithmetic(_pos + n);
+			}
+			_pos += n;
+			_seek();
 			return *this;
 		}
 
+		//Stepping before begin() gives a position that is invalid to dereference
 		Iterator& operator-=(size_t n) {
-			size_t logical_pos = _get_logical_pos();
-			if (n > logical_pos) {
-				_ptr = nullptr;
-				return *this;
-			}
-			size_t new_logical_pos = logical_pos - n;
-
-			size_t new_physical_index = (new_logical_pos + _container->front_index) % _container->_capacity;
-			_ptr = _container->_data + new_physical_index;
+			_pos -= n;
+			_seek();
 			return *this;
 		}
 
@@ -197,22 +577,17 @@ public:
 
 		//Iterator difference
 		ptrdiff_t operator-(const Iterator& other) const {
-			if (_container != other._container) {
-				throw std::invalid_argument("Iterators from different containers");
+			if constexpr (containers_checked) {
+				if (_container != other._container) {
+					throw std::invalid_argument("Iterators from different containers");
+				}
 			}
-			return static_cast<ptrdiff_t>(_get_logical_pos()) -
-				static_cast<ptrdiff_t>(other._get_logical_pos());
+			return static_cast<ptrdiff_t>(_pos) - static_cast<ptrdiff_t>(other._pos);
 		}
 
 		// Comparison ------------------------------------------------------------
-		Iterator& operator=(const Iterator& other) {
-			_ptr = other._ptr;
-			_container = other._container;
-			return *this;
-		}
-
 		bool operator==(const Iterator& other) const {
-			return _ptr == other._ptr;
+			return _pos == other._pos;
 		}
 
 		bool operator!=(const Iterator& other) const {
@@ -220,7 +595,7 @@ public:
 		}
 
 		bool operator<(const Iterator& other) const {
-			return _get_logical_pos() < other._get_logical_pos();
+			return _pos < other._pos;
 		}
 
 		bool operator>(const Iterator& other) const {
@@ -240,89 +615,25 @@ public:
 
 	//Adding elements :
 	void push_back(const T& value) {
-		if (_size >= _capacity) {
-			reserve(_capacity < 10 ? 10 : _capacity * 2);
-		}
-
-		if (empty()) {
-			front_index = 0;
-			back_index = 0;
-			_data[back_index] = value;
-		}
-		else {
-			size_t new_index = (back_index + 1) % _capacity;
-			_data[new_index] = value;
-			back_index = new_index;
-		}
-
+		_reserve_back(1);
+		new (_slot(_size)) T(value);
 		++_size;
 	}
 
 	void push_front(const T& value) {
-		if (_size >= _capacity) {
-			reserve(_capacity < 10 ? 10 : _capacity * 2);
-		}
-
-		if (empty()) {
-			front_index = 0;
-			back_index = 0;
-			_data[front_index] = value;
-		}
-		else {
-			size_t new_index = (front_index - 1 + _capacity) % _capacity;
-			_data[new_index] = value;
-			front_index = new_index;
-		}
+		_reserve_front(1);
+		size_t new_start = (_start - 1) & _ring_mask();
+		new (_at_ring(new_start)) T(value);
+		_start = new_start;
 		++_size;
 	}
 
 	void insert(const Iterator& pos, const T& value) {
-		size_t logical_pos = pos - begin();
-
-		if (_size >= _capacity) {
-			reserve(_capacity ? _capacity * 2 : 10);
-		}
-
-		for (size_t i = _size; i > logical_pos; --i) {
-			size_t curr_phys = (front_index + i) % _capacity;
-			size_t prev_phys = (front_index + i - 1) % _capacity;
-			_data[curr_phys] = std::move(_data[prev_phys]);
-		}
-
-		size_t insert_phys = (front_index + logical_pos) % _capacity;
-		new (&_data[insert_phys]) T(value);
-
-		++_size;
-		back_index = (front_index + _size) % _capacity;
+		_insert(pos - begin(), 1, value);
 	}
 
 	void insert(const Iterator& pos, size_t count, const T& value) {
-		if (count == 0) return;
-
-		const size_t logical_pos = pos - begin();
-
-		if (_size + count > _capacity) {
-			size_t new_capacity = std::max(_capacity * 2, _size + count);
-			reserve(new_capacity);
-		}
-
-		size_t elements_after = _size - logical_pos;
-
-		for (size_t i = 0; i < elements_after; ++i) {
-			size_t src_idx = _size - 1 - i;
-			size_t dst_idx = _size - 1 - i + count;
-			size_t src_physical = (front_index + src_idx) % _capacity;
-			size_t dst_physical = (front_index + dst_idx) % _capacity;
-			_data[dst_physical] = std::move(_data[src_physical]);
-		}
-
-		for (size_t i = 0; i < count; ++i) {
-			size_t physical_idx = (front_index + logical_pos + i) % _capacity;
-			new (&_data[physical_idx]) T(value);
-		}
-
-		_size += count;
-		back_index = (front_index + _size) % _capacity;
+		_insert(pos - begin(), count, value);
 	}
 
 
@@ -332,64 +643,58 @@ public:
 		if (empty()) {
 			throw std::out_of_range("Deque is empty");
 		}
-		return _data[front_index];
+		return *_slot(0);
 	}
 
 	const T& front() const {
 		if (empty()) {
 			throw std::out_of_range("Deque is empty");
 		}
-		return _data[front_index];
+		return *_slot(0);
 	}
 
 	T& back() {
 		if (empty()) {
 			throw std::out_of_range("Deque is empty");
 		}
-		return _data[back_index];
+		return *_slot(_size - 1);
 	}
 
 	const T& back() const {
 		if (empty()) {
 			throw std::out_of_range("Deque is empty");
 		}
-		return _data[back_index];
+		return *_slot(_size - 1);
 	}
 
 	Iterator begin() {
-		return empty() ? end() : Iterator(&_data[front_index], this);
+		return Iterator(0, this);
 	}
 
 	Iterator end() {
-		if (empty()) {
-			return Iterator(_data, this);
-		}
-		return Iterator(&_data[back_index + 1], this);
+		return Iterator(_size, this);
 	}
 
 	const Iterator begin() const {
-		return empty() ? end() : Iterator(&_data[front_index], this);
+		return Iterator(0, const_cast<Deque*>(this));
 	}
 
 	const Iterator end() const {
-		if (empty()) {
-			return Iterator(_data, this);
-		}
-		return Iterator(&_data[back_index + 1], this);
+		return Iterator(_size, const_cast<Deque*>(this));
 	}
 
 	T& at(size_t pos) {
-		if (pos > _capacity) {
+		if (pos >= _size) {
 			throw std::out_of_range("Iterator out of bounds");
 		}
-		return _data[pos];
+		return *_slot(pos);
 	}
 
 	const T& at(size_t pos) const {
-		if (pos > _capacity) {
+		if (pos >= _size) {
 			throw std::out_of_range("Iterator out of bounds");
 		}
-		return _data[pos];
+		return *_slot(pos);
 	}
 
 
@@ -399,16 +704,12 @@ public:
 		if (empty()) {
 			throw std::out_of_range("pop_back on empty deque");
 		}
-
-		_data[back_index].~T();
+		_slot(_size - 1)->~T();
 		--_size;
 
-		if (empty()) {
-			front_index = 0;
-			back_index = 0;
-		}
-		else {
-			back_index = (back_index + _capacity - 1) % _capacity;
+		size_t end = (_start + _size) & _ring_mask();
+		if (_size > 0 && (end & _block_mask) == 0) {
+			_recycle_block(end >> _block_shift, ((_start >> _block_shift) - 1) & (_map_capacity - 1));
 		}
 	}
 
@@ -416,34 +717,22 @@ public:
 		if (empty()) {
 			throw std::out_of_range("popfront_index on empty deque");
 		}
-
-		_data[front_index].~T();
+		_slot(0)->~T();
+		size_t old_block = _start >> _block_shift;
+		_start = (_start + 1) & _ring_mask();
 		--_size;
 
-		if (empty()) {
-			front_index = 0;
-			back_index = 0;
+		if (_size == 0) {
+			_start = old_block << _block_shift;   // An emptied queue starts over in the block it owns
 		}
-		else {
-			front_index = (front_index + 1) % _capacity;
+		else if ((_start & _block_mask) == 0) {
+			size_t last = (_start + _size - 1) & _ring_mask();
+			_recycle_block(old_block, ((last >> _block_shift) + 1) & (_map_capacity - 1));
 		}
-
 	}
 
 	void erase(const Iterator& pos) {
-		size_t logical_pos = pos - begin(); 
-
-		size_t physical_pos = (front_index + logical_pos) % _capacity;
-		_data[physical_pos].~T();
-
-		for (size_t i = logical_pos; i < _size - 1; ++i) {
-			size_t curr_phys = (front_index + i) % _capacity;
-			size_t next_phys = (front_index + i + 1) % _capacity;
-			_data[curr_phys] = std::move(_data[next_phys]);
-		}
-
-		--_size;
-		back_index = (front_index + _size) % _capacity;
+		_erase(pos - begin(), 1);
 	}
 
 	void erase(const Iterator first, const Iterator last) {
@@ -453,29 +742,7 @@ public:
 		if (first == last) {
 			return;
 		}
-
-		const size_t first_logical = first - begin();
-		const size_t last_logical = last - begin();
-		const size_t count = last_logical - first_logical;
-
-		// Уничтожение элементов в диапазоне
-		for (size_t i = 0; i < count; ++i) {
-			size_t physical_idx = (front_index + first_logical + i) % _capacity;
-			_data[physical_idx].~T();
-		}
-
-		// Сдвиг оставшихся элементов (двумя частями для кольцевого буфера)
-		size_t elements_after = _size - last_logical;
-
-		// Часть 1: Сдвигаем элементы после удаляемого диапазона влево
-		for (size_t i = 0; i < elements_after; ++i) {
-			size_t src_physical = (front_index + last_logical + i) % _capacity;
-			size_t dst_physical = (front_index + first_logical + i) % _capacity;
-			_data[dst_physical] = std::move(_data[src_physical]);
-		}
-
-		_size -= count;
-		back_index = (front_index + _size) % _capacity;
+		_erase(first - begin(), last - first);
 	}
 
 
@@ -490,109 +757,92 @@ public:
 	}
 
 	size_t max_size() const {
-		return _capacity;
+		return _blocks << _block_shift;
 	}
 
-	void reserve(size_t new_capacity) {
-		if (new_capacity <= _capacity) { return; }
+	Alloc get_allocator() const {
+		return this->_allocator();
+	}
 
-		T* new_data = new T[new_capacity]();
-		size_t new_index = 0;
+	void swap(Deque& other) noexcept {
+		_swap_storage(other);
+		Ops::on_swap(this->_allocator(), other._allocator());
+	}
 
-		if (!empty()) {
-			size_t current = front_index;
-			for (size_t i = 0; i < _size; ++i) {
-				new_data[new_index++] = _data[current];
-				current = (current + 1) % _capacity;
-			}
+	//Allocates the blocks for new_capacity elements from the front, nothing is moved
+	void reserve(size_t new_capacity) {
+		if (new_capacity > _size) {
+			_reserve_back(new_capacity - _size);
 		}
-
-		delete[] _data;
-		_data = new_data;
-		_capacity = new_capacity;
-		front_index = 0;
-		back_index = (_size == 0) ? 0 : _size - 1;
 	}
 
 	void resize(size_t count, const T& value = T()) {
 		if (count == _size) { return; }
 
 		if (count > _size) {
-			if (_size + count >= _capacity) {
-				reserve(_capacity < 10 ? 10 : _size + count + 10);
-			}
-
-			size_t count_add = count - _size;
-			for (size_t i = 0; i < count_add; ++i) {
+			reserve(count);
+			while (_size < count) {
 				push_back(value);
 			}
 		}
 		else {
-			size_t count_remove = _size - count;
-			for (size_t i = 0; i < count_remove; ++i) {
+			while (_size > count) {
 				pop_back();
 			}
 		}
 	}
 
+	//Destroys the elements, the blocks are kept for reuse
 	void clear() {
-		if (_data) {
-			delete[] _data;
-		}
-		_capacity = 10;
-		_size = 0;
-		front_index = 0;
-		back_index = 0;
-		_data = new T[_capacity];
+		_destroy_elements();
 	}
 
 	//----------------------------------------- O P E R A T O R S ------------------------------------------------
 	Deque& operator=(const Deque& other) {
 		if (this != &other) {
-			delete[] _data;
-
-			_size = other._size;
-			_capacity = other._capacity;
-			front_index = other.front_index;
-			back_index = other.back_index;
-
-			_data = new T[_capacity];
-			if (other._data) {
-				memcpy(_data, other._data, _capacity * sizeof(T));
+			if (Ops::propagate_on_copy && !Ops::equal(this->_allocator(), other._allocator())) {
+				//The old blocks go back to the allocator they came from
+				_release();
+				_reset();
 			}
+			Ops::on_copy_assignment(this->_allocator(), other._allocator());
+
+			Deque tmp(other, this->_allocator());
+			_swap_storage(tmp);
 		}
 		return *this;
 	}
 
-	Deque& operator=(Deque&& other) noexcept {
+	Deque& operator=(Deque&& other) noexcept(Ops::propagate_on_move || Ops::always_equal) {
 		if (this != &other) {
-			delete[] _data;
-
-			_data = other._data;
-			_size = other._size;
-			_capacity = other._capacity;
-			front_index = other.front_index;
-			back_index = other.back_index;
+			if (!Ops::propagate_on_move && !Ops::equal(this->_allocator(), other._allocator())) {
+				//The blocks of other cannot be adopted, the elements are moved one by one
+				Deque tmp(this->_allocator());
+				tmp._append_from(other);
+				other.clear();
+				_swap_storage(tmp);
+				return *this;
+			}
 
-			other._data = nullptr;
-			other._size = 0;
-			other._capacity = 10;
-			other.front_index = 0;
-			other.back_index = 0;
+			_release();
+			Ops::on_move_assignment(this->_allocator(), other._allocator());
+			_steal(other);
 		}
 		return *this;
 	}
 
 	T& operator[](size_t index) {
-		if (index >= _size) throw std::out_of_range("Index out of range");
-		size_t physical_idx = (front_index + index) % _capacity;
-		return _data[physical_idx];
+		if constexpr (containers_checked) {
+			if (index >= _size) throw std::out_of_range("Index out of range");
+		}
+		return *_slot(index);
 	}
 
 	const T& operator[](size_t index) const {
-		if (index >= _size) throw std::out_of_range("Index out of range");
-		size_t physical_idx = (front_index + index) % _capacity;
-		return _data[physical_idx];
+		if constexpr (containers_checked) {
+			if (index >= _size) throw std::out_of_range("Index out of range");
+		}
+		return *_slot(index);
 	}
 
 };
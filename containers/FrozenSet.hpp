@@ -0,0 +1,530 @@
+/*
+*  FrozenSet Documentation
+*
+*  FrozenSet<T, Compare> is a read-only sorted set stored in one contiguous array in
+*  Eytzinger (BFS) order: slot 1 is the root and slot k has its children in slots 2k and
+*  2k + 1. AVLtree::freeze() builds one from a tree in O(n).
+*
+*  Key Features:
+*    - contains(), lower_bound() and upper_bound() walk down the implicit tree with a fixed
+*      number of steps and no data-dependent branch: every step is k = 2k + (slot k < key).
+*      The first levels are shared by all searches and stay in cache.
+*    - Every step prefetches the cache line with the descendants four levels further down
+*      (16 ints, fewer for bigger T), so most loads of a search are already on their way.
+*    - contains_many(keys, count, found) runs 8 searches in lockstep, so up to 8 cache
+*      misses overlap instead of waiting for each other.
+*    - Iteration in sorted order with a bidirectional ConstIterator (elements are const).
+*    - Heterogeneous lookup with a transparent Compare, as in AVLtree.
+*
+*  Implementation Notes:
+*    - Slot 0 of the array is never constructed, the elements are in slots 1..n.
+*    - A search ends below a leaf; the answer is found from the final slot number by
+*      dropping its trailing one bits (the turns to the right) and one more bit.
+*    - Equal elements are all kept, lower_bound() finds the first of them.
+*
+*  Limitations:
+*    - No insert or erase: rebuild with assign() / assign_sorted() or AVLtree::freeze().
+*    - Not thread-safe for concurrent assignment, concurrent lookups are fine.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "Allocator.hpp"
+#include "AVLtree.hpp"
+#include "ParallelSort.hpp"
+#include "Vector.hpp"
+
+
+template<typename T, typename Compare, typename Alloc, typename KeyOf>
+class FrozenSet : private AllocatorHolder<Alloc> {
+public:
+	using key_type = std::decay_t<decltype(KeyOf()(std::declval<const T&>()))>;
+	using value_type = T;
+	//Searches contains_many() keeps in flight at once
+	static constexpr size_t batch = 8;
+
+private:
+	using Ops = AllocatorOps<Alloc>;
+	using Key = key_type;
+
+	template<typename K>
+	using LookupKey = std::conditional_t<is_transparent_compare<Compare>::value, K, Key>;
+
+	//Slot k * prefetch_stride starts the descendants of k a few levels down
+	static constexpr size_t prefetch_stride = sizeof(T) >= 32 ? 2 : 64 / sizeof(T);
+
+	T* slots = nullptr;   // n + 1 slots, slot 0 unused
+	size_t count = 0;
+	size_t levels = 0;    // Bit width of count: depth of the deepest slot
+	Compare comp;
+
+	static const Key& keyOf(const T& value) {
+		return KeyOf()(value);
+	}
+
+	static size_t trailingOnes(size_t k) {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<size_t>(__builtin_ctzll(~static_cast<unsigned long long>(k)));
+#else
+		size_t result = 0;
+		for (; k & 1; k >>= 1) {
+			++result;
+		}
+		return result;
+#endif
+	}
+
+	void prefetch(size_t k) const {
+#if defined(__GNUC__) || defined(__clang__)
+		//Address arithmetic on integers: the line may lie past the end of the array
+		__builtin_prefetch(reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(slots) + k * prefetch_stride * sizeof(T)));
+#else
+		(void)k;
+#endif
+	}
+
+	//One step down from slot k: to the right child if slot k is below key (not above if upper)
+	template<typename K>
+	size_t step(size_t k, const K& key, bool upper) const {
+		bool right = upper ? !comp(key, keyOf(slots[k])) : comp(keyOf(slots[k]), key);
+		return 2 * k + right;
+	}
+
+	//Slot of the first element not below key (above key if upper), 0 if there is none.
+	//The first levels - 1 levels exist for every path, only the last step needs a check.
+	template<typename K>
+	size_t search(const K& key, bool upper) const {
+		if (count == 0) {
+			return 0;
+		}
+		size_t k = 1;
+		for (size_t level = 1; level < levels; ++level) {
+			prefetch(k);
+			k = step(k, key, upper);
+		}
+		if (k <= count) {
+			k = step(k, key, upper);
+		}
+		return k >> (trailingOnes(k) + 1);
+	}
+
+	//In-order neighbours of slot k, 0 stands for the end
+	size_t firstSlot() const {
+		size_t k = count ? 1 : 0;
+		while (k && 2 * k <= count) {
+			k *= 2;
+		}
+		return k;
+	}
+
+	size_t nextSlot(size_t k) const {
+		if (2 * k + 1 <= count) {
+			k = 2 * k + 1;
+			while (2 * k <= count) {
+				k *= 2;
+			}
+			return k;
+		}
+		return k >> (trailingOnes(k) + 1);
+	}
+
+	size_t prevSlot(size_t k) const {
+		if (k == 0) {
+			k = count ? 1 : 0;
+			while (k && 2 * k + 1 <= count) {
+				k = 2 * k + 1;
+			}
+			return k;
+		}
+		if (2 * k <= count) {
+			k *= 2;
+			while (2 * k + 1 <= count) {
+				k = 2 * k + 1;
+			}
+			return k;
+		}
+		while (k && !(k & 1)) {
+			k >>= 1;
+		}
+		return k >> 1;
+	}
+
+	//Destroys the first built elements in sorted order and frees the array, if any
+	void release(size_t built) {
+		if (!slots) {
+			return;
+		}
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			for (size_t k = firstSlot(); built > 0; k = nextSlot(k), --built) {
+				slots[k].~T();
+			}
+		}
+		Ops::deallocate(this->_allocator(), slots, count + 1);
+		slots = nullptr;
+		count = 0;
+		levels = 0;
+	}
+
+	//Copies total elements of a sorted range into the slots in sorted order (the in-order
+	//walk of the implicit tree), throws std::invalid_argument if the range is not sorted.
+	//An empty range allocates nothing and leaves slots null.
+	template<typename ForwardIt>
+	void build(ForwardIt first, size_t total) {
+		count = 0;
+		levels = 0;
+		if (total == 0) {
+			return;
+		}
+		slots = Ops::allocate(this->_allocator(), total + 1);
+		count = total;
+		for (size_t n = total; n; n >>= 1) {
+			++levels;
+		}
+
+		size_t built = 0;
+		try {
+			size_t previous = 0;
+			for (size_t k = firstSlot(); k; k = nextSlot(k), ++first) {
+				new (&slots[k]) T(*first);
+				++built;
+				if (previous && comp(keyOf(slots[k]), keyOf(slots[previous]))) {
+					throw std::invalid_argument("FrozenSet::assign_sorted: range is not sorted");
+				}
+				previous = k;
+			}
+		}
+		catch (...) {
+			release(built);
+			throw;
+		}
+	}
+
+	template<typename ForwardIt>
+	static size_t distance(ForwardIt first, ForwardIt last) {
+		size_t result = 0;
+		for (; first != last; ++first) {
+			++result;
+		}
+		return result;
+	}
+
+	//Keys of one contains_many() batch as LookupKey<K>: the caller's keys themselves when
+	//Compare takes K, otherwise copies converted to Key once for the whole descent
+	template<typename K, bool Convert = !std::is_same_v<LookupKey<K>, K>>
+	class LookupBatch {
+	public:
+		LookupBatch(const K* group, size_t) : keys(group) {}
+
+		const K& operator[](size_t j) const {
+			return keys[j];
+		}
+
+	private:
+		const K* keys;
+	};
+
+	template<typename K>
+	class LookupBatch<K, true> {
+	public:
+		LookupBatch(const K* group, size_t width) {
+			try {
+				for (; built < width; ++built) {
+					new (&keys()[built]) Key(group[built]);
+				}
+			}
+			catch (...) {
+				destroy();
+				throw;
+			}
+		}
+
+		~LookupBatch() {
+			destroy();
+		}
+
+		LookupBatch(const LookupBatch&) = delete;
+		LookupBatch& operator=(const LookupBatch&) = delete;
+
+		const Key& operator[](size_t j) const {
+			return keys()[j];
+		}
+
+	private:
+		alignas(Key) unsigned char storage[batch * sizeof(Key)];
+		size_t built = 0;
+
+		void destroy() {
+			for (size_t j = 0; j < built; ++j) {
+				keys()[j].~Key();
+			}
+		}
+
+		Key* keys() {
+			return std::launder(reinterpret_cast<Key*>(storage));
+		}
+
+		const Key* keys() const {
+			return std::launder(reinterpret_cast<const Key*>(storage));
+		}
+	};
+
+public:
+	using allocator_type = Alloc;
+
+	//Constructor and destructor
+	FrozenSet() : AllocatorHolder<Alloc>(Alloc()) {}
+	explicit FrozenSet(const Alloc& alloc) : AllocatorHolder<Alloc>(alloc) {}
+	FrozenSet(const Compare& compare, const Alloc& alloc) : AllocatorHolder<Alloc>(alloc), comp(compare) {}
+	//Any order, see assign()
+	template<typename ForwardIt, typename = std::enable_if_t<!std::is_integral_v<ForwardIt>>>
+	FrozenSet(ForwardIt first, ForwardIt last, const Alloc& alloc = Alloc()) : FrozenSet(alloc) {
+		assign(first, last);
+	}
+	FrozenSet(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : FrozenSet(alloc) {
+		assign(init.begin(), init.end());
+	}
+	FrozenSet(const FrozenSet& other) : AllocatorHolder<Alloc>(Ops::copy_for_container(other._allocator())), comp(other.comp) {
+		assign_sorted(other.begin(), other.end());
+	}
+	FrozenSet(FrozenSet&& other) : AllocatorHolder<Alloc>(std::move(other._allocator())),
+		slots(other.slots), count(other.count), levels(other.levels), comp(other.comp) {
+		other.slots = nullptr;
+		other.count = 0;
+		other.levels = 0;
+	}
+	~FrozenSet() {
+		clear();
+	}
+
+	//--------------------------------- I T E R A T O R -----------------------------------
+	//Walks the slots in sorted order, elements are read-only
+	class ConstIterator {
+	private:
+		size_t slot;
+		const FrozenSet* set;
+
+		friend class FrozenSet;
+
+	public:
+		ConstIterator() = delete;
+		ConstIterator(size_t _slot, const FrozenSet* _set) : slot(_slot), set(_set) {}
+
+		void is_valid() const {
+			if (!slot) {
+				throw std::runtime_error("Iterator equal nullptr");
+			}
+		}
+
+		const T& operator*() const {
+			is_valid();
+			return set->slots[slot];
+		}
+
+		const T* operator->() const {
+			is_valid();
+			return &set->slots[slot];
+		}
+
+		ConstIterator& operator++() {
+			is_valid();
+			slot = set->nextSlot(slot);
+			return *this;
+		}
+
+		ConstIterator operator++(int) {
+			ConstIterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		//Decrementing end() gives the last element
+		ConstIterator& operator--() {
+			slot = set->prevSlot(slot);
+			return *this;
+		}
+
+		ConstIterator operator--(int) {
+			ConstIterator tmp(*this);
+			--(*this);
+			return tmp;
+		}
+
+		bool operator==(const ConstIterator& other) const {
+			return slot == other.slot;
+		}
+
+		bool operator!=(const ConstIterator& other) const {
+			return slot != other.slot;
+		}
+	};
+
+	using Iterator = ConstIterator;
+	//-------------------------------------------------------------------------------------
+
+	//Lookups below take a Key, or any type Compare accepts if it is transparent
+	template<typename K = Key>
+	bool contains(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		size_t k = search(lookup, false);
+		return k && !comp(lookup, keyOf(slots[k]));
+	}
+
+	//First element not less than key, end() if there is none
+	template<typename K = Key>
+	ConstIterator lower_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(search(lookup, false), this);
+	}
+
+	//First element greater than key, end() if there is none
+	template<typename K = Key>
+	ConstIterator upper_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator(search(lookup, true), this);
+	}
+
+	//found[i] = contains(keys[i]) for i < total. The searches of a batch advance one level
+	//at a time together, their memory accesses overlap.
+	template<typename K = Key>
+	void contains_many(const K* keys, size_t total, bool* found) const {
+		if (count == 0) {
+			for (size_t i = 0; i < total; ++i) {
+				found[i] = false;
+			}
+			return;
+		}
+
+		for (size_t start = 0; start < total; start += batch) {
+			size_t width = total - start < batch ? total - start : batch;
+			LookupBatch<K> group(keys + start, width);
+			size_t k[batch];
+			for (size_t j = 0; j < width; ++j) {
+				k[j] = 1;
+			}
+			for (size_t level = 1; level < levels; ++level) {
+				for (size_t j = 0; j < width; ++j) {
+					prefetch(k[j]);
+					k[j] = step(k[j], group[j], false);
+				}
+			}
+			for (size_t j = 0; j < width; ++j) {
+				const LookupKey<K>& lookup = group[j];
+				if (k[j] <= count) {
+					k[j] = step(k[j], lookup, false);
+				}
+				size_t slot = k[j] >> (trailingOnes(k[j]) + 1);
+				found[start + j] = slot && !comp(lookup, keyOf(slots[slot]));
+			}
+		}
+	}
+
+	//Replaces the contents with the sorted range [first, last), O(n).
+	//Throws std::invalid_argument if the range is not sorted.
+	template<typename ForwardIt>
+	void assign_sorted(ForwardIt first, ForwardIt last) {
+		clear();
+		build(first, distance(first, last));
+	}
+
+	//Replaces the contents with [first, last) in any order, unsorted input is copied
+	//and sorted with parallel_sort() first
+	template<typename ForwardIt>
+	void assign(ForwardIt first, ForwardIt last) {
+		bool sorted = true;
+		if (first != last) {
+			for (ForwardIt previous = first, next = first; ++next != last; previous = next) {
+				if (comp(keyOf(*next), keyOf(*previous))) {
+					sorted = false;
+					break;
+				}
+			}
+		}
+		if (sorted) {
+			assign_sorted(first, last);
+			return;
+		}
+
+		Vector<T> values;
+		values.reserve(distance(first, last));
+		for (; first != last; ++first) {
+			values.push_back(*first);
+		}
+		parallel_sort(values.data(), values.data() + values.size(),
+			[this](const T& left, const T& right) { return comp(keyOf(left), keyOf(right)); });
+		assign_sorted(values.data(), values.data() + values.size());
+	}
+
+	void clear() {
+		if (slots) {
+			release(count);
+		}
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	ConstIterator begin() const {
+		return ConstIterator(firstSlot(), this);
+	}
+
+	ConstIterator end() const {
+		return ConstIterator(0, this);
+	}
+
+	ConstIterator cbegin() const {
+		return begin();
+	}
+
+	ConstIterator cend() const {
+		return end();
+	}
+
+	Alloc get_allocator() const {
+		return this->_allocator();
+	}
+
+	//--------------------------------- O P E A T O R S -------------------------------------
+
+	FrozenSet& operator=(const FrozenSet& other) {
+		if (this != &other) {
+			clear();
+			Ops::on_copy_assignment(this->_allocator(), other._allocator());
+			comp = other.comp;
+			assign_sorted(other.begin(), other.end());
+		}
+		return *this;
+	}
+
+	FrozenSet& operator=(FrozenSet&& other) {
+		if (this != &other) {
+			clear();
+			comp = other.comp;
+			if (!Ops::propagate_on_move && !Ops::equal(this->_allocator(), other._allocator())) {
+				assign_sorted(other.begin(), other.end());
+				other.clear();
+				return *this;
+			}
+
+			Ops::on_move_assignment(this->_allocator(), other._allocator());
+			slots = other.slots;
+			count = other.count;
+			levels = other.levels;
+			other.slots = nullptr;
+			other.count = 0;
+			other.levels = 0;
+		}
+		return *this;
+	}
+
+};
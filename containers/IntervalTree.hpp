@@ -0,0 +1,152 @@
+/*
+*  IntervalTree Documentation
+*
+*  IntervalTree<T, Item> is an ordered multiset of closed intervals [low, high] for overlap
+*  queries. It is an AVLtree ordered by (low, high) and augmented with the largest high of
+*  every subtree (AVLMax), so a query skips each subtree that ends before it.
+*
+*  Key Features:
+*    - overlaps(low, high): whether any interval overlaps [low, high], O(log n).
+*    - for_each_overlapping(low, high, f) and overlapping(low, high): all intervals that
+*      overlap [low, high] in order, O(log n + k log n) for k results (far less when they
+*      are adjacent in the order).
+*    - for_each_containing(point, f): stabbing query, intervals with low <= point <= high.
+*    - Item is Interval<T> by default; any type with members low and high of type T works,
+*      so the intervals can carry a payload (a booking id, a task).
+*    - Everything inherited from AVLtree is available: insert, erase, iteration, rank...
+*
+*  Notes:
+*    - Intervals with equal bounds are all kept; erase(item) removes every interval with
+*      the bounds of item, erase(iterator) exactly one.
+*    - insert() and append_max() throw std::invalid_argument if high < low.
+*    - An item must not be changed in place while it is in the tree.
+*    - Not thread-safe for concurrent modification.
+*/
+#pragma once
+#include <stdexcept>
+#include "AVLtree.hpp"
+#include "Vector.hpp"
+
+
+template<typename T>
+struct Interval {
+	T low;
+	T high;
+
+	bool operator==(const Interval& other) const {
+		return low == other.low && high == other.high;
+	}
+
+	bool operator!=(const Interval& other) const {
+		return !(*this == other);
+	}
+};
+
+//Orders intervals by low, then by high
+struct IntervalOrder {
+	template<typename Item>
+	bool operator()(const Item& a, const Item& b) const {
+		return a.low < b.low || (!(b.low < a.low) && a.high < b.high);
+	}
+};
+
+//Get for the augmentation: the summarized value is the upper end
+struct IntervalHigh {
+	template<typename Item>
+	const auto& operator()(const Item& item) const {
+		return item.high;
+	}
+};
+
+
+template<typename T, typename Item = Interval<T>, typename Alloc = PoolAllocator<Item>>
+class IntervalTree : public AVLtree<Item, IntervalOrder, Alloc, AVLIdentity, AVLMax<T, IntervalHigh>> {
+private:
+	using Base = AVLtree<Item, IntervalOrder, Alloc, AVLIdentity, AVLMax<T, IntervalHigh>>;
+	using Node = typename Base::Node;
+
+	//Visits the intervals of the subtree that overlap [low, high] in order, depth <= height
+	template<typename Function>
+	static void visitOverlapping(const Node* node, const T& low, const T& high, Function& function) {
+		while (node && !(node->summary < low)) {
+			visitOverlapping(node->left, low, high, function);
+			if (high < node->data.low) {
+				return;   // This interval and the whole right subtree start after high
+			}
+			if (!(node->data.high < low)) {
+				function(static_cast<const Item&>(node->data));
+			}
+			node = node->right;
+		}
+	}
+
+	static void checkBounds(const Item& item) {
+		if (item.high < item.low) {
+			throw std::invalid_argument("IntervalTree: high < low");
+		}
+	}
+
+public:
+	using Iterator = typename Base::Iterator;
+	using ConstIterator = typename Base::ConstIterator;
+
+	//Constructors
+	IntervalTree() = default;
+	explicit IntervalTree(const Alloc& alloc) : Base(alloc) {}
+
+	IntervalTree(std::initializer_list<Item> init, const Alloc& alloc = Alloc()) : Base(alloc) {
+		for (const Item& item : init) {
+			insert(item);
+		}
+	}
+
+	IntervalTree(const IntervalTree& other) = default;
+	IntervalTree(IntervalTree&& other) = default;
+	IntervalTree& operator=(const IntervalTree& other) = default;
+	IntervalTree& operator=(IntervalTree&& other) = default;
+
+	void insert(const Item& item) {
+		checkBounds(item);
+		Base::insert(item);
+	}
+
+	//Appends item after every interval in the order, see AVLtree::append_max()
+	Iterator append_max(const Item& item) {
+		checkBounds(item);
+		return Base::append_max(item);
+	}
+
+	//Whether some interval overlaps [low, high], O(log n)
+	bool overlaps(const T& low, const T& high) const {
+		//If the left subtree reaches low but holds no overlap, all of it starts after high
+		//and so does everything to its right: the answer is on the left or nowhere
+		const Node* node = this->root;
+		while (node) {
+			if (!(high < node->data.low) && !(node->data.high < low)) {
+				return true;
+			}
+			node = node->left && !(node->left->summary < low) ? node->left : node->right;
+		}
+		return false;
+	}
+
+	//Calls function(item) for every interval that overlaps [low, high], in order
+	template<typename Function>
+	void for_each_overlapping(const T& low, const T& high, Function&& function) const {
+		visitOverlapping(this->root, low, high, function);
+	}
+
+	//Calls function(item) for every interval that contains point
+	template<typename Function>
+	void for_each_containing(const T& point, Function&& function) const {
+		visitOverlapping(this->root, point, point, function);
+	}
+
+	//The intervals that overlap [low, high], in order
+	Vector<Item> overlapping(const T& low, const T& high) const {
+		Vector<Item> result;
+		for_each_overlapping(low, high, [&](const Item& item) { result.push_back(item); });
+		return result;
+	}
+
+};
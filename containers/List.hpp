@@ -16,52 +16,86 @@
 *    - Iterators become invalid after element deletion
 *    - Not thread-safe for concurrent access
 *    - Uses deep copying for copy operations
+*    - Nodes come from Alloc rebound to the node type. The default PoolAllocator<T>
+*      (NodePool.hpp) cuts them from contiguous chunks owned by this list, and clear()
+*      drops whole chunks instead of freeing every node when the list owns the pool alone.
+*      Copy/move assignment and swap follow the propagate_on_container_* traits of Alloc.
 */
 #pragma once 
 #include <stdexcept>
 #include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "Allocator.hpp"
+#include "NodePool.hpp"
 
 
+//The node lives outside of List so that the allocator base class can be rebound to it
 template<typename T>
-class List {
-private:
-	size_t _size;
-	struct Node {
-		T _data;
-		Node* _next;
-		Node* _prev;
+struct ListNode {
+	T _data;
+	ListNode* _next;
+	ListNode* _prev;
 
-		Node(const T& data_ = T(),Node* next_ = nullptr, Node* prev_ = nullptr) : _data(data_), _next(next_), _prev(prev_) {}
-		Node(T&& data_, Node* next_ = nullptr, Node* prev_ = nullptr) : _data(std::move(data_)), _next(next_), _prev(prev_) {}
+	ListNode(const T& data_ = T(), ListNode* next_ = nullptr, ListNode* prev_ = nullptr) : _data(data_), _next(next_), _prev(prev_) {}
+	ListNode(T&& data_, ListNode* next_ = nullptr, ListNode* prev_ = nullptr) : _data(std::move(data_)), _next(next_), _prev(prev_) {}
 
-		void swap(Node& other) {
-			std::swap(_data, other._data);
-		}
-	};
+	void swap(ListNode& other) {
+		std::swap(_data, other._data);
+	}
+};
+
+
+template<typename T, typename Alloc = PoolAllocator<T>>
+class List : private AllocatorHolder<rebind_alloc_t<Alloc, ListNode<T>>> {
+private:
+	using Node = ListNode<T>;
+	using NodeAlloc = rebind_alloc_t<Alloc, Node>;
+	using NodeOps = AllocatorOps<NodeAlloc>;
+
+	size_t _size;
 	Node* _head;
 	Node* _tail;
+
+	template<typename... Args>
+	Node* _create_node(Args&&... args) {
+		return NodeOps::create(this->_allocator(), std::forward<Args>(args)...);
+	}
+
+	void _destroy_node(Node* node) {
+		NodeOps::destroy(this->_allocator(), node);
+	}
+
+	//Takes the nodes of other, the allocators must be equal
+	void _steal(List& other) noexcept {
+		_head = other._head;
+		_tail = other._tail;
+		_size = other._size;
+
+		other._head = nullptr;
+		other._tail = nullptr;
+		other._size = 0;
+	}
+
 public:
+	using allocator_type = Alloc;
+
 	//Constructor and destructor
-	List() : _size(0), _head(nullptr), _tail(nullptr) {}
-	List(size_t count, const T& value) : _size(0) {
-		if (count > 0) {
-			_head = new Node(value);
-			Node* _current = _head;
-			_size = 1;
-
-			for (size_t i = 1; i < count; ++i) {
-				_current->_next = new Node(value);
-				_current = _current->_next;
-				++_size;
-			}
-			_tail = _current;
+	//Built in place, a default-constructed pool allocator does not allocate anything
+	List() : AllocatorHolder<NodeAlloc>(NodeAlloc()), _size(0), _head(nullptr), _tail(nullptr) {}
+	explicit List(const Alloc& alloc) : AllocatorHolder<NodeAlloc>(NodeAlloc(alloc)), _size(0), _head(nullptr), _tail(nullptr) {}
+	List(size_t count, const T& value, const Alloc& alloc = Alloc()) : List(alloc) {
+		for (size_t i = 0; i < count; ++i) {
+			push_back(value);
 		}
 	}
 	List(size_t count) : List(count,T()) {}
-	List(const List& other) : _size(other._size), _head(nullptr), _tail(nullptr) {
+	List(const List& other) : List(other, Alloc(NodeOps::copy_for_container(other._allocator()))) {}
+	List(const List& other, const Alloc& alloc) : AllocatorHolder<NodeAlloc>(NodeAlloc(alloc)), _size(other._size), _head(nullptr), _tail(nullptr) {
 		try {
 			if (other._size > 0) {
-				_head = new Node(other._head->_data);
+				_head = _create_node(other._head->_data);
 				Node* _current = _head;
 				Node* other_current = other._head;
 				_size = 1;
@@ -71,7 +105,7 @@ public:
 						throw std::runtime_error("Invalid source list");
 					}
 
-					_current->_next = new Node(other_current->_next->_data, nullptr, _current);
+					_current->_next = _create_node(other_current->_next->_data, nullptr, _current);
 					_current = _current->_next;
 					other_current = other_current->_next;
 					++_size;
@@ -88,22 +122,20 @@ public:
 			throw;
 		}
 	}
-	List(List&& other) noexcept : _size(other._size), _head(other._head), _tail(other._tail) {
-		other._size = 0;
-		other._head = nullptr;
-		other._tail = nullptr;
+	List(List&& other) noexcept : AllocatorHolder<NodeAlloc>(std::move(other._allocator())), _size(0), _head(nullptr), _tail(nullptr) {
+		_steal(other);
 	}
-	List(std::initializer_list<T> init) : _size(0), _head(nullptr), _tail(nullptr) {
+	List(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : AllocatorHolder<NodeAlloc>(NodeAlloc(alloc)), _size(0), _head(nullptr), _tail(nullptr) {
 		try {
 			if (init.size() > 0) {
 				auto it = init.begin();
-				_head = new Node(*it);
+				_head = _create_node(*it);
 				Node* _current = _head;
 				_size = 1;
 
 				++it;
 				for (; it != init.end(); ++it) {
-					_current->_next = new Node(*it, nullptr, _current);
+					_current->_next = _create_node(*it, nullptr, _current);
 					_current = _current->_next;
 					++_size;
 				}
@@ -254,11 +286,11 @@ public:
 
 	void push_back(const T& value) {
 		if (empty()) {
-			_head = new Node(value);
+			_head = _create_node(value);
 			_tail = _head;
 		}
 		else {
-			_tail->_next = new Node(value,nullptr,_tail);
+			_tail->_next = _create_node(value,nullptr,_tail);
 			_tail = _tail->_next;
 		}
 		++_size;
@@ -266,11 +298,11 @@ public:
 
 	void push_back(T&& value) {
 		if (empty()) {
-			_head = new Node(std::move(value));
+			_head = _create_node(std::move(value));
 			_tail = _head;
 		}
 		else {
-			_tail->_next = new Node(std::move(value), nullptr, _tail);
+			_tail->_next = _create_node(std::move(value), nullptr, _tail);
 			_tail = _tail->_next;
 		}
 		++_size;
@@ -278,11 +310,11 @@ public:
 
 	void push_front(const T& value) {
 		if (empty()) {
-			_head = new Node(value);
+			_head = _create_node(value);
 			_tail = _head;
 		}
 		else {
-			_head->_prev = new Node(value, _head, nullptr);
+			_head->_prev = _create_node(value, _head, nullptr);
 			_head = _head->_prev;
 		}
 		++_size;
@@ -290,11 +322,11 @@ public:
 
 	void push_front(T&& value) {
 		if (empty()) {
-			_head = new Node(std::move(value));
+			_head = _create_node(std::move(value));
 			_tail = _head;
 		}
 		else {
-			_head->_prev = new Node(std::move(value), _head, nullptr);
+			_head->_prev = _create_node(std::move(value), _head, nullptr);
 			_head = _head->_prev;
 		}
 		++_size;
@@ -310,7 +342,7 @@ public:
 			return;
 		}
 
-		Node* new_node = new Node(value, position.current, position.current->_prev);
+		Node* new_node = _create_node(value, position.current, position.current->_prev);
 		position.current->_prev->_next = new_node;
 		position.current->_prev = new_node;
 		++_size;
@@ -339,7 +371,7 @@ public:
 		_size += n;
 
 		while (n > 0) {
-			Node* new_node = new Node(value, cpy_position.current, cpy_position.current->_prev);
+			Node* new_node = _create_node(value, cpy_position.current, cpy_position.current->_prev);
 			cpy_position.current->_prev->_next = new_node;
 			cpy_position.current->_prev = new_node;
 			--cpy_position;
@@ -364,7 +396,7 @@ public:
 			_tail = _tail->_prev;
 			_tail->_next = nullptr;
 		}
-		delete remove_node;
+		_destroy_node(remove_node);
 		--_size;
 	}
 
@@ -382,7 +414,7 @@ public:
 			_head = _head->_next;
 			_head->_prev = nullptr;
 		}
-		delete remove_node;
+		_destroy_node(remove_node);
 		--_size;
 	}
 
@@ -409,7 +441,7 @@ public:
 			_tail = prev_node;
 		}
 		prev_node->_next = next_node;
-		delete remove_node;
+		_destroy_node(remove_node);
 		--_size;
 		return Iterator(next_node, position.parent_list);
 	}
@@ -419,11 +451,26 @@ public:
 			return;
 		}
 
-		Node* current = _head;
-		while (current != nullptr) {
-			Node* next = current->_next;
-			delete current;
-			current = next;
+		if (NodeOps::can_release_all(this->_allocator(), _size)) {
+			//Every live block of the pool is one of our nodes: the values are destroyed
+			//and the chunks are dropped at once, the nodes are not freed one by one
+			if constexpr (!std::is_trivially_destructible_v<Node>) {
+				Node* current = _head;
+				while (current != nullptr) {
+					Node* next = current->_next;
+					current->~Node();
+					current = next;
+				}
+			}
+			NodeOps::release_all(this->_allocator(), _size);
+		}
+		else {
+			Node* current = _head;
+			while (current != nullptr) {
+				Node* next = current->_next;
+				_destroy_node(current);
+				current = next;
+			}
 		}
 
 		_head = nullptr;
@@ -446,6 +493,10 @@ public:
 		return _size == 0;
 	}
 
+	Alloc get_allocator() const {
+		return Alloc(this->_allocator());
+	}
+
 	size_t size() const {
 		return _size;
 	}
@@ -506,29 +557,40 @@ public:
 
 	List& operator=(const List& other) {
 		if (this != &other) {
-			if (!empty()) {
-				clear();
+			//Every node goes back to the allocator it came from before the allocator may change
+			clear();
+			NodeOps::on_copy_assignment(this->_allocator(), other._allocator());
+			for (Node* node = other._head; node != nullptr; node = node->_next) {
+				push_back(node->_data);
 			}
-			*this = List(other);
 		}
 		return *this;
 	}
 
-	List& operator=(List&& other) {
+	List& operator=(List&& other) noexcept(NodeOps::propagate_on_move || NodeOps::always_equal) {
 		if (this != &other) {
-			if (!empty()) {
-				clear();
+			clear();
+			if (!NodeOps::propagate_on_move && !NodeOps::equal(this->_allocator(), other._allocator())) {
+				//The nodes of other cannot be adopted, the values are moved into new nodes
+				for (Node* node = other._head; node; node = node->_next) {
+					push_back(std::move(node->_data));
+				}
+				other.clear();
+				return *this;
 			}
-			_head = other._head;
-			_tail = other._tail;
-			_size = other._size;
 
-			other._head = nullptr;
-			other._tail = nullptr;
-			other._size = 0;
+			NodeOps::on_move_assignment(this->_allocator(), other._allocator());
+			_steal(other);
 		}
 		return *this;
 	}
 
+	void swap(List& other) noexcept {
+		std::swap(_head, other._head);
+		std::swap(_tail, other._tail);
+		std::swap(_size, other._size);
+		NodeOps::on_swap(this->_allocator(), other._allocator());
+	}
+
 };
 
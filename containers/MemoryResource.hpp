@@ -0,0 +1,228 @@
+/*
+*  MemoryResource Documentation
+*
+*  Runtime-switchable memory for the containers, modelled on std::pmr.
+*  A PolymorphicAllocator<T> only holds a MemoryResource*, so Vector<int, PolymorphicAllocator<int>>
+*  is one type whatever resource it draws from: the resource is picked when the container is
+*  constructed, not when the program is compiled.
+*
+*  Key Features:
+*    - MemoryResource: abstract interface (allocate / deallocate / is_equal).
+*    - new_delete_resource(): ::operator new / ::operator delete, the default.
+*    - get_default_resource() / set_default_resource(): process-wide default used by
+*      default-constructed PolymorphicAllocators.
+*    - MonotonicResource: arena that hands out memory from growing chunks and frees
+*      everything at once in release() or in its destructor.
+*    - PolymorphicAllocator<T>: the allocator type to plug into any container.
+*
+*  Notes:
+*    - As with std::pmr, the allocator never propagates: copies of a container use the
+*      default resource, move assignment between different resources moves element by element.
+*    - MonotonicResource is not thread-safe, new_delete_resource() is.
+*    - A resource must outlive every container that uses it.
+*/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+
+class MemoryResource {
+public:
+	virtual ~MemoryResource() = default;
+
+	void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+		return do_allocate(bytes, alignment);
+	}
+
+	void deallocate(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+		do_deallocate(ptr, bytes, alignment);
+	}
+
+	//Memory allocated from one resource can be released through the other
+	bool is_equal(const MemoryResource& other) const noexcept {
+		return this == &other || do_is_equal(other);
+	}
+
+protected:
+	virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+	virtual void do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+
+	virtual bool do_is_equal(const MemoryResource&) const noexcept {
+		return false;
+	}
+};
+
+
+class NewDeleteResource : public MemoryResource {
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		if (alignment > alignof(std::max_align_t)) {
+			return ::operator new(bytes, std::align_val_t(alignment));
+		}
+		return ::operator new(bytes);
+	}
+
+	void do_deallocate(void* ptr, size_t, size_t alignment) override {
+		if (alignment > alignof(std::max_align_t)) {
+			::operator delete(ptr, std::align_val_t(alignment));
+			return;
+		}
+		::operator delete(ptr);
+	}
+
+	bool do_is_equal(const MemoryResource& other) const noexcept override {
+		return dynamic_cast<const NewDeleteResource*>(&other) != nullptr;
+	}
+};
+
+inline MemoryResource* new_delete_resource() noexcept {
+	static NewDeleteResource resource;
+	return &resource;
+}
+
+inline std::atomic<MemoryResource*>& _default_resource_slot() noexcept {
+	static std::atomic<MemoryResource*> slot(new_delete_resource());
+	return slot;
+}
+
+inline MemoryResource* get_default_resource() noexcept {
+	return _default_resource_slot().load();
+}
+
+//Replaces the default resource (nullptr restores new_delete_resource()), returns the previous one
+inline MemoryResource* set_default_resource(MemoryResource* resource) noexcept {
+	return _default_resource_slot().exchange(resource ? resource : new_delete_resource());
+}
+
+
+class MonotonicResource : public MemoryResource {
+private:
+	struct Chunk {
+		Chunk* next;
+		size_t bytes;
+	};
+
+	MemoryResource* _upstream;
+	Chunk* _chunks;         // Chunks obtained from upstream, newest first
+	char* _current;         // Free space of the newest chunk (or of the initial buffer)
+	size_t _left;
+	size_t _next_chunk_size;
+
+	void _grow(size_t bytes, size_t alignment) {
+		size_t needed = sizeof(Chunk) + bytes + alignment;
+		size_t chunk_bytes = _next_chunk_size < needed ? needed : _next_chunk_size;
+
+		Chunk* chunk = static_cast<Chunk*>(_upstream->allocate(chunk_bytes, alignof(std::max_align_t)));
+		chunk->next = _chunks;
+		chunk->bytes = chunk_bytes;
+		_chunks = chunk;
+
+		_current = reinterpret_cast<char*>(chunk + 1);
+		_left = chunk_bytes - sizeof(Chunk);
+		_next_chunk_size = chunk_bytes * 2;
+	}
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(_current) % alignment) % alignment;
+		if (!_current || padding + bytes > _left) {
+			_grow(bytes, alignment);
+			padding = (alignment - reinterpret_cast<std::uintptr_t>(_current) % alignment) % alignment;
+		}
+
+		char* result = _current + padding;
+		_current = result + bytes;
+		_left -= padding + bytes;
+		return result;
+	}
+
+	//Individual blocks are never returned, the memory is reclaimed by release()
+	void do_deallocate(void*, size_t, size_t) override {}
+
+public:
+	explicit MonotonicResource(size_t initial_chunk_size = 1024, MemoryResource* upstream = get_default_resource())
+		: _upstream(upstream), _chunks(nullptr), _current(nullptr), _left(0),
+		_next_chunk_size(initial_chunk_size > sizeof(Chunk) ? initial_chunk_size : 2 * sizeof(Chunk)) {}
+
+	//The first allocations are served from buffer (for example a local array), then from upstream
+	MonotonicResource(void* buffer, size_t buffer_size, MemoryResource* upstream = get_default_resource())
+		: _upstream(upstream), _chunks(nullptr), _current(static_cast<char*>(buffer)), _left(buffer_size),
+		_next_chunk_size(buffer_size > sizeof(Chunk) ? buffer_size * 2 : 1024) {}
+
+	MonotonicResource(const MonotonicResource&) = delete;
+	MonotonicResource& operator=(const MonotonicResource&) = delete;
+
+	~MonotonicResource() override {
+		release();
+	}
+
+	//Returns every chunk to upstream, all memory handed out so far becomes invalid
+	void release() {
+		while (_chunks) {
+			Chunk* next = _chunks->next;
+			_upstream->deallocate(_chunks, _chunks->bytes, alignof(std::max_align_t));
+			_chunks = next;
+		}
+		_current = nullptr;
+		_left = 0;
+	}
+
+	MemoryResource* upstream_resource() const {
+		return _upstream;
+	}
+};
+
+
+template<typename T>
+class PolymorphicAllocator {
+private:
+	MemoryResource* _resource;
+
+	template<typename U>
+	friend class PolymorphicAllocator;
+
+public:
+	using value_type = T;
+
+	PolymorphicAllocator() noexcept : _resource(get_default_resource()) {}
+	PolymorphicAllocator(MemoryResource* resource) noexcept : _resource(resource) {}
+	PolymorphicAllocator(const PolymorphicAllocator& other) = default;
+
+	template<typename U>
+	PolymorphicAllocator(const PolymorphicAllocator<U>& other) noexcept : _resource(other._resource) {}
+
+	//The resource is fixed for the lifetime of the allocator (and of its container)
+	PolymorphicAllocator& operator=(const PolymorphicAllocator&) = delete;
+
+	T* allocate(size_t count) {
+		if (count > SIZE_MAX / sizeof(T)) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(_resource->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* ptr, size_t count) {
+		_resource->deallocate(ptr, count * sizeof(T), alignof(T));
+	}
+
+	//A copy of a container does not inherit the resource, it uses the default one
+	PolymorphicAllocator select_on_container_copy_construction() const {
+		return PolymorphicAllocator();
+	}
+
+	MemoryResource* resource() const {
+		return _resource;
+	}
+
+	template<typename U>
+	bool operator==(const PolymorphicAllocator<U>& other) const noexcept {
+		return _resource->is_equal(*other._resource);
+	}
+
+	template<typename U>
+	bool operator!=(const PolymorphicAllocator<U>& other) const noexcept {
+		return !(*this == other);
+	}
+};
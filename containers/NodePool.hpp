@@ -0,0 +1,358 @@
+/*
+*  NodePool Documentation
+*
+*  NodePool is a slab allocator for blocks of one fixed size, PoolAllocator<T> plugs it
+*  into the node containers. It is the default allocator of List and AVLtree.
+*
+*  Key Features:
+*    - Blocks are cut from contiguous chunks: nodes allocated one after another are
+*      neighbours in memory instead of being scattered over the heap.
+*    - Freed blocks go to an intrusive free list (the link lives in the free block
+*      itself) and are handed out again first, allocate/deallocate are O(1).
+*    - release() returns every chunk at once in O(chunks), without visiting the blocks.
+*    - Chunks double in size (16 blocks first, 4096 at most), so small containers stay small.
+*
+*  PoolAllocator<T>:
+*    - A handle to a reference-counted NodePool. A default-constructed allocator owns
+*      nothing: the pool is created by the first allocation or by the first copy, and its
+*      block size is fixed by the first allocation.
+*    - Copies of an allocator, including rebound ones, share the pool and compare equal.
+*      Moving an allocator hands the pool over. A copy-constructed container gets a fresh
+*      allocator, so every container has a pool of its own.
+*    - Requests for more than one object, or for objects that do not fit the pool's
+*      block size, are passed to ::operator new.
+*    - Extension used by the containers (see AllocatorOps): live_blocks(), release() and
+*      pooled(). When all live blocks of the pool belong to one container, clearing it
+*      drops the chunks instead of freeing the nodes one by one. A container whose nodes
+*      do not fit the pool (another node type configured it) never does: its nodes come
+*      from ::operator new and the blocks it would count belong to someone else.
+*
+*  Notes:
+*    - Not thread-safe, including the reference count: a pool belongs to one thread.
+*    - Memory is returned to the system only by release() or when the last allocator
+*      sharing the pool is destroyed.
+*/
+#pragma once
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+
+class NodePool {
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct Chunk {
+		Chunk* next;
+		size_t bytes;
+	};
+
+	static constexpr size_t first_chunk_blocks = 16;
+	static constexpr size_t max_chunk_blocks = 4096;
+
+	size_t _block_size;
+	size_t _alignment;
+	size_t _header_size;        // Chunk header rounded up to the block alignment
+
+	Chunk* _chunks;             // Newest first
+	FreeBlock* _free;           // Blocks returned by deallocate()
+	char* _bump;                // Never used part of the newest chunk
+	char* _bump_end;
+	size_t _next_chunk_blocks;
+	size_t _chunk_count;
+	size_t _live;
+
+	static size_t _round_up(size_t value, size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	bool _over_aligned() const {
+		return _alignment > alignof(std::max_align_t);
+	}
+
+	void _add_chunk() {
+		size_t bytes = _header_size + _next_chunk_blocks * _block_size;
+		void* memory = _over_aligned()
+			? ::operator new(bytes, std::align_val_t(_alignment))
+			: ::operator new(bytes);
+
+		Chunk* chunk = static_cast<Chunk*>(memory);
+		chunk->next = _chunks;
+		chunk->bytes = bytes;
+		_chunks = chunk;
+		++_chunk_count;
+
+		_bump = static_cast<char*>(memory) + _header_size;
+		_bump_end = static_cast<char*>(memory) + bytes;
+		if (_next_chunk_blocks < max_chunk_blocks) {
+			_next_chunk_blocks *= 2;
+		}
+	}
+
+	void _free_chunk(Chunk* chunk) {
+		if (_over_aligned()) {
+			::operator delete(chunk, std::align_val_t(_alignment));
+		}
+		else {
+			::operator delete(chunk);
+		}
+	}
+
+public:
+	//A pool without a block size, configure() must be called before the first allocate()
+	NodePool() : _block_size(0), _alignment(0), _header_size(0),
+		_chunks(nullptr), _free(nullptr), _bump(nullptr), _bump_end(nullptr),
+		_next_chunk_blocks(first_chunk_blocks), _chunk_count(0), _live(0) {}
+
+	NodePool(size_t block_size, size_t alignment) : NodePool() {
+		configure(block_size, alignment);
+	}
+
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	~NodePool() {
+		release();
+	}
+
+	//Sets the block geometry, only allowed while the pool has no chunks
+	void configure(size_t block_size, size_t alignment) {
+		if (_chunks) {
+			throw std::logic_error("NodePool is already in use");
+		}
+		//A free block must hold the free-list link, and every block must stay aligned
+		_alignment = alignment < alignof(FreeBlock) ? alignof(FreeBlock) : alignment;
+		_block_size = _round_up(block_size < sizeof(FreeBlock) ? sizeof(FreeBlock) : block_size, _alignment);
+		_header_size = _round_up(sizeof(Chunk), _alignment);
+	}
+
+	bool configured() const {
+		return _block_size != 0;
+	}
+
+	void* allocate() {
+		void* block;
+		if (_free) {
+			block = _free;
+			_free = _free->next;
+		}
+		else {
+			if (_bump == _bump_end) {
+				_add_chunk();
+			}
+			block = _bump;
+			_bump += _block_size;
+		}
+		++_live;
+		return block;
+	}
+
+	void deallocate(void* block) noexcept {
+		FreeBlock* free_block = static_cast<FreeBlock*>(block);
+		free_block->next = _free;
+		_free = free_block;
+		--_live;
+	}
+
+	//Returns all chunks, every block handed out so far becomes invalid
+	void release() noexcept {
+		while (_chunks) {
+			Chunk* next = _chunks->next;
+			_free_chunk(_chunks);
+			_chunks = next;
+		}
+		_free = nullptr;
+		_bump = nullptr;
+		_bump_end = nullptr;
+		_next_chunk_blocks = first_chunk_blocks;
+		_chunk_count = 0;
+		_live = 0;
+	}
+
+	//True if a block of this pool can hold an object of the given size and alignment
+	bool fits(size_t size, size_t alignment) const {
+		return configured() && size <= _block_size && alignment <= _alignment;
+	}
+
+	size_t block_size() const {
+		return _block_size;
+	}
+
+	size_t chunk_count() const {
+		return _chunk_count;
+	}
+
+	//Blocks handed out and not yet returned
+	size_t live_blocks() const {
+		return _live;
+	}
+};
+
+
+//Pool shared by all copies of one PoolAllocator
+struct SharedNodePool {
+	size_t references = 1;
+	NodePool pool;
+};
+
+
+template<typename T>
+class PoolAllocator {
+private:
+	//Created on demand, also by copies of a const allocator
+	mutable SharedNodePool* _shared;
+
+	template<typename U>
+	friend class PoolAllocator;
+
+	//Copies must share the pool, so a copy of an allocator without one creates it first
+	SharedNodePool* _materialize() const {
+		if (!_shared) {
+			_shared = new SharedNodePool();
+		}
+		return _shared;
+	}
+
+	void _attach(SharedNodePool* shared) noexcept {
+		_shared = shared;
+		++_shared->references;
+	}
+
+	void _detach() noexcept {
+		if (_shared && --_shared->references == 0) {
+			delete _shared;
+		}
+		_shared = nullptr;
+	}
+
+	bool _pooled(size_t count) const {
+		return count == 1 && _shared && _shared->pool.fits(sizeof(T), alignof(T));
+	}
+
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	PoolAllocator() noexcept : _shared(nullptr) {}
+
+	PoolAllocator(const PoolAllocator& other) : _shared(nullptr) {
+		_attach(other._materialize());
+	}
+
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>& other) : _shared(nullptr) {
+		_attach(other._materialize());
+	}
+
+	PoolAllocator(PoolAllocator&& other) noexcept : _shared(other._shared) {
+		other._shared = nullptr;
+	}
+
+	template<typename U>
+	PoolAllocator(PoolAllocator<U>&& other) noexcept : _shared(other._shared) {
+		other._shared = nullptr;
+	}
+
+	PoolAllocator& operator=(const PoolAllocator& other) {
+		SharedNodePool* shared = other._materialize();
+		if (_shared != shared) {
+			_detach();
+			_attach(shared);
+		}
+		return *this;
+	}
+
+	PoolAllocator& operator=(PoolAllocator&& other) noexcept {
+		if (this != &other) {
+			_detach();
+			_shared = other._shared;
+			other._shared = nullptr;
+		}
+		return *this;
+	}
+
+	~PoolAllocator() {
+		_detach();
+	}
+
+	T* allocate(size_t count) {
+		if (count == 1) {
+			NodePool& pool = _materialize()->pool;
+			if (!pool.configured()) {
+				pool.configure(sizeof(T), alignof(T));
+			}
+		}
+		if (_pooled(count)) {
+			return static_cast<T*>(_shared->pool.allocate());
+		}
+
+		if constexpr (alignof(T) > alignof(std::max_align_t)) {
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+		}
+		else {
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+	}
+
+	void deallocate(T* ptr, size_t count) noexcept {
+		if (_pooled(count)) {
+			_shared->pool.deallocate(ptr);
+			return;
+		}
+
+		if constexpr (alignof(T) > alignof(std::max_align_t)) {
+			::operator delete(ptr, std::align_val_t(alignof(T)));
+		}
+		else {
+			::operator delete(ptr);
+		}
+	}
+
+	//A copied container gets a pool of its own
+	PoolAllocator select_on_container_copy_construction() const {
+		return PoolAllocator();
+	}
+
+	//Pool blocks currently in use (by every container sharing the pool)
+	size_t live_blocks() const {
+		return _shared ? _shared->pool.live_blocks() : 0;
+	}
+
+	//True if single objects of T are pool blocks
+	bool pooled() const {
+		return _pooled(1);
+	}
+
+	//Drops all chunks of the pool, see AllocatorOps::release_all()
+	void release() noexcept {
+		if (_shared) {
+			_shared->pool.release();
+		}
+	}
+
+	const NodePool* pool() const {
+		return _shared ? &_shared->pool : nullptr;
+	}
+
+	//An allocator without a pool is equal only to itself: it has not handed out
+	//anything yet, and its pool will not be anybody else's
+	template<typename U>
+	bool operator==(const PoolAllocator<U>& other) const noexcept {
+		if (!_shared) {
+			return static_cast<const void*>(this) == static_cast<const void*>(&other);
+		}
+		return _shared == other._shared;
+	}
+
+	template<typename U>
+	bool operator!=(const PoolAllocator<U>& other) const noexcept {
+		return !(*this == other);
+	}
+};
@@ -0,0 +1,144 @@
+/*
+*  ParallelSort Documentation
+*
+*  parallel_sort(first, last, comp) sorts a contiguous range with a stable merge sort
+*  whose halves run on separate std::threads near the top of the recursion.
+*  AVLtree uses it to sort unsorted input before a bulk build.
+*
+*  Key Features:
+*    - Stable: equal elements keep their order.
+*    - Up to threads tasks (std::thread::hardware_concurrency() by default), ranges
+*      below parallel_sort_cutoff elements are never split across threads.
+*    - Already ordered neighbouring runs are not merged, presorted input costs O(n).
+*    - An exception thrown by comp or by T in any thread is rethrown to the caller,
+*      the range then holds its elements in unspecified order.
+*
+*  Notes:
+*    - T must be move constructible and move assignable, comp is called from several
+*      threads at once.
+*    - Needs one scratch buffer of n elements (raw memory from Relocator<T>).
+*    - Link with -pthread.
+*/
+#pragma once
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <thread>
+#include <utility>
+#include "Relocate.hpp"
+
+
+inline constexpr size_t parallel_sort_cutoff = 8192;
+
+namespace parallel_sort_detail {
+
+	template<typename T, typename Compare>
+	void insertion_sort(T* data, size_t count, Compare& comp) {
+		for (size_t i = 1; i < count; ++i) {
+			if (!comp(data[i], data[i - 1])) {
+				continue;
+			}
+			T value(std::move(data[i]));
+			size_t j = i;
+			for (; j > 0 && comp(value, data[j - 1]); --j) {
+				data[j] = std::move(data[j - 1]);
+			}
+			data[j] = std::move(value);
+		}
+	}
+
+	//Merges [data, data + middle) and [data + middle, data + count) through the raw buffer
+	template<typename T, typename Compare>
+	void merge(T* data, size_t middle, size_t count, T* buffer, Compare& comp) {
+		size_t left = 0;
+		size_t right = middle;
+		size_t built = 0;
+		try {
+			while (left < middle && right < count) {
+				//Taking from the left on ties keeps the sort stable
+				T& next = comp(data[right], data[left]) ? data[right++] : data[left++];
+				new (&buffer[built]) T(std::move(next));
+				++built;
+			}
+			for (; left < middle; ++left, ++built) {
+				new (&buffer[built]) T(std::move(data[left]));
+			}
+			for (; right < count; ++right, ++built) {
+				new (&buffer[built]) T(std::move(data[right]));
+			}
+			for (size_t i = 0; i < count; ++i) {
+				data[i] = std::move(buffer[i]);
+			}
+		}
+		catch (...) {
+			for (size_t i = 0; i < built; ++i) {
+				buffer[i].~T();
+			}
+			throw;
+		}
+		for (size_t i = 0; i < count; ++i) {
+			buffer[i].~T();
+		}
+	}
+
+	//tasks is the number of threads this range may still use
+	template<typename T, typename Compare>
+	void merge_sort(T* data, size_t count, T* buffer, Compare& comp, size_t tasks) {
+		if (count <= 32) {
+			insertion_sort(data, count, comp);
+			return;
+		}
+
+		size_t middle = count / 2;
+		if (tasks > 1 && count >= parallel_sort_cutoff) {
+			std::exception_ptr error;
+			std::thread left_task([&] {
+				try {
+					merge_sort(data, middle, buffer, comp, tasks / 2);
+				}
+				catch (...) {
+					error = std::current_exception();
+				}
+			});
+			try {
+				merge_sort(data + middle, count - middle, buffer + middle, comp, tasks - tasks / 2);
+			}
+			catch (...) {
+				left_task.join();
+				throw;
+			}
+			left_task.join();
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+		else {
+			merge_sort(data, middle, buffer, comp, 1);
+			merge_sort(data + middle, count - middle, buffer + middle, comp, 1);
+		}
+
+		if (comp(data[middle], data[middle - 1])) {
+			merge(data, middle, count, buffer, comp);
+		}
+	}
+
+}
+
+
+template<typename T, typename Compare>
+void parallel_sort(T* first, T* last, Compare comp, size_t threads = std::thread::hardware_concurrency()) {
+	size_t count = last - first;
+	if (count < 2) {
+		return;
+	}
+
+	T* buffer = Relocator<T>::allocate(count);
+	try {
+		parallel_sort_detail::merge_sort(first, count, buffer, comp, threads == 0 ? 1 : threads);
+	}
+	catch (...) {
+		Relocator<T>::deallocate(buffer);
+		throw;
+	}
+	Relocator<T>::deallocate(buffer);
+}
@@ -0,0 +1,133 @@
+/*
+*  PathIterator Documentation
+*
+*  Forward iterator shared by the AVL trees whose nodes have no parent pointer
+*  (ConcurrentAVLtree, PersistentAVLtree): the nodes are shared between versions of the
+*  tree, so the way back up is kept on a fixed stack holding the path from the root.
+*
+*  Requirements for Node:
+*    - Node* left, right and T data
+*
+*  Notes:
+*    - Trees deeper than max_height are not supported; an AVL tree that fits in memory
+*      is far below it (height <= 1.44 log2(n + 2)).
+*    - Copying the iterator copies the path, it is meant for scans rather than for storage.
+*    - Stays valid as long as the version of the tree it walks is alive.
+*/
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+
+
+template<typename Node, typename T>
+class PathIterator {
+public:
+	static constexpr size_t max_height = 96;
+
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const T*;
+	using reference = const T&;
+
+private:
+	const Node* path[max_height];
+	size_t depth = 0;
+
+	void pushLeft(const Node* node) {
+		for (; node; node = node->left) {
+			path[depth++] = node;
+		}
+	}
+
+public:
+	PathIterator() = default;
+
+	PathIterator(const PathIterator& other) : depth(other.depth) {
+		for (size_t i = 0; i < depth; ++i) {
+			path[i] = other.path[i];
+		}
+	}
+
+	PathIterator& operator=(const PathIterator& other) {
+		depth = other.depth;
+		for (size_t i = 0; i < depth; ++i) {
+			path[i] = other.path[i];
+		}
+		return *this;
+	}
+
+	//Smallest element of the tree under root
+	static PathIterator first(const Node* root) {
+		PathIterator it;
+		it.pushLeft(root);
+		return it;
+	}
+
+	//First element not less than key (greater than key if upper), end if there is none
+	template<typename KeyOf, typename K, typename Compare>
+	static PathIterator bound(const Node* root, const K& key, bool upper, const Compare& comp) {
+		//The stack keeps the whole path, then is cut back to the last node passed on the left
+		PathIterator it;
+		size_t found = 0;
+		for (const Node* node = root; node;) {
+			it.path[it.depth++] = node;
+			bool right = upper ? !comp(key, KeyOf()(node->data)) : comp(KeyOf()(node->data), key);
+			if (right) {
+				node = node->right;
+			}
+			else {
+				found = it.depth;
+				node = node->left;
+			}
+		}
+		it.depth = found;
+		return it;
+	}
+
+	void is_valid() const {
+		if (depth == 0) {
+			throw std::runtime_error("Iterator equal nullptr");
+		}
+	}
+
+	const T& operator*() const {
+		is_valid();
+		return path[depth - 1]->data;
+	}
+
+	const T* operator->() const {
+		is_valid();
+		return &path[depth - 1]->data;
+	}
+
+	PathIterator& operator++() {
+		is_valid();
+		const Node* node = path[depth - 1];
+		if (node->right) {
+			pushLeft(node->right);
+			return *this;
+		}
+		//Climb while coming up from a right child
+		const Node* child = path[--depth];
+		while (depth > 0 && path[depth - 1]->right == child) {
+			child = path[--depth];
+		}
+		return *this;
+	}
+
+	PathIterator operator++(int) {
+		PathIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	bool operator==(const PathIterator& other) const {
+		return (depth ? path[depth - 1] : nullptr) == (other.depth ? other.path[other.depth - 1] : nullptr);
+	}
+
+	bool operator!=(const PathIterator& other) const {
+		return !(*this == other);
+	}
+};
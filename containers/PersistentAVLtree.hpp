@@ -0,0 +1,459 @@
+/*
+*  PersistentAVLtree Documentation
+*
+*  PersistentAVLtree<T, Compare> is an immutable ordered set: insert() and erase() leave
+*  the tree alone and return a new version. Versions share every subtree the change did not
+*  touch, so keeping the old versions around (history, rollback) costs O(log n) nodes per
+*  change instead of a full copy.
+*
+*  Key Features:
+*    - Copying a version is O(1), it only takes one more reference to the root.
+*    - insert() and erase() copy the path from the root to the changed node, O(log n)
+*      time and new nodes.
+*    - Nodes are reference-counted: a node is freed with the last version using it.
+*    - Called on an rvalue (std::move(version).insert(x)) the nodes no other version uses
+*      are changed in place, so building a tree in a loop allocates only its own nodes.
+*    - contains, find, lower_bound, upper_bound, rank and in-order iteration as in
+*      the AVLtree; iterators stay valid as long as their version is alive.
+*
+*  Implementation Notes:
+*    - Nodes have no parent pointer, a node may have parents in several versions.
+*    - A node with one reference belongs to the operation that holds it and is updated in
+*      place; a shared node is copied first (own()).
+*    - An insert() or erase() that throws leaves every version unchanged.
+*
+*  Limitations:
+*    - The reference counts are not atomic: versions that share nodes must not be
+*      copied or destroyed from several threads at once. The default PoolAllocator is not
+*      thread-safe either.
+*    - Equal elements are kept (as in AVLtree), erase(key) removes all of them.
+*/
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+#include "Allocator.hpp"
+#include "AVLtree.hpp"
+#include "NodePool.hpp"
+#include "PathIterator.hpp"
+
+
+template<typename T>
+struct PersistentAVLNode {
+	T data;
+	PersistentAVLNode* left = nullptr;
+	PersistentAVLNode* right = nullptr;
+	int height = 1;
+	size_t size = 1;
+	size_t references = 1;    // Parents and versions pointing here
+
+	template<typename... Args>
+	explicit PersistentAVLNode(std::in_place_t, Args&&... args) : data(std::forward<Args>(args)...) {}
+
+	//Copy for path copying, the caller accounts for the new references to the children
+	explicit PersistentAVLNode(const PersistentAVLNode& node) :
+		data(node.data), left(node.left), right(node.right), height(node.height), size(node.size) {}
+
+	static int heightOf(const PersistentAVLNode* node) {
+		return node ? node->height : 0;
+	}
+
+	static size_t sizeOf(const PersistentAVLNode* node) {
+		return node ? node->size : 0;
+	}
+
+	int balance() const {
+		return heightOf(right) - heightOf(left);
+	}
+
+	void update() {
+		height = (heightOf(left) > heightOf(right) ? heightOf(left) : heightOf(right)) + 1;
+		size = sizeOf(left) + sizeOf(right) + 1;
+	}
+};
+
+
+template<typename T, typename Compare = std::less<T>, typename Alloc = PoolAllocator<T>, typename KeyOf = AVLIdentity>
+class PersistentAVLtree : private AllocatorHolder<rebind_alloc_t<Alloc, PersistentAVLNode<T>>> {
+public:
+	using key_type = std::decay_t<decltype(KeyOf()(std::declval<const T&>()))>;
+	using value_type = T;
+
+private:
+	using Node = PersistentAVLNode<T>;
+	using NodeAlloc = rebind_alloc_t<Alloc, Node>;
+	using NodeOps = AllocatorOps<NodeAlloc>;
+	using Key = key_type;
+
+	template<typename K>
+	using LookupKey = std::conditional_t<is_transparent_compare<Compare>::value, K, Key>;
+
+	Node* root = nullptr;
+	Compare comp;
+
+	static const Key& keyOf(const T& value) {
+		return KeyOf()(value);
+	}
+
+	static Node* retain(Node* node) {
+		if (node) {
+			++node->references;
+		}
+		return node;
+	}
+
+	//Drops one reference, frees the nodes that have none left
+	void release(Node* node) {
+		while (node && --node->references == 0) {
+			release(node->left);
+			Node* right = node->right;
+			NodeOps::destroy(this->_allocator(), node);
+			node = right;
+		}
+	}
+
+	//Turns an owned reference into a node only the caller uses: the node itself if nobody
+	//else points to it, otherwise a copy. Changes nothing if the copy throws.
+	Node* own(Node* node) {
+		if (node->references == 1) {
+			return node;
+		}
+		Node* copy = NodeOps::create(this->_allocator(), *node);
+		retain(copy->left);
+		retain(copy->right);
+		--node->references;
+		return copy;
+	}
+
+	//Takes the reference node has to a child, node is about to go away
+	static Node* takeChild(Node* node, Node* Node::* side) {
+		Node* child = node->*side;
+		if (node->references == 1) {
+			node->*side = nullptr;
+			return child;
+		}
+		return retain(child);
+	}
+
+	//Rotations and balancing work on owned nodes, a child that moves is owned first.
+	//If one throws, the subtree is still consistent and is released by the caller.
+	Node* rotateRight(Node* node) {
+		node->left = own(node->left);
+		Node* left = node->left;
+		node->left = left->right;
+		left->right = node;
+		node->update();
+		left->update();
+		return left;
+	}
+
+	Node* rotateLeft(Node* node) {
+		node->right = own(node->right);
+		Node* right = node->right;
+		node->right = right->left;
+		right->left = node;
+		node->update();
+		right->update();
+		return right;
+	}
+
+	Node* balance(Node* node) {
+		node->update();
+		if (node->balance() < -1) {
+			if (node->left->balance() > 0) {
+				node->left = own(node->left);
+				node->left = rotateLeft(node->left);
+			}
+			return rotateRight(node);
+		}
+		if (node->balance() > 1) {
+			if (node->right->balance() < 0) {
+				node->right = own(node->right);
+				node->right = rotateRight(node->right);
+			}
+			return rotateLeft(node);
+		}
+		return node;
+	}
+
+	//The edits below take an owned reference to the subtree and return one to the new
+	//subtree; if they throw, the reference they were given is released.
+
+	//Equal elements go after the existing ones, as in AVLtree
+	Node* insertNode(Node* node, const T& value) {
+		if (!node) {
+			return NodeOps::create(this->_allocator(), std::in_place, value);
+		}
+		try {
+			node = own(node);
+			Node*& child = comp(keyOf(value), keyOf(node->data)) ? node->left : node->right;
+			Node* taken = child;
+			child = nullptr;
+			child = insertNode(taken, value);
+			return balance(node);
+		}
+		catch (...) {
+			release(node);
+			throw;
+		}
+	}
+
+	//Detaches the smallest node of the subtree into min, with no children
+	Node* removeMin(Node* node, Node*& min) {
+		try {
+			node = own(node);
+			if (!node->left) {
+				Node* right = node->right;
+				node->right = nullptr;
+				min = node;
+				return right;
+			}
+			Node* left = node->left;
+			node->left = nullptr;
+			node->left = removeMin(left, min);
+			return balance(node);
+		}
+		catch (...) {
+			release(node);
+			throw;
+		}
+	}
+
+	//Removes one element equal to key, which must be in the subtree
+	template<typename K>
+	Node* removeNode(Node* node, const K& key) {
+		bool less = comp(key, keyOf(node->data));
+		if (less || comp(keyOf(node->data), key)) {
+			try {
+				node = own(node);
+				Node*& child = less ? node->left : node->right;
+				Node* taken = child;
+				child = nullptr;
+				child = removeNode(taken, key);
+				return balance(node);
+			}
+			catch (...) {
+				release(node);
+				throw;
+			}
+		}
+
+		if (!node->left || !node->right) {
+			Node* child = takeChild(node, node->left ? &Node::left : &Node::right);
+			release(node);
+			return child;
+		}
+		//The in-order successor takes the place of node
+		Node* min = nullptr;
+		Node* right;
+		try {
+			right = removeMin(takeChild(node, &Node::right), min);
+		}
+		catch (...) {
+			release(min);
+			release(node);
+			throw;
+		}
+		min->left = takeChild(node, &Node::left);
+		min->right = right;
+		release(node);
+		try {
+			return balance(min);
+		}
+		catch (...) {
+			release(min);
+			throw;
+		}
+	}
+
+	template<typename K>
+	const Node* findNode(const K& key) const {
+		const Node* node = root;
+		while (node) {
+			if (comp(key, keyOf(node->data))) {
+				node = node->left;
+			}
+			else if (comp(keyOf(node->data), key)) {
+				node = node->right;
+			}
+			else {
+				return node;
+			}
+		}
+		return nullptr;
+	}
+
+	template<typename K>
+	size_t countBelow(const K& key, bool inclusive) const {
+		size_t result = 0;
+		for (const Node* node = root; node;) {
+			bool right = inclusive ? !comp(key, keyOf(node->data)) : comp(keyOf(node->data), key);
+			if (right) {
+				result += Node::sizeOf(node->left) + 1;
+				node = node->right;
+			}
+			else {
+				node = node->left;
+			}
+		}
+		return result;
+	}
+
+	static PersistentAVLtree withInsert(PersistentAVLtree version, const T& value) {
+		Node* top = version.root;
+		version.root = nullptr;
+		version.root = version.insertNode(top, value);
+		return version;
+	}
+
+	template<typename K>
+	static PersistentAVLtree withErase(PersistentAVLtree version, const K& key) {
+		size_t removed = version.countBelow(key, true) - version.countBelow(key, false);
+		for (size_t i = 0; i < removed; ++i) {
+			Node* top = version.root;
+			version.root = nullptr;
+			version.root = version.removeNode(top, key);
+		}
+		return version;
+	}
+
+public:
+	using allocator_type = Alloc;
+	using ConstIterator = PathIterator<Node, T>;
+
+	//Constructors and destructor
+	PersistentAVLtree() : AllocatorHolder<NodeAlloc>(NodeAlloc()) {}
+	explicit PersistentAVLtree(const Alloc& alloc) : AllocatorHolder<NodeAlloc>(NodeAlloc(alloc)) {}
+
+	PersistentAVLtree(std::initializer_list<T> init, const Alloc& alloc = Alloc()) :
+		PersistentAVLtree(init.begin(), init.end(), alloc) {}
+
+	template<typename InputIt>
+	PersistentAVLtree(InputIt first, InputIt last, const Alloc& alloc = Alloc()) : PersistentAVLtree(alloc) {
+		for (; first != last; ++first) {
+			*this = std::move(*this).insert(*first);
+		}
+	}
+
+	//Versions share their nodes, so they share the allocator as well
+	PersistentAVLtree(const PersistentAVLtree& other) :
+		AllocatorHolder<NodeAlloc>(other._allocator()), root(retain(other.root)), comp(other.comp) {}
+
+	PersistentAVLtree(PersistentAVLtree&& other) noexcept :
+		AllocatorHolder<NodeAlloc>(std::move(other._allocator())), root(other.root), comp(std::move(other.comp)) {
+		other.root = nullptr;
+	}
+
+	PersistentAVLtree& operator=(const PersistentAVLtree& other) {
+		if (this != &other) {
+			PersistentAVLtree copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	PersistentAVLtree& operator=(PersistentAVLtree&& other) noexcept {
+		if (this != &other) {
+			PersistentAVLtree moved(std::move(other));
+			swap(moved);
+		}
+		return *this;
+	}
+
+	~PersistentAVLtree() {
+		release(root);
+	}
+
+	void swap(PersistentAVLtree& other) noexcept {
+		using std::swap;
+		swap(this->_allocator(), other._allocator());
+		swap(root, other.root);
+		swap(comp, other.comp);
+	}
+
+	//New version with value added, this one is unchanged
+	PersistentAVLtree insert(const T& value) const & {
+		return withInsert(*this, value);
+	}
+
+	//Same, reusing the nodes of this version that no other version shares
+	PersistentAVLtree insert(const T& value) && {
+		return withInsert(std::move(*this), value);
+	}
+
+	//New version without the elements equal to key
+	template<typename K = Key>
+	PersistentAVLtree erase(const K& key) const & {
+		const LookupKey<K>& lookup = key;
+		return withErase(*this, lookup);
+	}
+
+	template<typename K = Key>
+	PersistentAVLtree erase(const K& key) && {
+		const LookupKey<K>& lookup = key;
+		return withErase(std::move(*this), lookup);
+	}
+
+	//Lookup
+	template<typename K = Key>
+	bool contains(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return findNode(lookup) != nullptr;
+	}
+
+	//An element equal to key, nullptr if there is none
+	template<typename K = Key>
+	const T* find(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		const Node* node = findNode(lookup);
+		return node ? &node->data : nullptr;
+	}
+
+	//First element not less than key (greater than key for upper_bound), end() if none
+	template<typename K = Key>
+	ConstIterator lower_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator::template bound<KeyOf>(root, lookup, false, comp);
+	}
+
+	template<typename K = Key>
+	ConstIterator upper_bound(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return ConstIterator::template bound<KeyOf>(root, lookup, true, comp);
+	}
+
+	//Number of elements less than key
+	template<typename K = Key>
+	size_t rank(const K& key) const {
+		const LookupKey<K>& lookup = key;
+		return countBelow(lookup, false);
+	}
+
+	//Whether both versions have the same root node: then they hold the same elements
+	bool same_version(const PersistentAVLtree& other) const {
+		return root == other.root;
+	}
+
+	size_t size() const {
+		return Node::sizeOf(root);
+	}
+
+	bool empty() const {
+		return root == nullptr;
+	}
+
+	Alloc get_allocator() const {
+		return Alloc(this->_allocator());
+	}
+
+	ConstIterator begin() const {
+		return ConstIterator::first(root);
+	}
+
+	ConstIterator end() const {
+		return ConstIterator();
+	}
+
+};
@@ -13,7 +13,7 @@
 *
 *  Requirements for Type T:
 *    - Copy constructor
-*    - Copy assignment operator
+*    - Move constructor and move assignment (used by pop)
 *    - Destructor (implicitly used)
 *
 *  Implementation Notes:
@@ -21,6 +21,10 @@
 *    - Explicit destructor calls during pop operations
 *    - Self-assignment safe operators
 *    - Move operations leave source in valid empty state
+*    - Default-constructed and moved-from queues own no memory until the first push
+*    - Storage is raw memory from Alloc (Allocator<T> by default), elements are built
+*      with placement new, so T needs no default constructor
+*    - Copy/move assignment follow the propagate_on_container_* traits of Alloc
 *
 *  Limitations:
 *    - No iterator support
@@ -30,54 +34,97 @@
 #pragma once
 #include <stdexcept>
 #include <initializer_list>
+#include <new>
+#include <utility>
+#include "Allocator.hpp"
 
 
-template<typename T>
-class Queue {
+template<typename T, typename Alloc = Allocator<T>>
+class Queue : private AllocatorHolder<Alloc> {
 private:
+	using Ops = AllocatorOps<Alloc>;
+
 	size_t _size;
 	size_t _capacity;
 	T* _data;
-public:
-	//Constructor and destructor
-	Queue() : _size(0), _capacity(10), _data(new T[_capacity]) {}
-	Queue(size_t capacity) : _size(0), _capacity(capacity > 10 ? capacity : 10), _data(new T[_capacity]) {}
-	Queue(const Queue& other) : _size(other._size), _capacity(other._capacity), _data(new T[_capacity]) {
-		for (size_t i = 0; i < _size;++i) {
-			_data[i] = other._data[i];
+
+	//Destroys the elements and returns the buffer to the allocator
+	void _release() {
+		for (size_t i = 0; i < _size; ++i) {
+			_data[i].~T();
 		}
+		Ops::deallocate(this->_allocator(), _data, _capacity);
 	}
-	Queue(Queue&& other) noexcept : _size(other._size), _capacity(other._capacity), _data(other._data) {
-		other._size = 0;
-		other._capacity = 10;
+
+	//Copy-constructs the elements of [first, first + count) behind the current ones
+	void _append_copies(const T* first, size_t count) {
+		for (size_t i = 0; i < count; ++i) {
+			new (&_data[_size]) T(first[i]);
+			++_size;
+		}
+	}
+
+	//Takes the buffer of other, the allocators must be equal
+	void _steal(Queue& other) noexcept {
+		_data = other._data;
+		_size = other._size;
+		_capacity = other._capacity;
+
 		other._data = nullptr;
+		other._size = 0;
+		other._capacity = 0;
+	}
+
+	void _swap_storage(Queue& other) noexcept {
+		std::swap(_size, other._size);
+		std::swap(_capacity, other._capacity);
+		std::swap(_data, other._data);
 	}
-	Queue(std::initializer_list<T> init) : _size(init.size()), _capacity(init.size() > 10 ? init.size() * 2 : 10), \
-		_data(new T[_capacity]) {
 
-		size_t i = 0;
+public:
+	using allocator_type = Alloc;
+
+	//Constructor and destructor
+	//No memory is allocated until the first push
+	Queue() : Queue(Alloc()) {}
+	explicit Queue(const Alloc& alloc) : AllocatorHolder<Alloc>(alloc), _size(0), _capacity(0), _data(nullptr) {}
+	Queue(size_t capacity, const Alloc& alloc = Alloc()) : AllocatorHolder<Alloc>(alloc), _size(0),
+		_capacity(capacity > 10 ? capacity : 10), _data(Ops::allocate(this->_allocator(), _capacity)) {}
+	Queue(const Queue& other) : Queue(other, Ops::copy_for_container(other._allocator())) {}
+	Queue(const Queue& other, const Alloc& alloc) : AllocatorHolder<Alloc>(alloc), _size(0), _capacity(other._capacity),
+		_data(Ops::allocate(this->_allocator(), _capacity)) {
 		try {
-			for (const auto& it : init) {
-				_data[i] = it;
-				++i;
-			}
+			_append_copies(other._data, other._size);
 		}
 		catch (...) {
-			delete[] _data;
+			_release();
+			throw;
+		}
+	}
+	Queue(Queue&& other) noexcept : AllocatorHolder<Alloc>(other._allocator()) {
+		_steal(other);
+	}
+	Queue(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : AllocatorHolder<Alloc>(alloc), _size(0),
+		_capacity(init.size() > 10 ? init.size() * 2 : 10), _data(Ops::allocate(this->_allocator(), _capacity)) {
+		try {
+			_append_copies(init.begin(), init.size());
+		}
+		catch (...) {
+			_release();
 			throw;
 		}
 	}
 	~Queue() {
-		delete[] _data;
+		_release();
 	}
 
 	//Main functions
 	void push(const T& value) {
 		if (_size + 1 >= _capacity) {
-			reserve((_size + 1) * 2);
+			reserve(_capacity == 0 ? 10 : (_size + 1) * 2);
 		}
 
-		_data[_size] = value;
+		new (&_data[_size]) T(value);
 		++_size;
 	}
 
@@ -85,8 +132,9 @@ public:
 		if (empty()) { throw std::out_of_range("Queue is empty"); }
 		
 		for (size_t i = 0; i < _size - 1; ++i) {
-			_data[i] = _data[i + 1];
+			_data[i] = std::move(_data[i + 1]);
 		}
+		_data[_size - 1].~T();
 		--_size;
 	}
 
@@ -121,43 +169,51 @@ public:
 	void reserve(size_t new_capacity) {
 		if (new_capacity <= _capacity) { return; }
 
-		T* new_data = new T[new_capacity];
-
-		for (size_t i = 0; i < _size; ++i) {
-			new_data[i] = _data[i];
-		}
-
-		delete[] _data;
-		_data = new_data;
+		_data = Ops::reallocate(this->_allocator(), _data, _size, _capacity, new_capacity);
 		_capacity = new_capacity;
 	}
 
+	Alloc get_allocator() const {
+		return this->_allocator();
+	}
+
 	//Operators
 	Queue& operator=(const Queue& other) {
 		if (this != &other) {
-			_size = other._size;
-			_capacity = other._capacity;
-
-			delete[] _data;
-			_data = new T[_capacity];
-			for (size_t i = 0; i < _size; ++i) {
-				_data[i] = other._data[i];
+			if (Ops::propagate_on_copy && !Ops::equal(this->_allocator(), other._allocator())) {
+				//The old buffer goes back to the allocator it came from
+				_release();
+				_data = nullptr;
+				_size = 0;
+				_capacity = 0;
 			}
+			Ops::on_copy_assignment(this->_allocator(), other._allocator());
+
+			Queue tmp(other, this->_allocator());
+			_swap_storage(tmp);
 		}
 		return *this;
 	}
 
-	Queue& operator=(Queue&& other) {
+	Queue& operator=(Queue&& other) noexcept(Ops::propagate_on_move || Ops::always_equal) {
 		if (this != &other) {
-			delete[] _data;
-
-			_data = other._data;
-			_size = other._size;
-			_capacity = other._capacity;
+			if (!Ops::propagate_on_move && !Ops::equal(this->_allocator(), other._allocator())) {
+				//The buffer of other cannot be adopted, the elements are moved one by one
+				Queue tmp(other._size, this->_allocator());
+				for (; tmp._size < other._size; ++tmp._size) {
+					new (&tmp._data[tmp._size]) T(std::move(other._data[tmp._size]));
+				}
+				other._release();
+				other._data = nullptr;
+				other._size = 0;
+				other._capacity = 0;
+				_swap_storage(tmp);
+				return *this;
+			}
 
-			other._data = nullptr;
-			other._size = 0;
-			other._capacity = 0;
+			_release();
+			Ops::on_move_assignment(this->_allocator(), other._allocator());
+			_steal(other);
 		}
 		return *this;
 	}
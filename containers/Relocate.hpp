@@ -0,0 +1,116 @@
+/*
+*  Relocation Documentation
+*
+*  Relocator<T> is the shared memory layer behind the default Allocator<T> (Allocator.hpp):
+*  it obtains raw element buffers and moves elements into a bigger (or smaller) buffer.
+*  relocate() is also used directly by the containers whatever their allocator is.
+*
+*  Key Features:
+*    - Raw (uninitialized) buffers, no constructor calls for unused capacity.
+*    - Trivially relocatable types are moved with a single memcpy.
+*    - Trivially relocatable buffers are grown with std::realloc, which can extend
+*      the block in place (or remap it on Linux) instead of copying.
+*    - Other types are moved one by one: move constructor + destructor.
+*
+*  Trivial relocation:
+*    "Relocating" means moving an object to a new address and ending the lifetime
+*    of the old one. For trivially copyable types this is exactly a memcpy.
+*    Many other types (for example String, which only owns a pointer) can also be
+*    relocated bytewise, they opt in by specializing the trait:
+*
+*        template<>
+*        struct is_trivially_relocatable<MyType> : std::true_type {};
+*
+*  Notes:
+*    - Buffers of trivially relocatable types come from std::malloc, all others from
+*      ::operator new. Always release a buffer through the same Relocator<T>.
+*    - Over-aligned types never use realloc, malloc does not guarantee their alignment.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+template<typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template<typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+
+template<typename T>
+struct Relocator {
+	static constexpr bool trivial = is_trivially_relocatable_v<T>;
+	static constexpr bool over_aligned = alignof(T) > alignof(std::max_align_t);
+	//realloc keeps only the malloc alignment, so it is used only for suitably aligned types
+	static constexpr bool use_realloc = trivial && !over_aligned;
+
+	static T* allocate(size_t count) {
+		if (count == 0) { return nullptr; }
+
+		if constexpr (use_realloc) {
+			void* ptr = std::malloc(count * sizeof(T));
+			if (!ptr) { throw std::bad_alloc(); }
+			return static_cast<T*>(ptr);
+		}
+		else if constexpr (over_aligned) {
+			return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+		}
+		else {
+			return static_cast<T*>(::operator new(count * sizeof(T)));
+		}
+	}
+
+	static void deallocate(T* ptr) {
+		if constexpr (use_realloc) {
+			std::free(ptr);
+		}
+		else if constexpr (over_aligned) {
+			::operator delete(ptr, std::align_val_t(alignof(T)));
+		}
+		else {
+			::operator delete(ptr);
+		}
+	}
+
+	//Moves count elements from src into raw memory dst, the objects in src are ended.
+	//The ranges must not overlap.
+	static void relocate(T* src, size_t count, T* dst) {
+		if (count == 0) { return; }
+
+		if constexpr (trivial) {
+			std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+		}
+		else {
+			for (size_t i = 0; i < count; ++i) {
+				new (&dst[i]) T(std::move(src[i]));
+				src[i].~T();
+			}
+		}
+	}
+
+	//Returns a buffer of new_capacity slots holding the first size elements of data.
+	//data is released (or reused by realloc), size must not exceed new_capacity.
+	static T* reallocate(T* data, size_t size, size_t new_capacity) {
+		if (new_capacity == 0) {
+			deallocate(data);
+			return nullptr;
+		}
+
+		if constexpr (use_realloc) {
+			void* ptr = std::realloc(static_cast<void*>(data), new_capacity * sizeof(T));
+			if (!ptr) { throw std::bad_alloc(); }
+			return static_cast<T*>(ptr);
+		}
+		else {
+			T* new_data = allocate(new_capacity);
+			relocate(data, size, new_data);
+			deallocate(data);
+			return new_data;
+		}
+	}
+};
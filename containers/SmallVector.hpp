@@ -0,0 +1,429 @@
+/*
+*  SmallVector Documentation
+*
+*  SmallVector<T, N> is a Vector with room for N elements inside the object itself.
+*  Up to N elements no heap memory is used at all, the first insertion beyond N
+*  moves the elements to a heap buffer and from then on it behaves like Vector.
+*
+*  Key Features:
+*    - Same interface as Vector (iterators, emplace, insert/erase, reserve, ...).
+*    - Zero allocations for containers that stay small.
+*    - Heap buffers come from Alloc (Allocator<T> by default: memcpy/realloc growth
+*      for relocatable T). The inline buffer never involves the allocator.
+*    - Move semantics for both states: a heap buffer is stolen, inline elements
+*      are moved one by one (they live inside the source object).
+*
+*  Notes:
+*    - Iterators are invalidated by spilling to the heap and by moving the container.
+*    - shrink_to_fit() returns to the inline buffer when the elements fit into it.
+*    - Pick N so that sizeof(SmallVector) still fits where it is stored: the inline
+*      buffer makes the object N * sizeof(T) bytes bigger.
+*    - Not thread-safe.
+*/
+
+/*
+*  type T must have :
+*   - copy constructor
+*   - move constructor
+*   - operator = (copy and move)
+*/
+#pragma once
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "Relocate.hpp"
+#include "Allocator.hpp"
+#include "Config.hpp"
+#include "ContiguousIterator.hpp"
+
+
+template <typename T, size_t N, typename Alloc = Allocator<T>>
+class SmallVector : private AllocatorHolder<Alloc> {
+    static_assert(N > 0, "SmallVector needs at least one inline slot, use Vector otherwise");
+
+private:
+    using Ops = AllocatorOps<Alloc>;
+
+    size_t _capacity;
+    size_t _size;
+    T* _data;
+    alignas(T) unsigned char _inline[N * sizeof(T)];
+
+    T* _inline_data() {
+        return reinterpret_cast<T*>(_inline);
+    }
+
+    static void _destroy(T* first, T* last) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (; first != last; ++first) {
+                first->~T();
+            }
+        }
+    }
+
+    //Releases the heap buffer (if any), the elements must already be destroyed or relocated
+    void _free_heap() {
+        if (!is_inline()) {
+            Ops::deallocate(this->_allocator(), _data, _capacity);
+        }
+    }
+
+    //Moves the elements into a buffer of new_capacity slots, new_capacity >= _size.
+    //Fitting into N slots means the inline buffer.
+    void _reallocate(size_t new_capacity) {
+        if (new_capacity <= N) {
+            if (is_inline()) { return; }
+            T* heap = _data;
+            Relocator<T>::relocate(heap, _size, _inline_data());
+            Ops::deallocate(this->_allocator(), heap, _capacity);
+            _data = _inline_data();
+            _capacity = N;
+            return;
+        }
+
+        if (is_inline()) {
+            T* heap = Ops::allocate(this->_allocator(), new_capacity);
+            Relocator<T>::relocate(_data, _size, heap);
+            _data = heap;
+        }
+        else {
+            _data = Ops::reallocate(this->_allocator(), _data, _size, _capacity, new_capacity);
+        }
+        _capacity = new_capacity;
+    }
+
+    //Takes the elements of other, other is left empty and inline.
+    //A heap buffer is adopted, so the allocators must be equal.
+    void _steal(SmallVector& other) {
+        if (other.is_inline()) {
+            _data = _inline_data();
+            _capacity = N;
+            Relocator<T>::relocate(other._data, other._size, _data);
+        }
+        else {
+            _data = other._data;
+            _capacity = other._capacity;
+        }
+        _size = other._size;
+
+        other._data = other._inline_data();
+        other._capacity = N;
+        other._size = 0;
+    }
+
+    void _copy_from(const T* src, size_t count) {
+        reserve(count);
+        for (; _size < count; ++_size) {
+            new (&_data[_size]) T(src[_size]);
+        }
+    }
+
+public:
+    using allocator_type = Alloc;
+
+    //Constructor and destructor
+    SmallVector() : SmallVector(Alloc()) {}
+
+    explicit SmallVector(const Alloc& alloc)
+        : AllocatorHolder<Alloc>(alloc), _capacity(N), _size(0), _data(_inline_data()) {}
+
+    //The delegated constructor has finished, so if a copy throws the destructor cleans up
+    SmallVector(const SmallVector& other) : SmallVector(other, Ops::copy_for_container(other._allocator())) {}
+
+    SmallVector(const SmallVector& other, const Alloc& alloc) : SmallVector(alloc) {
+        _copy_from(other._data, other._size);
+    }
+
+    //Inline elements are moved one by one, so this throws only if moving a T can throw
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : SmallVector(other._allocator()) {
+        _steal(other);
+    }
+
+    SmallVector(std::initializer_list<T> init, const Alloc& alloc = Alloc()) : SmallVector(alloc) {
+        _copy_from(init.begin(), init.size());
+    }
+
+    ~SmallVector() {
+        _destroy(_data, _data + _size);
+        _free_heap();
+    }
+
+    //--------------------------------- I T E R A T O R -----------------------------------
+    using CheckedIterator = ContiguousIterator<SmallVector, T>;
+
+    //Bounds-checked iterator in checked mode, raw pointer otherwise (see Config.hpp)
+    using Iterator = std::conditional_t<containers_checked, CheckedIterator, T*>;
+
+private:
+    Iterator _make_iterator(T* ptr) {
+        if constexpr (containers_checked) {
+            return Iterator(*this, ptr);
+        }
+        else {
+            return ptr;
+        }
+    }
+
+public:
+    //-------------------------------------------------------------------------------------
+
+    const T& at(size_t index) const {
+        if (index >= _size) { throw std::out_of_range("Index out of range"); }
+        return _data[index];
+    }
+
+    const T& back() const {
+        if (empty()) { throw std::out_of_range("SmallVector is empty"); }
+        return _data[_size - 1];
+    }
+
+    Iterator begin() {
+        return _make_iterator(_data);
+    }
+
+    size_t capacity() const {
+        return _capacity;
+    }
+
+    void clear() {
+        _destroy(_data, _data + _size);
+        _size = 0;
+    }
+
+    T* data() {
+        return _data;
+    }
+
+    const T* data() const {
+        return _data;
+    }
+
+    //True while the elements live in the inline buffer
+    bool is_inline() const {
+        return _data == reinterpret_cast<const T*>(_inline);
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (_size == _capacity) {
+            //args may refer to an element of this container, so the object is built
+            //before the elements are moved away
+            T value(std::forward<Args>(args)...);
+            _reallocate(_capacity * 2);
+            new (&_data[_size]) T(std::move(value));
+            return _data[_size++];
+        }
+
+        new (&_data[_size]) T(std::forward<Args>(args)...);
+        return _data[_size++];
+    }
+
+    template<typename... Args>
+    Iterator emplace(const Iterator position, Args&&... args) {
+        if (position < begin() || position > end()) {
+            throw std::out_of_range("Iterator out of bounds");
+        }
+
+        size_t pos_index = position - begin();
+        if (pos_index == _size) {
+            emplace_back(std::forward<Args>(args)...);
+            return _make_iterator(_data + pos_index);
+        }
+
+        T value(std::forward<Args>(args)...);
+        if (_size == _capacity) {
+            _reallocate(_capacity * 2);
+        }
+
+        new (&_data[_size]) T(std::move(_data[_size - 1]));
+        for (size_t i = _size - 1; i > pos_index; --i) {
+            _data[i] = std::move(_data[i - 1]);
+        }
+
+        _data[pos_index] = std::move(value);
+        ++_size;
+        return _make_iterator(_data + pos_index);
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    Iterator end() {
+        return _make_iterator(_data + _size);
+    }
+
+    Alloc get_allocator() const {
+        return this->_allocator();
+    }
+
+    void erase(const Iterator& first, const Iterator& last) {
+        if (first < begin() || first >= end() || first > last) {
+            throw std::out_of_range("Iterator out of bounds");
+        }
+
+        size_t first_index = first - begin();
+        size_t difference = last - first;
+
+        for (size_t i = first_index + difference; i < _size; ++i) {
+            _data[i - difference] = std::move(_data[i]);
+        }
+        _destroy(_data + _size - difference, _data + _size);
+
+        _size -= difference;
+    }
+
+    void erase(const Iterator& position) {
+        if (position < begin() || position >= end()) {
+            throw std::out_of_range("Iterator out of bounds");
+        }
+
+        size_t index = position - begin();
+        for (size_t i = index; i < _size - 1; ++i) {
+            _data[i] = std::move(_data[i + 1]);
+        }
+
+        _data[_size - 1].~T();
+        --_size;
+    }
+
+    T& front() {
+        if (empty()) { throw std::out_of_range("SmallVector is empty"); }
+        return _data[0];
+    }
+
+    const T& front() const {
+        if (empty()) { throw std::out_of_range("SmallVector is empty"); }
+        return _data[0];
+    }
+
+    void insert(const T& element, const Iterator position) {
+        emplace(position, element);
+    }
+
+    void insert(T&& element, const Iterator position) {
+        emplace(position, std::move(element));
+    }
+
+    void pop_back() {
+        if (!empty()) {
+            _data[_size - 1].~T();
+            --_size;
+        }
+    }
+
+    void push_back(const T& element) {
+        emplace_back(element);
+    }
+
+    void push_back(T&& element) {
+        emplace_back(std::move(element));
+    }
+
+    void reserve(size_t new_capacity) {
+        if (new_capacity <= _capacity) { return; }
+        _reallocate(new_capacity);
+    }
+
+    void resize(size_t new_size, const T& default_value = T()) {
+        if (new_size < _size) {
+            _destroy(_data + new_size, _data + _size);
+            _size = new_size;
+            return;
+        }
+
+        if (new_size > _capacity) {
+            //default_value may live in the old buffer
+            T value(default_value);
+            reserve(new_size);
+            for (; _size < new_size; ++_size) {
+                new (&_data[_size]) T(value);
+            }
+            return;
+        }
+        for (; _size < new_size; ++_size) {
+            new (&_data[_size]) T(default_value);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (is_inline() || _capacity == _size) { return; }
+        _reallocate(_size);
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    //Inline elements cannot change owner by a pointer swap, so this is three moves.
+    //The allocators travel with the moves (propagate_on_container_move_assignment).
+    void swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T> && (Ops::propagate_on_move || Ops::always_equal)) {
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    //------------------------------- O P E R A T O R S -------------------------------------------------
+
+    const T& operator[](size_t index) const {
+        if constexpr (containers_checked) {
+            if (index >= _size) {
+                throw std::out_of_range("Index out of bounds");
+            }
+        }
+        return _data[index];
+    }
+
+    T& operator[](size_t index) {
+        if constexpr (containers_checked) {
+            if (index >= _size) {
+                throw std::out_of_range("Index out of bounds");
+            }
+        }
+        return _data[index];
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            if (Ops::propagate_on_copy && !Ops::equal(this->_allocator(), other._allocator())) {
+                //The old heap buffer goes back to the allocator it came from
+                clear();
+                _free_heap();
+                _data = _inline_data();
+                _capacity = N;
+            }
+            Ops::on_copy_assignment(this->_allocator(), other._allocator());
+
+            SmallVector temp(other, this->_allocator());
+            *this = std::move(temp);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& right) noexcept(std::is_nothrow_move_constructible_v<T> && (Ops::propagate_on_move || Ops::always_equal)) {
+        if (this != &right) {
+            _destroy(_data, _data + _size);
+            _size = 0;
+
+            if (!Ops::propagate_on_move && !right.is_inline()
+                && !Ops::equal(this->_allocator(), right._allocator())) {
+                //The heap buffer of right cannot be adopted, the elements are relocated instead
+                reserve(right._size);
+                Relocator<T>::relocate(right._data, right._size, _data);
+                _size = right._size;
+                right._size = 0;
+                return *this;
+            }
+
+            _free_heap();
+            Ops::on_move_assignment(this->_allocator(), right._allocator());
+            _steal(right);
+        }
+        return *this;
+    }
+
+};
@@ -14,6 +14,10 @@
 *      default constructor calls for unused elements.
 *    - Memory is deallocated via ::operator delete(), which does not invoke destructors
 *      (they are called manually).
+*    - Both go through the Alloc template parameter. The default Allocator<T> uses
+*      Relocator<T> (Relocate.hpp): trivially relocatable types get malloc'ed buffers
+*      that grow with realloc, everything else uses ::operator new.
+*    - Copy/move assignment and swap follow the propagate_on_container_* traits of Alloc.
 *
 * 2. Placement New:
 *    - Objects are constructed in pre-allocated memory using the syntax: new (address) T(args).
@@ -31,6 +35,7 @@
 * - Does not use new[]/delete[], providing full control over object lifecycles.
 * - Does not require T to have a default constructor.
 * - Optimized for scenarios where the stack size changes frequently.
+* - A default-constructed or moved-from Stack owns no memory, the first push allocates.
 
 * Limitations:
 * ------------
@@ -41,42 +46,77 @@
 #include <stdexcept>
 #include <initializer_list>
 #include <cstring>
+#include "Relocate.hpp"
+#include "Allocator.hpp"
 
-template<typename T>
-class Stack{
+template<typename T, typename Alloc = Allocator<T>>
+class Stack : private AllocatorHolder<Alloc> {
 private:
+    using Ops = AllocatorOps<Alloc>;
+
     //the fields are in this order because the initialization sequence is important
     //fields are initialized in the order they are declared in the class,
     // not in the order they are listed in the constructor's initialization list
 	size_t _size;
 	size_t _capacity;
     T* _data;
-public:
-    //Constructor and destructor
-    Stack() : _size(0), _capacity(10), _data(static_cast<T*>(::operator new(_capacity * sizeof(T)))) {}
-	Stack(size_t capacity) :
-        _size(0), _capacity(capacity),
-        _data(static_cast<T*>(::operator new(_capacity * sizeof(T)))) {}
-    Stack(const Stack& other) 
-        : _size(other._size), _capacity(other._capacity) {
-        _data = static_cast<T*>(::operator new(_capacity * sizeof(T)));
 
+    //Destroys the elements and returns the buffer to the allocator
+    void _release() {
         for (size_t i = 0; i < _size; ++i) {
-            new (&_data[i]) T(other._data[i]);
+            _data[i].~T();
         }
+        Ops::deallocate(this->_allocator(), _data, _capacity);
     }
-    Stack(Stack&& other) noexcept {
+
+    //Takes the buffer of other, the allocators must be equal
+    void _steal(Stack& other) noexcept {
         _data = other._data;
         _size = other._size;
         _capacity = other._capacity;
 
         other._data = nullptr;
         other._size = 0;
-        other._capacity = 1;
+        other._capacity = 0;
+    }
+
+    void _swap_storage(Stack& other) noexcept {
+        std::swap(_size, other._size);
+        std::swap(_capacity, other._capacity);
+        std::swap(_data, other._data);
     }
-    Stack(std::initializer_list<T> init)
-        : _size(init.size()), _capacity(init.size() > 10 ? init.size() * 2 : 10),
-        _data(static_cast<T*>(::operator new(_capacity * sizeof(T))))  //creating raw memory
+
+public:
+    using allocator_type = Alloc;
+
+    //Constructor and destructor
+    //No memory is allocated until the first push
+    Stack() : Stack(Alloc()) {}
+    explicit Stack(const Alloc& alloc) : AllocatorHolder<Alloc>(alloc), _size(0), _capacity(0), _data(nullptr) {}
+	Stack(size_t capacity, const Alloc& alloc = Alloc()) :
+        AllocatorHolder<Alloc>(alloc), _size(0), _capacity(capacity),
+        _data(Ops::allocate(this->_allocator(), _capacity)) {}
+    Stack(const Stack& other) : Stack(other, Ops::copy_for_container(other._allocator())) {}
+    Stack(const Stack& other, const Alloc& alloc)
+        : AllocatorHolder<Alloc>(alloc), _size(0), _capacity(other._capacity) {
+        _data = Ops::allocate(this->_allocator(), _capacity);
+
+        try {
+            for (; _size < other._size; ++_size) {
+                new (&_data[_size]) T(other._data[_size]);
+            }
+        }
+        catch (...) {
+            _release();
+            throw;
+        }
+    }
+    Stack(Stack&& other) noexcept : AllocatorHolder<Alloc>(other._allocator()) {
+        _steal(other);
+    }
+    Stack(std::initializer_list<T> init, const Alloc& alloc = Alloc())
+        : AllocatorHolder<Alloc>(alloc), _size(init.size()), _capacity(init.size() > 10 ? init.size() * 2 : 10),
+        _data(Ops::allocate(this->_allocator(), _capacity))  //creating raw memory
     {
 
         size_t i = 0;
@@ -89,15 +129,12 @@ public:
             for (size_t j = 0; j < i; ++j) {
                 _data[j].~T(); 
             }
-            ::operator delete(_data);
+            Ops::deallocate(this->_allocator(), _data, _capacity);
             throw;
         }
     }
     ~Stack() {
-        for (size_t i = 0; i < _size; ++i) {
-            _data[i].~T();
-        }
-        ::operator delete(_data);
+        _release();
     }
 
 
@@ -106,6 +143,10 @@ public:
         return _capacity;
     }
 
+    Alloc get_allocator() const {
+        return this->_allocator();
+    }
+
     void clear() {
         for (size_t i = 0; i < _size; ++i) {
             _data[i].~T();
@@ -146,25 +187,15 @@ public:
         return _size == 0;
     }
 
-    void swap(Stack& other) {
-        std::swap(_size, other._size);
-        std::swap(_capacity, other._capacity);
-	memcpy(_data, other._data, other.size() * sizeof(T));
-        std::swap(_data, other._data);
+    void swap(Stack& other) noexcept {
+        _swap_storage(other);
+        Ops::on_swap(this->_allocator(), other._allocator());
     }
     
     void reserve(size_t new_capacity) {
         if (new_capacity <= _capacity) { return; }
 
-        T* new_data = (static_cast<T*>(::operator new(new_capacity * sizeof(T))));
-        for (size_t i = 0; i < _size; ++i) {
-            new (&new_data[i]) T(_data[i]);
-            _data[i].~T();
-        }
-
-        ::operator delete(_data);
-
-        _data = new_data;
+        _data = Ops::reallocate(this->_allocator(), _data, _size, _capacity, new_capacity);
         _capacity = new_capacity;
     }
 
@@ -172,28 +203,37 @@ public:
 
     Stack& operator=(const Stack& other) {
         if (this != &other) {
-            Stack tmp(other);
-            swap(tmp);
+            if (Ops::propagate_on_copy && !Ops::equal(this->_allocator(), other._allocator())) {
+                //The old buffer goes back to the allocator it came from
+                _release();
+                _data = nullptr;
+                _size = 0;
+                _capacity = 0;
+            }
+            Ops::on_copy_assignment(this->_allocator(), other._allocator());
+
+            Stack tmp(other, this->_allocator());
+            _swap_storage(tmp);
         }
         return *this;
     }
 
-    Stack& operator=(Stack&& other) noexcept {
+    Stack& operator=(Stack&& other) noexcept(Ops::propagate_on_move || Ops::always_equal) {
         if (this != &other) {
-            if (_data) {
-                for (size_t i = 0; i < _size; ++i) {
-                    _data[i].~T();
+            if (!Ops::propagate_on_move && !Ops::equal(this->_allocator(), other._allocator())) {
+                //The buffer of other cannot be adopted, the elements are moved one by one
+                Stack tmp(other._size, this->_allocator());
+                for (; tmp._size < other._size; ++tmp._size) {
+                    new (&tmp._data[tmp._size]) T(std::move(other._data[tmp._size]));
                 }
-                ::operator delete(_data);
+                other.clear();
+                _swap_storage(tmp);
+                return *this;
             }
 
-            _data = other._data;
-            _size = other._size;
-            _capacity = other._capacity;
-
-            other._data = nullptr;
-            other._size = 0;
-            other._capacity = 1;
+            _release();
+            Ops::on_move_assignment(this->_allocator(), other._allocator());
+            _steal(other);
         }
         return *this;
     }
@@ -2,200 +2,268 @@
 *  String Documentation
 *
 *  The String class is a dynamic string implementation with automatic memory management.
+*  String is BasicString<Allocator<char>>, BasicString<Alloc> takes any std-compatible
+*  char allocator (for example PolymorphicAllocator<char>, see MemoryResource.hpp).
 *  Provides C-style string operations with bounds checking and resizing capabilities.
 *
 *  Key Features:
 *    - Dynamic memory expansion/shrinking for efficient storage.
 *    - Bounds-checked element access via at() and operator[].
 *    - Common string operations: insert, erase, replace, concatenation.
+*    - Ordering operators, also against std::string_view and const char* (see view()).
 *    - Explicit capacity management (reserve/resize/shrink_to_fit).
 *    - Move semantics for efficient resource transfer.
 *    - Full RAII compliance with proper copy/move semantics.
 *
 *  Notes:
 *    - Throws std::out_of_range for invalid positions in at() and modifier methods.
+*    - operator[] and iterators are checked only in checked mode (see Config.hpp),
+*      otherwise Iterator is a plain char*.
 *    - Maintains null terminator for C-string compatibility.
 *    - Move operations leave source object in valid empty state.
+*    - Empty strings (default-constructed, moved-from, "") own no memory: capacity() is 0
+*      and they point at a shared static terminator until the first insertion.
 *    - Not thread-safe for concurrent modifications.
 *    - All operations maintain string integrity (null-termination and size constraints).
+*    - String only owns a heap pointer, so it is declared trivially relocatable
+*      (as long as its allocator is trivially copyable): containers move it with
+*      memcpy when they grow.
+*    - The buffer grows through Alloc, the default Allocator<char> uses realloc.
+*    - Copy/move assignment follow the propagate_on_container_* traits of Alloc.
 */
 #pragma once
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include "Relocate.hpp"
+#include "Allocator.hpp"
+#include "Config.hpp"
 
 
-class String {
+template<typename Alloc = Allocator<char>>
+class BasicString : private AllocatorHolder<Alloc> {
 private:
+	using Ops = AllocatorOps<Alloc>;
+
 	char* _data;
 	size_t _size;
 	size_t _capacity;
 
-public:
-	//Constructor and destructor
-	String() : _size(0), _capacity(1) {
-		_data = new char[_capacity];
-		_data[0] = '\0';
+	//Shared terminator used by strings that own no memory (_capacity == 0).
+	//It is never written to and never deleted.
+	static char* _empty_buffer() {
+		static char empty = '\0';
+		return &empty;
 	}
-	String(const char* str) : _size(0), _capacity(10) {
-		if (str == nullptr) {
-			throw std::invalid_argument("nullptr passed to constructor");
+
+	//Frees the owned buffer, if any
+	void _release() {
+		if (_capacity != 0) {
+			Ops::deallocate(this->_allocator(), _data, _capacity);
+		}
+	}
+
+	char* _allocate(size_t count) {
+		return Ops::allocate(this->_allocator(), count);
+	}
+
+	//Copies size characters and the terminator of str into a new buffer of capacity slots
+	void _assign_copy(const char* str, size_t size, size_t capacity) {
+		_data = _allocate(capacity);
+		_size = size;
+		_capacity = capacity;
+		for (size_t i = 0; i < _size; ++i) {
+			_data[i] = str[i];
 		}
+		_data[_size] = '\0';
+	}
+
+	//Takes the buffer of other, the allocators must be equal
+	void _steal(BasicString& other) noexcept {
+		_data = other._data;
+		_size = other._size;
+		_capacity = other._capacity;
+		other._reset();
+	}
+
+	//Leaves the string empty without owned memory
+	void _reset() {
+		_data = _empty_buffer();
+		_size = 0;
+		_capacity = 0;
+	}
 
+public:
+	using allocator_type = Alloc;
+
+	//Constructor and destructor
+	//An empty string owns no memory, the first insertion allocates
+	BasicString() : BasicString(Alloc()) {}
+	explicit BasicString(const Alloc& alloc) : AllocatorHolder<Alloc>(alloc), _data(_empty_buffer()), _size(0), _capacity(0) {}
+	BasicString(const char* str, const Alloc& alloc = Alloc()) : BasicString(alloc) {
 		if (str == nullptr) {
-			_size = 0;
-			_capacity = 1;
-			_data = new char[_capacity];
-			_data[0] = '\0';
-			return;
+			throw std::invalid_argument("nullptr passed to constructor");
 		}
 
 		size_t str_size = 0;
 		while (str[str_size] != '\0') {
 			++str_size;
 		}
-
-		_capacity = str_size + 1;
-		_size = str_size;
-		_data = new char[_capacity];
-		for (size_t i = 0; i < _size; ++i) {
-			_data[i] = str[i];
+		if (str_size == 0) {
+			return;
 		}
-		_data[_size] = '\0';
+
+		_assign_copy(str, str_size, str_size + 1);
 	}
-	String(const String& other) : _size(other._size), _capacity(other._capacity) {
-		_data = new char[_capacity];
-		for (size_t i = 0; i <= _size; ++i) {
-			_data[i] = other._data[i];
+	BasicString(const BasicString& other) : BasicString(other, Ops::copy_for_container(other._allocator())) {}
+	BasicString(const BasicString& other, const Alloc& alloc) : BasicString(alloc) {
+		if (other._capacity == 0) {
+			return;
 		}
+		_assign_copy(other._data, other._size, other._capacity);
 	}
-	String(String&& other) noexcept : _data(other._data), _size(other._size), _capacity(other._capacity) {
-		other._data = nullptr;
-		other._size = 0;
-		other._capacity = 0;
+	BasicString(BasicString&& other) noexcept : BasicString(other._allocator()) {
+		_steal(other);
 	}
-	~String() {
-		delete[] _data;
+	~BasicString() {
+		_release();
 	}
 
 	//--------------------------------- I T E R A T O R -----------------------------------
-	class Iterator {
+	class CheckedIterator {
 	private:
 		char* _ptr;
-		String& container;
+		BasicString* container;
 
 		void _check_bounds(size_t pos) const {
-			if (pos >= container._size) {
+			if (pos >= container->_size) {
 				throw std::out_of_range("Iterator out of bounds");
 			}
 		}
 	public:
-		Iterator(char* ch, String& str ) : _ptr(ch), container(str) {}
+		CheckedIterator(char* ch, BasicString& str ) : _ptr(ch), container(&str) {}
 
 		char& operator*() {
-			_check_bounds(_ptr - container._data);
+			_check_bounds(_ptr - container->_data);
 			return *_ptr;
 		}
 
 		char* operator->() {
-			_check_bounds(_ptr - container._data);
+			_check_bounds(_ptr - container->_data);
 			return &(*_ptr);
 		}
 
 		const char& operator*() const {
-			_check_bounds(_ptr - container._data);
+			_check_bounds(_ptr - container->_data);
 			return *_ptr;
 		}
 
 		const char* operator->() const {
-			_check_bounds(_ptr - container._data);
+			_check_bounds(_ptr - container->_data);
 			return &(*_ptr);
 		}
 
 		// Increment/Decrement ------------------------------------------------
-		Iterator& operator++() {
-			_check_bounds(_ptr - container._data);
+		CheckedIterator& operator++() {
+			_check_bounds(_ptr - container->_data);
 			++_ptr;
 			return *this;
 		}
 
-		Iterator operator++(int) {
-			Iterator tmp = *this;
+		CheckedIterator operator++(int) {
+			CheckedIterator tmp = *this;
 			++(*this);
 			return tmp;
 		}
 
-		Iterator& operator--() {
-			_check_bounds(_ptr - container._data);
+		CheckedIterator& operator--() {
+			_check_bounds(_ptr - container->_data);
 			--_ptr;
 			return *this;
 		}
 
-		Iterator operator--(int) {
-			Iterator tmp = *this;
+		CheckedIterator operator--(int) {
+			CheckedIterator tmp = *this;
 			--(*this);
-			return *this;
+			return tmp;
 		}
 
 		// Arithmetic operations --------------------------------------------
-		Iterator& operator+=(size_t n) {
+		CheckedIterator& operator+=(size_t n) {
 			_ptr += n;
-			_check_bounds(_ptr - container._data);
+			_check_bounds(_ptr - container->_data);
 			return *this;
 		}
 
-		Iterator& operator-=(size_t n) {
+		CheckedIterator& operator-=(size_t n) {
 			_ptr -= n;
-			_check_bounds(_ptr - container._data);
+			_check_bounds(_ptr - container->_data);
 			return *this;
 		}
 
-		Iterator operator+(size_t n) const {
-			Iterator tmp = *this;
+		CheckedIterator operator+(size_t n) const {
+			CheckedIterator tmp = *this;
 			tmp += n;
 			return tmp;
 		}
 
-		Iterator operator-(size_t n) const {
-			Iterator tmp = *this;
+		CheckedIterator operator-(size_t n) const {
+			CheckedIterator tmp = *this;
 			tmp -= n;
 			return tmp;
 		}
 
 		// Comparison ---------------------------------------------------------
-		Iterator& operator=(const Iterator& other) {
+		CheckedIterator& operator=(const CheckedIterator& other) {
 			_ptr = other._ptr;
 			container = other.container;
 			return *this;
 		}
 
 
-		bool operator==(const Iterator& other) const {
+		bool operator==(const CheckedIterator& other) const {
 			return _ptr == other._ptr;
 		}
 
-		bool operator!=(const Iterator& other) const {
+		bool operator!=(const CheckedIterator& other) const {
 			return !(*this == other);
 		}
 
-		bool operator<(const Iterator& other) const {
+		bool operator<(const CheckedIterator& other) const {
 			return _ptr < other._ptr;
 		}
 
-		bool operator>(const Iterator& other) const {
+		bool operator>(const CheckedIterator& other) const {
 			return other < *this;
 		}
 
-		bool operator<=(const Iterator& other) const {
+		bool operator<=(const CheckedIterator& other) const {
 			return !(other < *this);
 		}
 
-		bool operator>=(const Iterator& other) const {
+		bool operator>=(const CheckedIterator& other) const {
 			return !(*this < other);
 		}
 
 	};
 	//-------------------------------------------------------------------------------------
 
+	//Bounds-checked iterator in checked mode, raw pointer otherwise (see Config.hpp)
+	using Iterator = std::conditional_t<containers_checked, CheckedIterator, char*>;
+
+private:
+	Iterator _make_iterator(char* ptr) {
+		if constexpr (containers_checked) {
+			return Iterator(ptr, *this);
+		}
+		else {
+			return ptr;
+		}
+	}
+
+public:
+
 	char& at(size_t index) {
 		if (index < 0 || index >= _size) {
 			throw std::out_of_range("Index out of bounds");
@@ -211,11 +279,11 @@ public:
 	}
 
 	Iterator begin() {
-		return Iterator(_data, *this);
+		return _make_iterator(_data);
 	}
 
 	Iterator end() {
-		return Iterator(_data + _size, *this);
+		return _make_iterator(_data + _size);
 	}
 
 	void erase(size_t pos_start, size_t pos_end) {
@@ -233,7 +301,7 @@ public:
 		_data[_size] = '\0';
 	}
 
-	void replace(size_t pos_start, size_t pos_end, const String& str) {
+	void replace(size_t pos_start, size_t pos_end, const BasicString& str) {
 		if (pos_start > _size || pos_end > _size || pos_start > pos_end) {
 			throw std::out_of_range("Index out of bounds");
 		}
@@ -279,11 +347,12 @@ public:
 	}
 
 	void clear() {
+		if (_capacity == 0) { return; }
 		_size = 0;
 		_data[0] = '\0';
 	}
 
-	void insert(size_t pos, const String& str) {
+	void insert(size_t pos, const BasicString& str) {
 		if (pos > _size) {
 			throw std::out_of_range("Index out of bounds");
 		}
@@ -321,19 +390,23 @@ public:
 		return _capacity;
 	}
 
+	Alloc get_allocator() const {
+		return this->_allocator();
+	}
+
 	void reserve(size_t new_capacity) {
 		if (new_capacity <= _capacity) { return; }
 
-		char* new_data = new char[new_capacity];
-		for (size_t i = 0; i < _size;++i) {
-			new_data[i] = _data[i];
+		if (_capacity == 0) {
+			//The shared empty buffer is not ours, only the terminator is copied
+			_data = _allocate(new_capacity);
+			_data[0] = '\0';
+		}
+		else {
+			//Characters and terminator move to the bigger buffer (realloc with the default allocator)
+			_data = Ops::reallocate(this->_allocator(), _data, _size + 1, _capacity, new_capacity);
 		}
-		new_data[_size] = '\0';
-
-		delete[] _data;
-		_data = new_data;
 		_capacity = new_capacity;
-
 	}
 
 	void resize(size_t new_size, char default_value) {
@@ -355,53 +428,50 @@ public:
 	}
 
 	void shrink_to_fit() {
-		if (_capacity == _size + 1) return;
-
-		char* new_data = new char[_size + 1];
-		for (size_t i = 0; i < _size; ++i) {
-			new_data[i] = _data[i];
+		if (_capacity == 0 || _capacity == _size + 1) return;
+		if (_size == 0) {
+			_release();
+			_reset();
+			return;
 		}
-		new_data[_size] = '\0';
 
-		delete[] _data;
-		_data = new_data;
+		_data = Ops::reallocate(this->_allocator(), _data, _size + 1, _capacity, _size + 1);
 		_capacity = _size + 1;
 	}
 
 	//------------------------------- O P E R A T O R S -------------------------------------------------
-	String& operator=(const String& other) {
+	BasicString& operator=(const BasicString& other) {
 		if (this == &other) { return *this; }
 
-		delete[] _data;
-
-		_size = other._size;
-		_capacity = other._capacity;
-
-		_data = new char[_capacity];
-		for (size_t i = 0; i <= _size;++i) {
-			_data[i] = other._data[i];
-		}
+		_release();
+		_reset();
+		Ops::on_copy_assignment(this->_allocator(), other._allocator());
+		if (other._capacity == 0) { return *this; }
 
+		_assign_copy(other._data, other._size, other._capacity);
 		return *this;
 	}
 
-	String& operator=(String&& other) {
+	BasicString& operator=(BasicString&& other) noexcept(Ops::propagate_on_move || Ops::always_equal) {
 		if (this == &other) return *this;
 
-		delete[] _data;
-
-		_size = other._size;
-		_capacity = other._capacity;
-		_data = other._data;
-
-		other._size = 0;
-		other._capacity = 0;
-		other._data = nullptr;
+		_release();
+		_reset();
+		if (!Ops::propagate_on_move && !Ops::equal(this->_allocator(), other._allocator())) {
+			//The buffer of other cannot be adopted, the characters are copied
+			if (other._capacity != 0) {
+				_assign_copy(other._data, other._size, other._size + 1);
+			}
+			other.clear();
+			return *this;
+		}
 
+		Ops::on_move_assignment(this->_allocator(), other._allocator());
+		_steal(other);
 		return *this;
 	}
 
-	String& operator+=(const String& other) {
+	BasicString& operator+=(const BasicString& other) {
 		if (other._size == 0) { return *this; }
 
 		reserve(_capacity + other.size() + 1);
@@ -415,24 +485,30 @@ public:
 		return *this;
 	}
 
-	String& operator+=(const char* cstr) {
-		return *this += String(cstr); 
+	BasicString& operator+=(const char* cstr) {
+		return *this += BasicString(cstr, this->_allocator());
 	}
 
-	String& operator+=(const std::string& other) {
-		return *this += String(other.c_str()); 
+	BasicString& operator+=(const std::string& other) {
+		return *this += BasicString(other.c_str(), this->_allocator());
 	}
 
 
 	char& operator[](size_t index) {
-		return at(index);
+		if constexpr (containers_checked) {
+			return at(index);
+		}
+		return _data[index];
 	}
 
 	const char& operator[](size_t index) const {
-		return at(index);
+		if constexpr (containers_checked) {
+			return at(index);
+		}
+		return _data[index];
 	}
 
-	bool operator==(const String& other) const {
+	bool operator==(const BasicString& other) const {
 		if (_size != other._size) {
 			return false;
 		}
@@ -445,14 +521,57 @@ public:
 		return true;
 	}
 
-	bool operator!=(const String& other) const {
+	bool operator!=(const BasicString& other) const {
 		return !(*this == other);
 	}
 
-	friend String operator+(const String& left, const String& right) {
-		String tmp(left);
+	std::string_view view() const {
+		return std::string_view(_data, _size);
+	}
+
+	//Lexicographic order. With a transparent comparator (std::less<>) containers keyed by String can be searched
+	//with literals and views without building a String.
+	friend bool operator<(const BasicString& left, const BasicString& right) {
+		return left.view() < right.view();
+	}
+
+	friend bool operator<(const BasicString& left, std::string_view right) {
+		return left.view() < right;
+	}
+
+	friend bool operator<(std::string_view left, const BasicString& right) {
+		return left < right.view();
+	}
+
+	friend bool operator<(const BasicString& left, const char* right) {
+		return left.view() < std::string_view(right);
+	}
+
+	friend bool operator<(const char* left, const BasicString& right) {
+		return std::string_view(left) < right.view();
+	}
+
+	friend bool operator>(const BasicString& left, const BasicString& right) {
+		return right < left;
+	}
+
+	friend bool operator<=(const BasicString& left, const BasicString& right) {
+		return !(right < left);
+	}
+
+	friend bool operator>=(const BasicString& left, const BasicString& right) {
+		return !(left < right);
+	}
+
+	friend BasicString operator+(const BasicString& left, const BasicString& right) {
+		BasicString tmp(left);
 		tmp += right;
 		return tmp;
 	}
 
 };
+
+using String = BasicString<>;
+
+template<typename Alloc>
+struct is_trivially_relocatable<BasicString<Alloc>> : std::bool_constant<std::is_trivially_copyable_v<Alloc>> {};
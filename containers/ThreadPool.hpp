@@ -0,0 +1,173 @@
+/*
+*  ThreadPool Documentation
+*
+*  A fixed set of worker threads that run queued tasks, and TaskGroup for fork-join
+*  parallelism on top of it. Used by the AVLtree set operations.
+*
+*  Key Features:
+*    - ThreadPool(threads): the workers start in the constructor and are joined in the
+*      destructor after the queue has been drained.
+*    - default_thread_pool(): shared pool with hardware_concurrency() - 1 workers
+*      (the calling thread is the remaining one), created on first use.
+*    - TaskGroup::run(f) queues f, TaskGroup::wait() blocks until every task of the group
+*      has finished and rethrows the first exception one of them threw.
+*    - A waiting thread runs queued tasks itself, so tasks may fork and wait for subtasks
+*      without exhausting the workers (no deadlock on nested fork-join).
+*    - A pool without workers runs every task inline in run().
+*
+*  Notes:
+*    - Tasks are std::function<void()>, the queue is a Deque guarded by one mutex:
+*      meant for coarse tasks (thousands of operations each), not for tiny ones.
+*    - A TaskGroup must not be destroyed before wait() has returned.
+*    - Link with -pthread.
+*/
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "Deque.hpp"
+#include "Vector.hpp"
+
+
+class ThreadPool {
+private:
+	Vector<std::thread> _workers;
+	Deque<std::function<void()>> _tasks;
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	bool _stopping = false;
+
+	void _work() {
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_wake.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+				if (_tasks.empty()) {
+					return;
+				}
+				task = std::move(_tasks.front());
+				_tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+public:
+	explicit ThreadPool(size_t threads) {
+		_workers.reserve(threads);
+		for (size_t i = 0; i < threads; ++i) {
+			_workers.emplace_back([this] { _work(); });
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+		_wake.notify_all();
+		for (size_t i = 0; i < _workers.size(); ++i) {
+			_workers[i].join();
+		}
+	}
+
+	//Number of worker threads
+	size_t size() const {
+		return _workers.size();
+	}
+
+	void submit(std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_tasks.push_back(std::move(task));
+		}
+		_wake.notify_one();
+	}
+
+	//Runs one queued task in the calling thread, returns false if the queue was empty
+	bool run_pending_task() {
+		std::function<void()> task;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_tasks.empty()) {
+				return false;
+			}
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+		task();
+		return true;
+	}
+};
+
+
+inline ThreadPool& default_thread_pool() {
+	static ThreadPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+	return pool;
+}
+
+
+class TaskGroup {
+private:
+	ThreadPool& _pool;
+	std::atomic<size_t> _pending;
+	std::mutex _error_mutex;
+	std::exception_ptr _error;
+
+	void _fail(std::exception_ptr error) {
+		std::lock_guard<std::mutex> lock(_error_mutex);
+		if (!_error) {
+			_error = error;
+		}
+	}
+
+public:
+	explicit TaskGroup(ThreadPool& pool = default_thread_pool()) : _pool(pool), _pending(0) {}
+
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	template<typename Function>
+	void run(Function function) {
+		if (_pool.size() == 0) {
+			try {
+				function();
+			}
+			catch (...) {
+				_fail(std::current_exception());
+			}
+			return;
+		}
+
+		++_pending;
+		_pool.submit([this, function]() mutable {
+			try {
+				function();
+			}
+			catch (...) {
+				_fail(std::current_exception());
+			}
+			--_pending;
+		});
+	}
+
+	void wait() {
+		while (_pending.load() != 0) {
+			if (!_pool.run_pending_task()) {
+				std::this_thread::yield();
+			}
+		}
+		if (_error) {
+			std::rethrow_exception(_error);
+		}
+	}
+};
@@ -11,194 +11,182 @@
 *    - Capacity and size management.
 *
 *  Notes:
-*    - Iterators throw std::out_of_range on out-of-bounds access.
+*    - Iterators throw std::out_of_range on out-of-bounds access in checked mode.
+*      With CONTAINERS_CHECKED=0 (see Config.hpp) Iterator is a plain T* and
+*      operator[] does no bounds check.
 *    - Existing iterators are invalidated when capacity changes.
+*    - A default-constructed or moved-from Vector owns no memory (capacity() == 0),
+*      the first insertion allocates 10 slots.
+*    - Memory comes from Alloc (see Allocator.hpp). Copies get
+*      select_on_container_copy_construction(), assignment and swap follow the
+*      propagate_on_container_* traits of Alloc.
 *    - Not thread-safe.
 */
 
 /*
 *  type T must have :
 *   - copy constructor
-*   - operator = (copy)
-*   - move semantic
+*   - move constructor
+*   - operator = (copy and move)
+*
+*  T does not need a default constructor: the buffer is raw memory obtained from
+*  Alloc (by default Allocator<T>, i.e. Relocator<T>), elements are created with placement new and destroyed one by one,
+*  exactly like in Stack. Unused capacity never holds constructed objects.
+*  Growth of trivially relocatable T is a memcpy or an in-place realloc (see Relocate.hpp).
 */
 #pragma once
 #include <stdexcept>
 #include <type_traits>
 #include <initializer_list>
 #include <cstddef>
+#include <new>
+#include <utility>
+#include <cstring>
+#include "Relocate.hpp"
+#include "Allocator.hpp"
+#include "Config.hpp"
+#include "ContiguousIterator.hpp"
 
 
-template <typename T>
-class Vector {
+template <typename T, typename Alloc = Allocator<T>>
+class Vector : private AllocatorHolder<Alloc> {
 private:
+    using Ops = AllocatorOps<Alloc>;
+
     size_t _capacity;
     size_t _size;
     T* _data;
 
     static constexpr bool is_trivial_T = std::is_trivially_destructible_v<T>;
 
-public:
-    //Constructor and destructor
-    Vector() : _capacity(10), _size(0) {
-        _data = new T[_capacity];
+    //Raw memory helpers: no constructors or destructors are called here
+    T* _allocate(size_t count) {
+        return Ops::allocate(this->_allocator(), count);
     }
 
-    Vector(const Vector<T>& vec) : _size(vec._size), _capacity(vec._capacity) {
-        _data = new T[_capacity];
-        for (size_t i = 0; i < _size; ++i) {
-            _data[i] = vec._data[i];
-        }
+    void _deallocate(T* ptr, size_t count) {
+        Ops::deallocate(this->_allocator(), ptr, count);
     }
 
-    Vector(Vector<T>&& vec) noexcept
-        : _data(vec._data), _capacity(vec._capacity), _size(vec._size) {
-        vec._data = nullptr;
-        vec._capacity = 0;
-        vec._size = 0;
+    //Calls destructors for [first, last), the memory itself stays allocated
+    static void _destroy(T* first, T* last) {
+        if constexpr (!is_trivial_T) {
+            for (; first != last; ++first) {
+                first->~T();
+            }
+        }
     }
 
-    Vector(std::initializer_list<T> init)
-        : _size(init.size()),
-        _capacity(init.size() > 10 ? init.size() * 2: 10),
-        _data(new T[_capacity])
-    {
+    //Copy-constructs count elements from src into raw memory dst.
+    //If a constructor throws, the already built elements are destroyed.
+    static void _copy_construct(const T* src, size_t count, T* dst) {
         size_t i = 0;
         try {
-            for (const auto& item : init) {
-                _data[i] = item;
-                ++i;
+            for (; i < count; ++i) {
+                new (&dst[i]) T(src[i]);
             }
         }
         catch (...) {
-            delete[] _data;
+            _destroy(dst, dst + i);
             throw;
         }
     }
 
-    ~Vector() {
-        delete[] _data; 
+    //Moves all elements into a buffer of new_capacity slots (memcpy/realloc for relocatable T)
+    void _reallocate(size_t new_capacity) {
+        _data = Ops::reallocate(this->_allocator(), _data, _size, _capacity, new_capacity);
+        _capacity = new_capacity;
     }
 
-    //--------------------------------- I T E R A T O R -----------------------------------
-    class Iterator {
-    private:
-        Vector<T>& _container;  // Reference to the parent container
-        T* _ptr;                // Current position pointer
-
-        // Check for out-of-bounds access
-        void _check_bounds(size_t pos) const {
-            if (pos >= _container._size) {
-                throw std::out_of_range("Iterator out of bounds");
-            }
-        }
+    //Destroys the elements and returns the buffer to the allocator
+    void _release() {
+        _destroy(_data, _data + _size);
+        _deallocate(_data, _capacity);
+    }
 
-    public:
-        // Types for STL compatibility
-        using iterator_category = std::random_access_iterator_tag;
-        using value_type = T;
-        //difference_type is a safe and generic way to work with distances between iterators,
-        //supporting all possible scenarios, including negative values.
-        using difference_type = std::ptrdiff_t;
-        using pointer = T*;
-        using reference = T&;
-
-        Iterator(Vector<T>& container, T* ptr)
-            : _container(container), _ptr(ptr) {}
-
-        ~Iterator() = default;
-
-        // Basic operations ---------------------------------------------------
-        reference operator*() const {
-            _check_bounds(_ptr - _container._data);  // _container._data points to the start of the array
-            return *_ptr;
-        }
+    //Takes the buffer of other, the allocators must be equal
+    void _steal(Vector& other) noexcept {
+        _data = other._data;
+        _size = other._size;
+        _capacity = other._capacity;
 
-        // Increment/Decrement ------------------------------------------------
-        Iterator& operator++() {
-            //If iterator points to the last element(end() - 1), after increment it will become end() - this is valid
-            //If iterator is already end(), increment is invalid - check must be before change
-            _check_bounds(_ptr - _container._data);
-            ++_ptr;
-            return *this;
-        }
+        other._data = nullptr;
+        other._size = 0;
+        other._capacity = 0;
+    }
 
-        Iterator operator++(int) {
-            Iterator tmp = *this;
-            ++(*this);
-            return tmp;
-        }
+    //Exchanges the buffers, the allocators stay where they are
+    void _swap_storage(Vector& other) noexcept {
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_capacity, other._capacity);
+    }
 
-        Iterator& operator--() {
-            //If iterator is end(), decrement will move it to the last element - this is valid
-            //If iterator is begin(), decrement is invalid - check before change
-            _check_bounds(_ptr - _container._data);
-            --_ptr;
-            return *this;
-        }
+public:
+    using allocator_type = Alloc;
 
-        Iterator operator--(int) {
-            Iterator tmp = *this;
-            --(*this);
-            return tmp;
-        }
+    //Constructor and destructor
+    //No memory is allocated until the first insertion
+    Vector() : Vector(Alloc()) {}
 
-        // Arithmetic operations --------------------------------------------
-        Iterator operator+(difference_type n) const {
-            Iterator tmp = *this;
-            tmp += n;
-            return tmp;
-        }
+    explicit Vector(const Alloc& alloc)
+        : AllocatorHolder<Alloc>(alloc), _capacity(0), _size(0), _data(nullptr) {}
 
-        Iterator operator-(difference_type n) const {
-            Iterator tmp = *this;
-            tmp -= n;
-            return tmp;
-        }
+    Vector(const Vector& vec) : Vector(vec, Ops::copy_for_container(vec._allocator())) {}
 
-        difference_type operator-(const Iterator& other) const {
-            return _ptr - other._ptr;
+    Vector(const Vector& vec, const Alloc& alloc)
+        : AllocatorHolder<Alloc>(alloc), _capacity(vec._capacity), _size(vec._size) {
+        _data = _allocate(_capacity);
+        try {
+            _copy_construct(vec._data, _size, _data);
         }
-
-        Iterator& operator+=(difference_type n) {
-            _ptr += n;
-            _check_bounds(_ptr - _container._data);
-            return *this;
+        catch (...) {
+            _deallocate(_data, _capacity);
+            throw;
         }
+    }
 
-        Iterator& operator-=(difference_type n) {
-            _ptr -= n;
-            _check_bounds(_ptr - _container._data);
-            return *this;
-        }
+    Vector(Vector&& vec) noexcept
+        : AllocatorHolder<Alloc>(vec._allocator()), _capacity(0), _size(0), _data(nullptr) {
+        _steal(vec);
+    }
 
-        // Comparison ---------------------------------------------------------
-        bool operator==(const Iterator& other) const {
-            return _ptr == other._ptr;
+    Vector(std::initializer_list<T> init, const Alloc& alloc = Alloc())
+        : AllocatorHolder<Alloc>(alloc),
+        _capacity(init.size() > 10 ? init.size() * 2: 10),
+        _size(init.size())
+    {
+        _data = _allocate(_capacity);
+        try {
+            _copy_construct(init.begin(), _size, _data);
         }
-
-        bool operator!=(const Iterator& other) const {
-            return !(*this == other);
+        catch (...) {
+            _deallocate(_data, _capacity);
+            throw;
         }
+    }
 
-        bool operator<(const Iterator& other) const {
-            return _ptr < other._ptr;
-        }
+    ~Vector() {
+        _release();
+    }
 
-        bool operator>(const Iterator& other) const {
-            return other < *this;
-        }
+    //--------------------------------- I T E R A T O R -----------------------------------
+    using CheckedIterator = ContiguousIterator<Vector, T>;
 
-        bool operator<=(const Iterator& other) const {
-            return !(other < *this);
-        }
+    //Bounds-checked iterator in checked mode, raw pointer otherwise
+    using Iterator = std::conditional_t<containers_checked, CheckedIterator, T*>;
 
-        bool operator>=(const Iterator& other) const {
-            return !(*this < other);
+private:
+    Iterator _make_iterator(T* ptr) {
+        if constexpr (containers_checked) {
+            return Iterator(*this, ptr);
         }
+        else {
+            return ptr;
+        }
+    }
 
-    };
-    //-------------------------------------------------------------------------------------
+public:
 
     const T& at(size_t index) const {
         if (index >= _size) { throw std::out_of_range("Index out of range"); }
@@ -211,7 +199,7 @@ public:
     }
 
     Iterator begin() {
-        return Iterator(*this, _data);
+        return _make_iterator(_data);
     }
 
     size_t capacity() const {
@@ -219,11 +207,7 @@ public:
     }
 
     void clear() {
-        if (!is_trivial_T) { //if T not trivial
-            for (size_t i = 0; i < _size;++i) {
-                _data[i].~T();
-            }
-        }
+        _destroy(_data, _data + _size);
         _size = 0;
     }
 
@@ -235,13 +219,79 @@ public:
         return _data;
     }
 
-    void emplace_back(const T& element) {
-        if (_size + 1 > _capacity) {
-            reserve(_capacity == 0 ? 10 : _capacity * 2);
+    //Constructs the element in place at the end from args, returns a reference to it
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (_size < _capacity) {
+            new (&_data[_size]) T(std::forward<Args>(args)...);
+            return _data[_size++];
+        }
+
+        size_t new_capacity = _capacity == 0 ? 10 : _capacity * 2;
+        if constexpr (Relocator<T>::trivial) {
+            //args may refer to an element of this vector and realloc may free it, so the
+            //object is built aside first and then relocated bytewise into the grown buffer
+            alignas(T) unsigned char buffer[sizeof(T)];
+            new (buffer) T(std::forward<Args>(args)...);
+            try {
+                _reallocate(new_capacity);
+            }
+            catch (...) {
+                reinterpret_cast<T*>(buffer)->~T();
+                throw;
+            }
+            std::memcpy(static_cast<void*>(&_data[_size]), buffer, sizeof(T));
+            return _data[_size++];
+        }
+        else {
+            //The new element is built in the new buffer before the old one is released,
+            //so args may safely refer to an object stored in this vector
+            T* new_data = _allocate(new_capacity);
+            try {
+                new (&new_data[_size]) T(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                _deallocate(new_data, new_capacity);
+                throw;
+            }
+
+            Relocator<T>::relocate(_data, _size, new_data);
+            _deallocate(_data, _capacity);
+            _data = new_data;
+            _capacity = new_capacity;
+            return _data[_size++];
         }
+    }
 
-        _data[_size] = element;
+    //Constructs an element from args before position, returns an iterator to it
+    template<typename... Args>
+    Iterator emplace(const Iterator position, Args&&... args) {
+        if (position < begin() || position > end()) {
+            throw std::out_of_range("Iterator out of bounds");
+        }
+
+        //The index is taken before reserve(), the iterator points into the old buffer afterwards
+        size_t pos_index = position - begin();
+        if (pos_index == _size) {
+            emplace_back(std::forward<Args>(args)...);
+            return _make_iterator(_data + pos_index);
+        }
+
+        //The value is built first: args may refer to an element that the shift is about to move
+        T value(std::forward<Args>(args)...);
+        if (_size + 1 >= _capacity) {
+            reserve(_size == 0 ? 10: _capacity * 2);
+        }
+
+        //The last element moves into raw memory, the rest are shifted by move assignment
+        new (&_data[_size]) T(std::move(_data[_size - 1]));
+        for (size_t i = _size - 1; i > pos_index; --i) {
+            _data[i] = std::move(_data[i - 1]);
+        }
+
+        _data[pos_index] = std::move(value);
         ++_size;
+        return _make_iterator(_data + pos_index);
     }
 
     bool empty() const {
@@ -249,7 +299,11 @@ public:
     }
 
     Iterator end() {
-        return Iterator(*this, _data + _size);
+        return _make_iterator(_data + _size);
+    }
+
+    Alloc get_allocator() const {
+        return this->_allocator();
     }
 
     void erase(const Iterator& first,const Iterator& last) {
@@ -257,16 +311,14 @@ public:
             throw std::out_of_range("Iterator out of bounds");
         }
 
-        if constexpr (!is_trivial_T) {
-            for (auto it = first; it != last; ++it) {
-                it.~T();
-            }
-        }
-
+        size_t first_index = first - begin();
         size_t difference = last - first;
-        for (auto it = last; it != end(); ++it) {
-            *(it - difference) =  std::move(*it);
+
+        //The tail is shifted over the erased range, then the now unused slots at the end are destroyed
+        for (size_t i = first_index + difference; i < _size; ++i) {
+            _data[i - difference] = std::move(_data[i]);
         }
+        _destroy(_data + _size - difference, _data + _size);
 
         _size -= difference;
     }
@@ -277,15 +329,11 @@ public:
         }
 
         size_t index = position - begin();
-
-        //delete current object
-        if (!is_trivial_T) {
-            _data[index].~T();
-        }
-
         for (size_t i = index; i < _size - 1; ++i) {
             _data[i] = std::move(_data[i + 1]);
         }
+
+        _data[_size - 1].~T();
         --_size;
     }
 
@@ -300,28 +348,16 @@ public:
     }
 
     void insert(const T& element, const Iterator position) {
-        if (position < begin() || position > end()) {
-            throw std::out_of_range("Iterator out of bounds");
-        }
-
-        if (_size + 1 >= _capacity) {
-            reserve(_size == 0 ? 10: _capacity * 2);
-        }
-
-        size_t pos_index = position - begin();
-        for (size_t i = _size; i > pos_index; --i) {
-            _data[i] = std::move(_data[i - 1]);
-        }
+        emplace(position, element);
+    }
 
-        _data[pos_index] = element;
-        ++_size;
+    void insert(T&& element, const Iterator position) {
+        emplace(position, std::move(element));
     }
 
     void pop_back() {
         if (!empty()) {
-            if (!is_trivial_T) {
-                _data[_size - 1].~T();
-            }
+            _data[_size - 1].~T();
             --_size;
         }
     }
@@ -330,27 +366,18 @@ public:
         emplace_back(element);
     }
 
+    void push_back(T&& element) {
+        emplace_back(std::move(element));
+    }
+
     void reserve(size_t new_capacity) {
         if (new_capacity <= _capacity) { return; }
-
-        T* new_data = new T[new_capacity];
-
-        for (size_t i = 0; i < _size; ++i) {
-            new_data[i] = std::move(_data[i]);
-        }
-
-        delete[] _data;
-        _data = new_data;
-        _capacity = new_capacity;
+        _reallocate(new_capacity);
     }
 
     void resize(size_t new_size, const T& default_value = T()) {
         if (new_size < _size) {
-            if (!is_trivial_T) {
-                for (size_t i = new_size; i < _size; ++i) {
-                    _data[i].~T();
-                }
-            }
+            _destroy(_data + new_size, _data + _size);
             _size = new_size;
             return;
         }
@@ -358,23 +385,14 @@ public:
         if (new_size > _capacity) {
             reserve(new_size + 1);
         }
-        for (size_t i = _size; i < new_size; ++i) {
-            _data[i] = default_value;
+        for (; _size < new_size; ++_size) {
+            new (&_data[_size]) T(default_value);
         }
-        _size = new_size;
     }
 
     void shrink_to_fit() {
         if (_capacity == _size) { return; }
-
-        T* new_data = new T[_size];
-        for (size_t i = 0; i < _size; ++i) {
-            new_data[i] = std::move(_data[i]);
-        }
-
-        delete[] _data;
-        _data = new_data;
-        _capacity = _size;
+        _reallocate(_size);
     }
 
     size_t size() const {
@@ -382,49 +400,67 @@ public:
     }
 
     void swap(Vector& other) noexcept {
-        std::swap(_data, other._data);
-        std::swap(_size, other._size);
-        std::swap(_capacity, other._capacity);
+        _swap_storage(other);
+        Ops::on_swap(this->_allocator(), other._allocator());
     }
 
     //------------------------------- O P E R A T O R S -------------------------------------------------
 
     const T& operator[](size_t index) const {
-        if (index >= _size) {
-            throw std::out_of_range("Index out of bounds");
+        if constexpr (containers_checked) {
+            if (index >= _size) {
+                throw std::out_of_range("Index out of bounds");
+            }
         }
         return _data[index];
     }
 
     T& operator[](size_t index) {
-        if (index >= _size) {
-            throw std::out_of_range("Index out of bounds");
+        if constexpr (containers_checked) {
+            if (index >= _size) {
+                throw std::out_of_range("Index out of bounds");
+            }
         }
         return _data[index];
     }
 
     Vector& operator=(const Vector& other) {
         if (this != &other) {
-            Vector temp(other);
-            swap(temp);
+            if (Ops::propagate_on_copy && !Ops::equal(this->_allocator(), other._allocator())) {
+                //The old buffer goes back to the allocator it came from
+                _release();
+                _data = nullptr;
+                _size = 0;
+                _capacity = 0;
+            }
+            Ops::on_copy_assignment(this->_allocator(), other._allocator());
+
+            Vector temp(other, this->_allocator());
+            _swap_storage(temp);
         }
         return *this;
     }
 
-    Vector& operator=(Vector&& right) {
+    Vector& operator=(Vector&& right) noexcept(Ops::propagate_on_move || Ops::always_equal) {
         if (this != &right) {
-            delete[] _data;
-
-            _data = right._data;
-            _size = right._size;
-            _capacity = right._capacity;
+            if (!Ops::propagate_on_move && !Ops::equal(this->_allocator(), right._allocator())) {
+                //The buffer of right cannot be adopted, the elements are moved one by one
+                Vector temp(this->_allocator());
+                temp.reserve(right._size);
+                for (size_t i = 0; i < right._size; ++i) {
+                    temp.emplace_back(std::move(right._data[i]));
+                }
+                right.clear();
+                _swap_storage(temp);
+                return *this;
+            }
 
-            right._data = nullptr;
-            right._size = 0;
-            right._capacity = 0;
+            _release();
+            Ops::on_move_assignment(this->_allocator(), right._allocator());
+            _steal(right);
         }
 
         return *this;
     }
 
-};
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "containers/Vector.hpp"
+#include "containers/SmallVector.hpp"
 #include "containers/Array.hpp"
 #include "containers/String.hpp"
 #include "containers/Stack.hpp"
@@ -6,6 +7,15 @@
 #include "containers/Queue.hpp"
 #include "containers/List.hpp"
 #include "containers/AVLtree.hpp"
+#include "containers/AVLmap.hpp"
+#include "containers/BTree.hpp"
+#include "containers/BTreeMap.hpp"
+#include "containers/FrozenSet.hpp"
+#include "containers/ConcurrentAVLtree.hpp"
+#include "containers/PersistentAVLtree.hpp"
+#include "containers/IntervalTree.hpp"
+#include "containers/AVLmultiset.hpp"
+#include "containers/MemoryResource.hpp"
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -22,11 +32,11 @@ void test_vector_class() {
     // ======================================================
     {
         Vector<int> v1;
-        assert(v1.empty() && v1.capacity() == 10 && v1.size() == 0); // Test 1
+        assert(v1.empty() && v1.capacity() == 0 && v1.size() == 0 && v1.data() == nullptr); // Test 1
         ++test_counter;
 
         Vector<String> v2;
-        assert(v2.empty() && v2.capacity() == 10); // Test 2
+        assert(v2.empty() && v2.capacity() == 0); // Test 2
         ++test_counter;
     }
 
@@ -66,11 +76,13 @@ void test_vector_class() {
         assert(it != end); // Test 8
         ++test_counter;
 
+#if CONTAINERS_CHECKED
         bool caught = false;
         try { v.end()++; }
         catch (...) { caught = true; }
         assert(caught); // Test 9
         ++test_counter;
+#endif
     }
 
     // ======================================================
@@ -148,11 +160,265 @@ void test_vector_class() {
         ++test_counter;
     }
 
+    // ======================================================
+    // 8. Raw Storage (no default construction of capacity)
+    // ======================================================
+    {
+        struct NoDefault {
+            int value;
+            explicit NoDefault(int v) : value(v) {}
+        };
+
+        Vector<NoDefault> v;
+        v.reserve(64);
+        v.push_back(NoDefault(1));
+        v.push_back(NoDefault(2));
+        assert(v.size() == 2 && v[1].value == 2); // Test 21
+        ++test_counter;
+
+        struct Counted {
+            static int& alive() { static int counter = 0; return counter; }
+            Counted() { ++alive(); }
+            Counted(const Counted&) { ++alive(); }
+            Counted(Counted&&) noexcept { ++alive(); }
+            Counted& operator=(const Counted&) = default;
+            Counted& operator=(Counted&&) = default;
+            ~Counted() { --alive(); }
+        };
+
+        {
+            Vector<Counted> c;
+            c.reserve(1000);
+            assert(Counted::alive() == 0); // Test 22
+            ++test_counter;
+
+            c.resize(3);
+            c.shrink_to_fit();
+            c.erase(c.begin());
+            assert(Counted::alive() == 2); // Test 23
+            ++test_counter;
+        }
+        assert(Counted::alive() == 0); // Test 24
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 9. Relocation on Growth
+    // ======================================================
+    {
+        static_assert(is_trivially_relocatable_v<double>, "trivially copyable types relocate bytewise");
+        static_assert(is_trivially_relocatable_v<String>, "String opts in to bytewise relocation");
+        static_assert(!is_trivially_relocatable_v<std::string>, "std::string is relocated element by element");
+
+        Vector<String> vs;
+        for (int i = 0; i < 1000; ++i) {
+            vs.push_back(String(std::to_string(i).c_str()));
+        }
+        vs.push_back(vs[0]); // element of the vector itself while growing
+        assert(vs.size() == 1001 && vs[999] == "999" && vs[1000] == "0"); // Test 25
+        ++test_counter;
+
+        Vector<long long> vl;
+        for (long long i = 0; i < 100000; ++i) {
+            vl.push_back(i);
+        }
+        vl.shrink_to_fit();
+        assert(vl.capacity() == 100000 && vl[99999] == 99999); // Test 26
+        ++test_counter;
+
+        struct alignas(64) Wide { double value; };
+        Vector<Wide> vw;
+        for (int i = 0; i < 100; ++i) {
+            vw.push_back(Wide{ double(i) });
+        }
+        assert(reinterpret_cast<size_t>(vw.data()) % 64 == 0 && vw[99].value == 99.0); // Test 27
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 10. In-place Construction and Move Insertion
+    // ======================================================
+    {
+        struct Tracked {
+            static int& copies() { static int counter = 0; return counter; }
+            int a;
+            std::string b;
+            Tracked(int a_, const char* b_) : a(a_), b(b_) {}
+            Tracked(const Tracked& other) : a(other.a), b(other.b) { ++copies(); }
+            Tracked(Tracked&&) noexcept = default;
+            Tracked& operator=(const Tracked& other) { a = other.a; b = other.b; ++copies(); return *this; }
+            Tracked& operator=(Tracked&&) noexcept = default;
+        };
+
+        Vector<Tracked> v;
+        for (int i = 0; i < 100; ++i) {
+            Tracked& added = v.emplace_back(i, "payload");
+            assert(added.a == i);
+        }
+        v.push_back(Tracked(100, "moved"));
+        v.insert(Tracked(-1, "front"), v.begin());
+        auto it = v.emplace(v.begin() + 50, 42, "middle");
+        assert(Tracked::copies() == 0); // Test 28
+        assert(v.size() == 103 && v[0].a == -1 && (*it).b == "middle" && v[102].b == "moved"); // Test 29
+        test_counter += 2;
+
+        Vector<String> vs;
+        String big("heap owning payload");
+        vs.push_back(std::move(big));
+        assert(vs[0] == "heap owning payload" && big.size() == 0); // Test 30
+        ++test_counter;
+
+        vs.insert(vs[0], vs.begin()); // inserting a copy of its own element
+        assert(vs.size() == 2 && vs[0] == vs[1]); // Test 31
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 11. Access Policy (see Config.hpp)
+    // ======================================================
+    {
+        static_assert(std::is_same_v<Vector<float>::Iterator, float*> == !containers_checked,
+            "unchecked iterators are raw pointers");
+        static_assert(std::is_same_v<String::Iterator, char*> == !containers_checked,
+            "unchecked iterators are raw pointers");
+
+        Vector<float> v;
+        for (int i = 0; i < 64; ++i) {
+            v.push_back(float(i));
+        }
+        float sum = 0;
+        for (float x : v) {
+            sum += x;
+        }
+        for (size_t i = 0; i < v.size(); ++i) {
+            sum += v[i];
+        }
+        assert(sum == 2 * 2016.0f); // Test 32
+        ++test_counter;
+    }
+
     std::cout << "=== All " << test_counter << " vector tests passed! ===\n";
     glob_counter += test_counter;
 }
 
 
+void test_small_vector_class() {
+    std::cout << "\n=== SmallVector Class Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. Inline Storage
+    // ======================================================
+    {
+        SmallVector<int, 8> v;
+        assert(v.empty() && v.capacity() == 8 && v.is_inline()); // Test 1
+        ++test_counter;
+
+        for (int i = 0; i < 8; ++i) {
+            v.push_back(i);
+        }
+        assert(v.size() == 8 && v.is_inline() && v[7] == 7); // Test 2
+        ++test_counter;
+
+        v.push_back(8);
+        assert(!v.is_inline() && v.capacity() == 16 && v[8] == 8 && v[0] == 0); // Test 3
+        ++test_counter;
+
+        v.erase(v.begin() + 2, v.begin() + 6);
+        v.shrink_to_fit();
+        assert(v.is_inline() && v.size() == 5 && v[2] == 6); // Test 4
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 2. Modifiers
+    // ======================================================
+    {
+        SmallVector<String, 4> v{ "A", "B", "C" };
+        v.insert("X", v.begin() + 1);
+        v.emplace(v.begin(), "Y");
+        v.emplace_back("Z");
+        assert(v.size() == 6 && !v.is_inline()); // Test 5
+        assert(v.front() == "Y" && v[2] == "X" && v.back() == "Z"); // Test 6
+        test_counter += 2;
+
+        v.erase(v.begin());
+        v.pop_back();
+        v.resize(2);
+        assert(v.size() == 2 && v[0] == "A" && v[1] == "X"); // Test 7
+        ++test_counter;
+
+        v.resize(4, "R");
+        assert(v[3] == "R"); // Test 8
+        ++test_counter;
+
+        String sum;
+        for (auto& s : v) {
+            sum += s;
+        }
+        assert(sum == "AXRR"); // Test 9
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 3. Copy/Move Semantics (inline and heap states)
+    // ======================================================
+    {
+        SmallVector<std::string, 2> inline_v{ "a", "b" };
+        SmallVector<std::string, 2> heap_v{ "a", "b", "c" };
+
+        SmallVector<std::string, 2> inline_copy = inline_v;
+        SmallVector<std::string, 2> heap_copy = heap_v;
+        assert(inline_copy.is_inline() && inline_copy[1] == "b"); // Test 10
+        assert(!heap_copy.is_inline() && heap_copy[2] == "c"); // Test 11
+        test_counter += 2;
+
+        const std::string* heap_buffer = heap_v.data();
+        SmallVector<std::string, 2> heap_moved = std::move(heap_v);
+        assert(heap_moved.data() == heap_buffer && heap_v.empty() && heap_v.is_inline()); // Test 12
+        ++test_counter;
+
+        SmallVector<std::string, 2> inline_moved = std::move(inline_v);
+        assert(inline_moved.is_inline() && inline_moved[0] == "a" && inline_v.empty()); // Test 13
+        ++test_counter;
+
+        inline_moved = std::move(heap_moved);
+        assert(inline_moved.size() == 3 && !inline_moved.is_inline()); // Test 14
+        ++test_counter;
+
+        heap_copy.swap(inline_copy);
+        assert(heap_copy.size() == 2 && inline_copy.size() == 3 && inline_copy[2] == "c"); // Test 15
+        ++test_counter;
+
+        heap_copy = heap_copy;
+        inline_copy = heap_copy;
+        assert(inline_copy.size() == 2 && inline_copy[0] == "a"); // Test 16
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 4. noexcept follows the element's move constructor
+    // ======================================================
+    {
+        struct MayThrow {
+            MayThrow() {}
+            MayThrow(const MayThrow&) {}
+            MayThrow(MayThrow&&) {}
+            MayThrow& operator=(const MayThrow&) { return *this; }
+        };
+        using Throwing = SmallVector<MayThrow, 2>;
+        using Strings = SmallVector<std::string, 2>;
+        assert(!std::is_nothrow_move_constructible_v<Throwing> && !std::is_nothrow_move_assignable_v<Throwing> &&
+               !noexcept(std::declval<Throwing&>().swap(std::declval<Throwing&>()))); // Test 17
+        assert(std::is_nothrow_move_constructible_v<Strings> && std::is_nothrow_move_assignable_v<Strings>); // Test 18
+        test_counter += 2;
+    }
+
+    std::cout << "=== All " << test_counter << " small vector tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
 void test_array_class() {
     std::cout << "\n=== Array Class Test ===\n";
     int test_counter = 0;
@@ -190,16 +456,18 @@ void test_array_class() {
         assert(a[0] == 99); // Test 5
         ++test_counter;
 
+#if CONTAINERS_CHECKED
         bool caught = false;
         try { a[5]; }
         catch (...) { caught = true; }
         assert(caught); // Test 6
         ++test_counter;
+#endif
 
-        caught = false;
+        bool overflow = false;
         try { a.push_back(30); a.push_back(40); }
-        catch (...) { caught = true; }
-        assert(caught); // Test 7
+        catch (...) { overflow = true; }
+        assert(overflow); // Test 7
         ++test_counter;
     }
 
@@ -450,12 +718,14 @@ void test_array_class() {
         Array<int, 1> a;
         a.push_back(5);
 
+#if CONTAINERS_CHECKED
         auto it = a.end();
         bool caught = false;
         try { *it; }
         catch (...) { caught = true; }
         assert(caught); // Test 36
         ++test_counter;
+#endif
     }
 
     // ======================================================
@@ -520,7 +790,7 @@ void test_string_class() {
     // ======================================================
     {
         String s1;
-        assert(s1.is_empty() && s1.capacity() == 1); // Test 1
+        assert(s1.is_empty() && s1.capacity() == 0); // Test 1
         ++test_counter;
 
         String s2("Hello");
@@ -528,7 +798,7 @@ void test_string_class() {
         ++test_counter;
 
         String s3("");
-        assert(s3.is_empty() && s3.capacity() == 1); // Test 3
+        assert(s3.is_empty() && s3.capacity() == 0); // Test 3
         ++test_counter;
 
         bool exception = false;
@@ -796,7 +1066,7 @@ void test_string_class() {
     {
         String s;
         s.reserve(0); // Should be no-op
-        assert(s.capacity() == 1); // Test 51
+        assert(s.capacity() == 0); // Test 51
         ++test_counter;
 
         s = "A";
@@ -860,6 +1130,7 @@ void test_string_class() {
         assert(!(it >= it2)); // Test 63
         ++test_counter;
 
+#if CONTAINERS_CHECKED
         // Bounds checking
         bool exception = false;
         try {
@@ -871,6 +1142,7 @@ void test_string_class() {
         }
         assert(exception); // Test 64
         ++test_counter;
+#endif
 
         // Empty string iteration
         String empty;
@@ -901,6 +1173,38 @@ void test_string_class() {
         ++test_counter;
     }
 
+    // ======================================================
+    // 14. Empty Strings Own No Memory
+    // ======================================================
+    {
+        String moved("payload");
+        String target(std::move(moved));
+        moved.clear();
+        moved.shrink_to_fit();
+        assert(moved.capacity() == 0 && moved.begin() == moved.end()); // Test 69
+        ++test_counter;
+
+        moved += "again";
+        moved.push_back('!');
+        String copy_of_empty = String();
+        copy_of_empty = String("");
+        assert(moved == "again!" && copy_of_empty.capacity() == 0); // Test 70
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 15. Postfix Increment and Decrement
+    // ======================================================
+    {
+        String s("abc");
+        String::Iterator it = s.begin() + 1;
+        String::Iterator before = it--;
+        assert(*before == 'b' && *it == 'a'); // Test 71
+        String::Iterator after = it++;
+        assert(*after == 'a' && *it == 'b'); // Test 72
+        test_counter += 2;
+    }
+
     std::cout << "=== All " << test_counter << " string tests passed! ===\n";
     glob_counter += test_counter;
 }
@@ -1028,6 +1332,43 @@ void test_stack_class() {
         ++test_counter;
     }
 
+    // ======================================================
+    // 6. Growth with relocation
+    // ======================================================
+    {
+        Stack<String> s;
+        for (int i = 0; i < 500; ++i) {
+            s.push(String(std::to_string(i).c_str()));
+        }
+        assert(s.size() == 500 && s.top() == "499");   // Test 24
+        ++test_counter;
+
+        Stack<std::string> s2(1);
+        for (int i = 0; i < 500; ++i) {
+            s2.push(std::to_string(i));
+        }
+        Stack<std::string> s3;
+        s3 = s2;
+        assert(s3.size() == 500 && s3.top() == "499"); // Test 25
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 7. Lazy allocation and moved-from reuse
+    // ======================================================
+    {
+        Stack<String> s;
+        assert(s.capacity() == 0);                // Test 26
+        ++test_counter;
+
+        s.push("A");
+        Stack<String> s2 = std::move(s);
+        assert(s.capacity() == 0 && s.empty());   // Test 27
+        s.push("B");
+        assert(s.top() == "B" && s2.top() == "A"); // Test 28
+        test_counter += 2;
+    }
+
     std::cout << "=== All " << test_counter << " stack tests passed! ===\n";
     glob_counter += test_counter;
 }
@@ -1043,13 +1384,13 @@ void test_deque_class() {
         Deque<String> d1;
         assert(d1.empty());
         assert(d1.size() == 0);
-        assert(d1.max_size() >= 1);
+        assert(d1.max_size() == 0);
         test_counter += 3;
 
         //Initial capacity
         Deque<std::string> d2(15);
         assert(d2.empty());
-        assert(d2.max_size() == 15);
+        assert(d2.max_size() >= 15);
         test_counter += 2;
 
         //Initializer list constructor
@@ -1084,7 +1425,7 @@ void test_deque_class() {
         d.push_back(1);
         d.push_back(2);
         d.push_back(3);
-        assert(d.max_size() == 3);
+        assert(d.max_size() >= 3);
         assert(d.size() == 3);
 
         d.pop_front();
@@ -1351,12 +1692,14 @@ void test_deque_class() {
         for (int i = 0; i < 100; ++i) {
             d5.push_back(i);
         }
+#if CONTAINERS_CHECKED
         try {
             *it == 1;  // Iterator should not remain valid
         }
         catch (...) {
             assert(true);
         }
+#endif
         ++test_counter;
 
         // Test 30: Iterator arithmetic operations
@@ -1388,6 +1731,185 @@ void test_deque_class() {
         test_counter += 2;
     }
 
+    // ====================== GROWTH OF A WRAPPED RING ======================
+    {
+        // Test 33: both parts of a wrapped ring are relocated in order
+        Deque<String> d(4);
+        d.push_back("C");
+        d.push_back("D");
+        d.push_front("B");
+        d.push_front("A");
+        d.push_back("E");
+        assert(d.size() == 5);
+        assert(d[0] == "A" && d[2] == "C" && d[4] == "E");
+        test_counter += 2;
+
+        // Test 34: non-relocatable payload, copies and middle edits
+        Deque<std::string> d2;
+        for (int i = 0; i < 50; ++i) {
+            d2.push_front(std::to_string(i));
+        }
+        d2.insert(d2.begin() + 10, 3, "X");
+        d2.erase(d2.begin() + 20, d2.begin() + 30);
+        Deque<std::string> d3 = d2;
+        d3 = d2;
+        assert(d3.size() == 43);
+        assert(d3[0] == "49" && d3[10] == "X" && d3[13] == "39");
+        test_counter += 2;
+    }
+
+    // ====================== LAZY ALLOCATION ======================
+    {
+        // Test 35: moved-from deques own no memory and can be reused
+        Deque<String> d;
+        d.push_back("A");
+        Deque<String> d2 = std::move(d);
+        assert(d.max_size() == 0 && d.empty() && d.begin() == d.end());
+        d.push_front("B");
+        d.push_back("C");
+        assert(d.size() == 2 && d.front() == "B" && d2.front() == "A");
+        test_counter += 2;
+
+        // Test 36: clear keeps the buffer
+        size_t capacity = d.max_size();
+        d.clear();
+        assert(d.empty() && d.max_size() == capacity);
+        ++test_counter;
+    }
+
+    // ====================== BLOCK STORAGE ======================
+    {
+        // Test 37: growth at both ends never moves an element
+        Deque<std::string> d;
+        d.push_back("first");
+        const std::string* first = &d.front();
+        for (int i = 0; i < 5000; ++i) {
+            d.push_back(std::to_string(i));
+            d.push_front(std::to_string(-i));
+        }
+        assert(first == &d[5000] && *first == "first");
+        assert(d.front() == "-4999" && d.back() == "4999" && d.size() == 10001);
+        test_counter += 2;
+
+        // Test 38: positions across blocks and map growth stay in order
+        Deque<int> d2;
+        for (int i = 0; i < 3000; ++i) {
+            d2.push_front(-i - 1);
+            d2.push_back(i);
+        }
+        bool ordered = true;
+        int expected = -3000;
+        for (auto it = d2.begin(); it != d2.end(); ++it) {
+            ordered = ordered && *it == expected++;
+        }
+        assert(ordered && d2[0] == -3000 && d2[5999] == 2999 && d2.at(3000) == 0);
+        ++test_counter;
+
+        // Test 39: a queue that drains as fast as it fills reuses its blocks
+        Deque<int> queue;
+        for (int i = 0; i < 1000; ++i) {
+            queue.push_back(i);
+        }
+        size_t warm_capacity = 0;
+        for (int i = 1000; i < 100000; ++i) {
+            queue.pop_front();
+            queue.push_back(i);
+            if (i == 2000) {
+                warm_capacity = queue.max_size();
+            }
+        }
+        assert(queue.max_size() == warm_capacity && queue.front() == 99000 && queue.back() == 99999);
+        ++test_counter;
+
+        // Test 40: copies, middle edits and at() on a multi-block deque
+        Deque<std::string> d3 = d;
+        d3.insert(d3.begin() + 4000, 2, "mid");
+        d3.erase(d3.begin() + 10, d3.begin() + 20);
+        assert(d3.size() == 9993 && d3[3990] == "mid" && d3[3991] == "mid" && d3[3992] == "-999");
+        bool thrown = false;
+        try { d3.at(d3.size()); }
+        catch (const std::out_of_range&) { thrown = true; }
+        assert(thrown && d.size() == 10001);
+        test_counter += 2;
+    }
+
+    // ====================== CONTIGUOUS RUNS ======================
+    {
+        // Test 41: iterators cross block boundaries in both directions
+        Deque<int> d;
+        for (int i = 0; i < 2500; ++i) {
+            d.push_front(-i - 1);
+            d.push_back(i);
+        }
+        long long forward = 0;
+        for (auto it = d.begin(); it != d.end(); ++it) {
+            forward += *it;
+        }
+        auto it = d.end();
+        int expected = 2499;
+        bool backward = true;
+        while (it != d.begin()) {
+            --it;
+            backward = backward && *it == expected--;
+        }
+        assert(forward == -2500 && backward && *(d.begin() + 3000) == 500 && *(d.end() - 1) == 2499);
+        test_counter += 2;
+
+        // Test 42: shifts of trivially copyable elements, the inserted value may be an element
+        d.insert(d.begin() + 1, d[4999]);
+        assert(d[1] == 2499 && d[0] == -2500 && d[2] == -2499 && d.size() == 5001);
+        d.insert(d.begin() + 2600, 3, d[0]);
+        d.erase(d.begin() + 1);
+        d.erase(d.begin() + 100, d.begin() + 2000);
+        assert(d.size() == 3103 && d[99] == -2401 && d[100] == -500);
+        assert(d[698] == 98 && d[699] == -2500 && d[701] == -2500 && d[702] == 99);
+        test_counter += 2;
+
+        // Test 43: copies of a deque that starts in the middle of a block
+        Deque<int> copy = d;
+        Deque<int> assigned;
+        assigned.push_back(7);
+        assigned = d;
+        copy[0] = 1;
+        assert(d[0] == -2500 && copy[1] == d[1] && assigned[3101] == d[3101] && assigned.size() == d.size());
+        ++test_counter;
+    }
+
+    // ====================== SHORTER SIDE EDITS ======================
+    {
+        // Test 44: an edit near the front moves only the elements before it
+        Deque<int> d;
+        for (int i = 0; i < 10000; ++i) {
+            d.push_back(i);
+        }
+        const int* tail = &d[5000];
+        d.insert(d.begin() + 3, 2, -1);
+        d.erase(d.begin() + 1);
+        d.erase(d.begin() + 10, d.begin() + 20);
+        assert(tail == &d[4991] && *tail == 5000);
+        assert(d[0] == 0 && d[1] == 2 && d[2] == -1 && d[3] == -1 && d[4] == 3 && d[10] == 19);
+        test_counter += 2;
+
+        // Test 45: an edit near the back moves only the elements after it
+        const int* head = &d[100];
+        d.insert(d.end() - 2, 7);
+        d.erase(d.end() - 5, d.end() - 3);
+        assert(head == &d[100] && d.size() == 9990 && d[9987] == 7 && d[9986] == 9995 && d.back() == 9999);
+        test_counter += 1;
+
+        // Test 46: front side moves of non-trivial elements, into raw and live slots
+        Deque<std::string> s;
+        for (int i = 0; i < 40; ++i) {
+            s.push_back(std::to_string(i));
+        }
+        s.insert(s.begin() + 2, 5, "x");
+        assert(s.size() == 45 && s[0] == "0" && s[1] == "1" && s[2] == "x" && s[6] == "x" && s[7] == "2");
+        s.insert(s.begin() + 8, 1, s[0]);
+        s.erase(s.begin() + 1, s.begin() + 7);
+        assert(s.size() == 40 && s[0] == "0" && s[1] == "2" && s[2] == "0" && s[3] == "3" && s[39] == "39");
+        test_counter += 2;
+    }
+
     std::cout << "=== All " << test_counter << " deque tests passed! ===\n";
     glob_counter += test_counter;
 }
@@ -1736,6 +2258,20 @@ void test_queue_class() {
         ++test_counter;
     }
 
+    // ======================================================
+    // 11. Lazy allocation and moved-from reuse
+    // ======================================================
+    {
+        Queue<String> q1;
+        q1.push("A");
+        Queue<String> q2(std::move(q1));
+        q1.push("B");
+        q1.push("C");
+        assert(q1.size() == 2 && q1.front() == "B");  // Test 69
+        assert(q2.front() == "A");                    // Test 70
+        test_counter += 2;
+    }
+
     std::cout << "=== All " << test_counter << " queue tests passed! ===\n";
     glob_counter += test_counter;
 }
@@ -2203,6 +2739,39 @@ void test_list_class() {
 }
 
 
+//Checks parent links, stored heights and sizes and the AVL balance of a subtree,
+//returns its height or -1 if something is wrong
+template<typename Node>
+int avl_subtree_height(const Node* node, const Node* parent) {
+    if (!node) {
+        return 0;
+    }
+    int left = avl_subtree_height(node->left, node);
+    int right = avl_subtree_height(node->right, node);
+    if (left < 0 || right < 0 || node->parent != parent || left - right > 1 || right - left > 1) {
+        return -1;
+    }
+    int height = (left > right ? left : right) + 1;
+    size_t size = (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0) + 1;
+    return (node->height == height && node->size == size) ? height : -1;
+}
+
+//Throws from its copy constructor once budget copies have been made (budget < 0: never)
+struct CopyLimited {
+    int value;
+    inline static int budget = -1;
+
+    CopyLimited(int v) : value(v) {}
+    CopyLimited(const CopyLimited& other) : value(other.value) {
+        if (budget == 0) {
+            throw std::runtime_error("copy budget exhausted");
+        }
+        --budget;
+    }
+    CopyLimited& operator=(const CopyLimited&) = default;
+    bool operator<(const CopyLimited& other) const { return value < other.value; }
+};
+
 void test_avl_tree_class() {
     std::cout << "\n=== AVL Tree Class Test ===\n";
     int test_counter = 0;
@@ -2538,14 +3107,1793 @@ void test_avl_tree_class() {
         ++test_counter;
     }
 
-    std::cout << "=== All " << test_counter << " AVL tree tests passed! ===\n";
-    glob_counter += test_counter;
-}
+    // ======================================================
+    // 6. Order statistics (Tests 65-77)
+    // ======================================================
+    {
+        AVLtree<int> t;
+        for (int i = 0; i < 100; ++i) {
+            t.insert((i * 37) % 100);                  // 0..99 in scrambled order
+        }
+        assert(t.get_root()->size == 100);             // Test 65
+        assert(t.rank(0) == 0 && t.rank(50) == 50 && t.rank(1000) == 100); // Test 66
+        assert(t.select(0) == 0 && t.select(42) == 42 && t.select(99) == 99); // Test 67
+        test_counter += 3;
+
+        bool thrown = false;
+        try { t.select(100); }
+        catch (const std::out_of_range&) { thrown = true; }
+        assert(thrown);                                // Test 68
+        ++test_counter;
+
+        auto it = t.nth(10);
+        it += 25;
+        assert(*it == 35);                             // Test 69
+        it -= 30;
+        assert(*it == 5);                              // Test 70
+        assert(*(t.begin() + 99) == 99 && (t.begin() + 100) == t.end()); // Test 71
+        assert(*(t.end() - 1) == 99 && (t.begin() - 1) == t.end()); // Test 72
+        test_counter += 4;
+
+        assert(t.count_range(10, 19) == 10 && t.count_range(95, 200) == 5); // Test 73
+        assert(t.count_range(20, 10) == 0 && t.count_range(-5, -1) == 0); // Test 74
+        test_counter += 2;
+
+        //Sizes stay correct through removals and rotations
+        for (int i = 0; i < 100; i += 2) {
+            t.remove(t.find(i));
+        }
+        assert(t.get_root()->size == 50 && t.rank(50) == 25 && t.select(25) == 51); // Test 75
+        t.insert(7);
+        assert(t.count_range(7, 7) == 2 && t.rank(8) == 5); // Test 76: duplicates count
+        test_counter += 2;
+
+        //A copy has its own parent links and sizes
+        AVLtree<int> copy(t);
+        assert(copy.select(50) == 99 && *(copy.nth(3) + 2) == 9); // Test 77
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 7. Bounds and range scans (Tests 78-86)
+    // ======================================================
+    {
+        AVLtree<int> t;
+        for (int i = 0; i < 50; ++i) {
+            t.insert((i * 13) % 50 * 2);               // even numbers 0..98
+        }
+        t.insert(40);
+        const AVLtree<int>& ct = t;
+
+        assert(*t.lower_bound(40) == 40 && *t.lower_bound(41) == 42); // Test 78
+        assert(*t.upper_bound(40) == 42 && *ct.upper_bound(-1) == 0); // Test 79
+        assert(t.lower_bound(99) == t.end() && ct.upper_bound(98) == ct.end()); // Test 80
+        test_counter += 3;
+
+        auto range = ct.equal_range(40);
+        size_t equal = 0;
+        for (auto it = range.first; it != range.second; ++it) {
+            assert(*it == 40);
+            ++equal;
+        }
+        assert(equal == 2);                            // Test 81
+        auto missing = t.equal_range(41);
+        assert(missing.first == missing.second && *missing.first == 42); // Test 82
+        test_counter += 2;
+
+        Vector<int> visited;
+        ct.for_each_in_range(11, 20, [&](const int& value) { visited.push_back(value); });
+        assert(visited.size() == 5 && visited[0] == 12 && visited[4] == 20); // Test 83
+        visited.clear();
+        t.for_each_in_range(100, 200, [&](const int& value) { visited.push_back(value); });
+        t.for_each_in_range(30, 10, [&](const int& value) { visited.push_back(value); });
+        assert(visited.empty());                       // Test 84
+        test_counter += 2;
 
+        //Iterator converts to ConstIterator, both compare with each other
+        AVLtree<int>::ConstIterator cit = t.lower_bound(10);
+        assert(cit == t.lower_bound(10) && *(cit + 2) == 14); // Test 85
+        int sum = 0;
+        for (auto it = ct.cbegin(); it != ct.cend(); ++it) {
+            sum += *it;
+        }
+        assert(sum == 2450 + 40);                      // Test 86
+        test_counter += 2;
+    }
+
+    // ======================================================
+    // 8. Bulk construction (Tests 87-94)
+    // ======================================================
+    {
+        Vector<int> sorted;
+        for (int i = 0; i < 1000; ++i) {
+            sorted.push_back(i / 2);                   // duplicates allowed
+        }
+        AVLtree<int> t(sorted.data(), sorted.data() + sorted.size());
+        assert(t.size() == 1000 && t.select(999) == 499); // Test 87
+        assert(avl_subtree_height(t.get_root(), (const AVLNode<int>*)nullptr) == 10); // Test 88: perfectly balanced
+        test_counter += 2;
+
+        //The tree stays a valid AVL tree when modified after the bulk build
+        t.insert(1000);
+        t.remove(t.find(0));
+        assert(avl_subtree_height(t.get_root(), (const AVLNode<int>*)nullptr) > 0 && t.count_range(0, 0) == 1); // Test 89
+        ++test_counter;
+
+        List<std::string> words({ "a", "b", "b", "c" });
+        AVLtree<std::string> w;
+        w.assign_sorted(words.begin(), words.end());
+        assert(w.size() == 4 && *w.begin() == "a" && w.rank("c") == 3); // Test 90
+        ++test_counter;
+
+        bool thrown = false;
+        List<int> unsorted({ 3, 1, 2 });
+        try { t.assign_sorted(unsorted.begin(), unsorted.end()); }
+        catch (const std::invalid_argument&) { thrown = true; }
+        assert(thrown && t.size() == 1000);            // Test 91: the tree is left untouched
+        ++test_counter;
+
+        t.assign(unsorted.begin(), unsorted.end());
+        assert(t.size() == 3 && t.select(0) == 1 && t.select(2) == 3); // Test 92
+        ++test_counter;
+
+        //Big enough for parallel_sort() to split the work across threads
+        Vector<int> scrambled;
+        for (int i = 0; i < 50000; ++i) {
+            scrambled.push_back((i * 7919) % 50000);
+        }
+        AVLtree<int> big(scrambled.data(), scrambled.data() + scrambled.size());
+        bool in_order = true;
+        int expected = 0;
+        for (int value : big) {
+            in_order = in_order && value == expected++;
+        }
+        assert(in_order && big.size() == 50000);       // Test 93
+        assert(avl_subtree_height(big.get_root(), (const AVLNode<int>*)nullptr) == 16); // Test 94
+        test_counter += 2;
+    }
+
+    // ======================================================
+    // 9. Split, join and set operations (Tests 95-107)
+    // ======================================================
+    {
+        const AVLNode<int>* no_parent = nullptr;
+        Vector<int> keys;
+        for (int i = 0; i < 200; ++i) {
+            keys.push_back(i);
+        }
+        AVLtree<int> t(keys.data(), keys.data() + keys.size());
+        AVLtree<int> upper = t.split(120);
+        assert(t.size() == 120 && upper.size() == 80 && t.select(119) == 119 && upper.select(0) == 120); // Test 95
+        assert(avl_subtree_height(t.get_root(), no_parent) > 0 && avl_subtree_height(upper.get_root(), no_parent) > 0); // Test 96
+        test_counter += 2;
+
+        //Very different heights on both sides
+        AVLtree<int> rest = upper.split(125);          // upper keeps 120..124
+        AVLtree<int> joined = AVLtree<int>::join(std::move(t), 119, std::move(upper));
+        assert(joined.size() == 126 && joined.count_range(119, 119) == 2 && t.empty() && upper.empty()); // Test 97
+        assert(avl_subtree_height(joined.get_root(), no_parent) > 0);  // Test 98
+        test_counter += 2;
+
+        bool thrown = false;
+        try { AVLtree<int>::join(std::move(joined), 50, std::move(rest)); }
+        catch (const std::invalid_argument&) { thrown = true; }
+        assert(thrown && joined.size() == 126);        // Test 99
+        ++test_counter;
+
+        //Trees with their own allocators are copied into the result
+        AVLtree<int> separate({ 300, 301 });
+        AVLtree<int> all = AVLtree<int>::join(std::move(rest), 299, std::move(separate));
+        assert(all.size() == 78 && all.select(75) == 299 && all.select(77) == 301); // Test 100
+        test_counter += 1;
+
+        //Sets of multiples of 2 and of 3
+        AVLtree<int> twos, threes;
+        for (int i = 0; i < 3000; ++i) {
+            twos.insert(i * 2);
+            threes.insert(i * 3);
+        }
+        twos.insert(6);                                // a duplicate in this tree stays
+
+        AVLtree<int> u(twos);
+        u.union_with(threes);
+        assert(u.size() == 3001 + 3000 - 1000);        // Test 101
+        assert(u.count_range(6, 6) == 2 && u.contains(8997) && u.rank(9) == 7); // Test 102
+        assert(avl_subtree_height(u.get_root(), no_parent) > 0); // Test 103
+        test_counter += 3;
+
+        AVLtree<int> in(twos);
+        in.intersect_with(threes);
+        assert(in.size() == 1001 && in.select(2) == 6 && in.select(3) == 12); // Test 104
+        AVLtree<int> diff(twos);
+        diff.difference_with(threes);
+        assert(diff.size() == 2000 && !diff.contains(6) && diff.contains(4)); // Test 105
+        test_counter += 2;
+
+        //Duplicates in other are added only once
+        AVLtree<int> dup({ 1, 5, 5, 5, 9 });
+        AVLtree<int> base({ 5 });
+        base.union_with(dup);
+        assert(base.size() == 3 && base.count_range(5, 5) == 1); // Test 106
+        dup.union_with(AVLtree<int>({ 2, 2, 7 }));
+        assert(dup.size() == 7 && dup.count_range(2, 2) == 1 && avl_subtree_height(dup.get_root(), no_parent) > 0); // Test 107
+        test_counter += 2;
+    }
+
+    // ======================================================
+    // 10. Erase by iterator and by key (Tests 108-113)
+    // ======================================================
+    {
+        const AVLNode<int>* no_parent = nullptr;
+        AVLtree<int> t;
+        for (int i = 0; i < 64; ++i) {
+            t.insert((i * 29) % 64);
+        }
+        //The root has two children, its successor is relinked into its place
+        int root_value = t.get_root()->data;
+        auto successor = t.upper_bound(root_value);
+        auto next = t.erase(t.lower_bound(root_value));
+        assert(next == successor && *successor == root_value + 1); // Test 108: the successor iterator stays valid
+        assert(t.size() == 63 && !t.contains(root_value) && avl_subtree_height(t.get_root(), no_parent) > 0); // Test 109
+        test_counter += 2;
+
+        assert(t.erase(t.find(63) ? t.lower_bound(63) : t.end()) == t.end()); // Test 110: erasing the last
+        ++test_counter;
+
+        bool thrown = false;
+        try { t.erase(t.end()); }
+        catch (const std::out_of_range&) { thrown = true; }
+        assert(thrown);                                // Test 111
+        ++test_counter;
+
+        t.insert(10);
+        t.insert(10);
+        assert(t.erase(10) == 3 && !t.contains(10) && t.erase(10) == 0); // Test 112
+        ++test_counter;
+
+        //Erasing everything while iterating
+        size_t erased = 0;
+        for (auto it = t.begin(); it != t.end(); ++erased) {
+            it = t.erase(it);
+            assert(avl_subtree_height(t.get_root(), no_parent) >= 0);
+        }
+        assert(erased == 61 && t.empty() && t.get_root() == nullptr); // Test 113
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 11. Iterative copy, clear and height (Tests 114-117)
+    // ======================================================
+    {
+        const AVLNode<int>* no_parent = nullptr;
+        AVLtree<int> source;
+        for (int i = 0; i < 100000; ++i) {
+            source.insert(i);
+        }
+
+        //The copy is checked against its own parent links, none may point into the source
+        AVLtree<int> copy(source);
+        assert(copy.size() == 100000 && copy.get_root() != source.get_root() &&
+               avl_subtree_height(copy.get_root(), no_parent) == copy.get_root()->height &&
+               copy.select(77777) == 77777);           // Test 114
+        ++test_counter;
+
+        assert(copy.height(copy.get_root()) == static_cast<size_t>(source.get_root()->height) &&
+               copy.height(nullptr) == 0);             // Test 115
+        ++test_counter;
+
+        //A copy that fails half way frees what it built and leaves the source alone
+        AVLtree<CopyLimited, std::less<CopyLimited>, std::allocator<CopyLimited>> limited;
+        for (int i = 0; i < 1000; ++i) {
+            limited.insert(CopyLimited(i));
+        }
+        bool thrown = false;
+        CopyLimited::budget = 500;
+        try { AVLtree<CopyLimited, std::less<CopyLimited>, std::allocator<CopyLimited>> failed(limited); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CopyLimited::budget = -1;
+        assert(thrown && limited.size() == 1000 && avl_subtree_height(limited.get_root(),
+               (const AVLNode<CopyLimited>*)nullptr) > 0); // Test 116
+        ++test_counter;
+
+        //clear() node by node (std::allocator) and through the pool with destructors to run
+        AVLtree<int, std::less<int>, std::allocator<int>> plain(source.begin(), source.end());
+        plain.clear();
+        AVLtree<String> strings;
+        for (int i = 0; i < 1000; ++i) {
+            strings.insert(String(std::to_string(i).c_str()));
+        }
+        AVLtree<String> strings_copy(strings);
+        strings.clear();
+        plain.insert(1);
+        assert(plain.size() == 1 && strings.empty() && strings_copy.size() == 1000 &&
+               strings_copy.contains(String("999")));  // Test 117
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 12. ThreadPool (Tests 118-119)
+    // ======================================================
+    {
+        //Nested fork-join on fewer workers than tasks must not deadlock
+        ThreadPool pool(2);
+        std::atomic<int> sum(0);
+        TaskGroup outer(pool);
+        for (int i = 0; i < 8; ++i) {
+            outer.run([&pool, &sum, i] {
+                TaskGroup inner(pool);
+                for (int j = 0; j < 8; ++j) {
+                    inner.run([&sum, i, j] { sum += i * 8 + j; });
+                }
+                inner.wait();
+            });
+        }
+        outer.wait();
+        assert(sum == 63 * 64 / 2);                    // Test 118
+        ++test_counter;
+
+        bool thrown = false;
+        TaskGroup failing(pool);
+        failing.run([] { throw std::runtime_error("task failed"); });
+        failing.run([] {});
+        try { failing.wait(); }
+        catch (const std::runtime_error&) { thrown = true; }
+        assert(thrown);                                // Test 119
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 13. Augmented summaries (Tests 120-122)
+    // ======================================================
+    {
+        AVLtree<int, std::less<int>, PoolAllocator<int>, AVLIdentity, AVLSum<long long>> sums;
+        for (int i = 0; i < 500; ++i) {
+            sums.insert((i * 211) % 500);
+        }
+        for (int i = 0; i < 500; i += 3) {
+            sums.erase(i);
+        }
+        bool all_match = true;
+        for (int low = -5; low < 505; low += 7) {
+            for (int high = low; high < 510; high += 37) {
+                long long expected = 0;
+                for (int value : sums) {
+                    expected += value >= low && value <= high ? value : 0;
+                }
+                all_match = all_match && sums.range_sum(low, high) == expected;
+            }
+        }
+        long long total = 0;
+        for (int value : sums) {
+            total += value;
+        }
+        assert(all_match && sums.summary() == total && sums.range_sum(10, 5) == 0); // Test 120
+        ++test_counter;
+
+        //Summaries follow split, the set operations and the copy and bulk paths as well
+        auto upper = sums.split(250);
+        auto copy = upper;
+        copy.insert(1000);
+        bool split_sums = sums.summary() + upper.summary() == total && sums.range_sum(250, 499) == 0;
+        sums.union_with(upper);
+        assert(split_sums && sums.summary() == total && copy.summary() == sums.range_sum(250, 499) + 1000); // Test 121
+        ++test_counter;
+
+        int sorted[] = { 7, 3, 9, 1, 5 };
+        AVLtree<int, std::less<int>, PoolAllocator<int>, AVLIdentity, AVLMin<int>> mins(sorted, sorted + 5);
+        AVLtree<int, std::less<int>, PoolAllocator<int>, AVLIdentity, AVLMax<int>> maxes(sorted, sorted + 5);
+        assert(mins.summary() == 1 && mins.range_sum(2, 8) == 3 && maxes.range_sum(2, 8) == 7 &&
+               maxes.range_sum(10, 20) == std::numeric_limits<int>::lowest()); // Test 122
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 14. Hinted insertion and cached ends (Tests 123-126)
+    // ======================================================
+    {
+        AVLtree<int> t;
+        for (int i = 0; i < 1000; ++i) {
+            t.append_max(i / 2);
+        }
+        bool thrown = false;
+        try {
+            t.append_max(5);
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown && t.size() == 1000 && *t.begin() == 0 && t.select(999) == 499 &&
+               avl_subtree_height(t.get_root(), (const AVLNode<int>*)nullptr) > 0); // Test 123
+        ++test_counter;
+
+        //Right hints compare only the neighbours, wrong ones fall back to the descent
+        static size_t comparisons;
+        struct CountingLess {
+            bool operator()(int a, int b) const {
+                ++comparisons;
+                return a < b;
+            }
+        };
+        comparisons = 0;
+        AVLtree<int, CountingLess> hinted;
+        for (int i = 0; i < 1000; ++i) {
+            hinted.insert(hinted.end(), i);
+        }
+        for (int i = -1; i >= -1000; --i) {
+            hinted.insert(hinted.begin(), i);
+        }
+        size_t right_hints = comparisons;
+        auto it = hinted.insert(hinted.begin(), 500);
+        hinted.insert(hinted.lower_bound(10), 10);
+        int expected = -1000;
+        bool ordered = true;
+        for (int value : hinted) {
+            ordered = ordered && value >= expected;
+            expected = value;
+        }
+        assert(right_hints <= 4000 && *it == 500 && ordered && hinted.count_range(10, 10) == 2 && hinted.count_range(500, 500) == 2 &&
+               avl_subtree_height(hinted.get_root(), (const AVLNode<int>*)nullptr) > 0); // Test 124
+        ++test_counter;
+
+        //The cached smallest and largest nodes follow erase, split, set operations and moves
+        AVLtree<int> ends({ 1, 2, 3, 4, 5, 6, 7, 8 });
+        ends.erase(1);
+        ends.erase(8);
+        bool after_erase = *ends.begin() == 2 && *ends.insert(ends.end(), 7) == 7 && ends.select(ends.size() - 1) == 7;
+        AVLtree<int> upper = ends.split(5);
+        bool after_split = *ends.begin() == 2 && *upper.begin() == 5 && *ends.append_max(4) == 4 && *upper.append_max(9) == 9;
+        ends.union_with(upper);
+        AVLtree<int> moved(std::move(ends));
+        bool after_move = ends.begin() == ends.end() && *moved.begin() == 2 && *moved.append_max(10) == 10 &&
+                          moved.select(moved.size() - 1) == 10;
+        moved.clear();
+        assert(after_erase && after_split && after_move && moved.begin() == moved.end() && *moved.append_max(3) == 3); // Test 125
+        ++test_counter;
+
+        thrown = false;
+        try {
+            moved.insert(upper.begin(), 4);
+        }
+        catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown && moved.size() == 1);           // Test 126: the hint must come from the same tree
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 15. Union with duplicates in other (Tests 127-129)
+    // ======================================================
+    {
+        const AVLNode<int>* no_parent = nullptr;
+        AVLtree<int> empty;
+        empty.union_with(AVLtree<int>({ 8, 8 }));
+        assert(empty.size() == 1 && *empty.begin() == 8); // Test 127
+        ++test_counter;
+
+        AVLtree<int> zero({ 0 });
+        zero.union_with(AVLtree<int>({ 1, 2, 4, 5, 5 }));
+        int expected[] = { 0, 1, 2, 4, 5 };
+        bool same = zero.size() == 5;
+        int i = 0;
+        for (int value : zero) {
+            same = same && i < 5 && value == expected[i++];
+        }
+        assert(same);                                  // Test 128
+        ++test_counter;
+
+        //Every key keeps its copies in this tree, or gets one copy if only other has it
+        bool counts_match = true;
+        unsigned seed = 12345;
+        for (int round = 0; round < 40; ++round) {
+            int keys = round % 2 ? 64 : 8000;
+            int mine_count[8000] = {};
+            int their_count[8000] = {};
+            AVLtree<int> mine, theirs;
+            int total = round % 4 < 2 ? keys / 2 : keys * 3;
+            for (int j = 0; j < total; ++j) {
+                seed = seed * 1103515245 + 12345;
+                int key = static_cast<int>((seed >> 8) % keys);
+                if (seed & 1) {
+                    mine.insert(key);
+                    ++mine_count[key];
+                }
+                else {
+                    theirs.insert(key);
+                    ++their_count[key];
+                }
+            }
+            mine.union_with(theirs);
+            size_t size = 0;
+            for (int key = 0; key < keys; ++key) {
+                size_t want = mine_count[key] ? mine_count[key] : (their_count[key] ? 1 : 0);
+                counts_match = counts_match && mine.count_range(key, key) == want;
+                size += want;
+            }
+            counts_match = counts_match && mine.size() == size && avl_subtree_height(mine.get_root(), no_parent) > 0;
+        }
+        assert(counts_match);                          // Test 129
+        ++test_counter;
+    }
+
+    std::cout << "=== All " << test_counter << " AVL tree tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
+// Allocator that books every allocation in an AllocStats, used by test_allocators().
+// Propagate switches all three propagate_on_container_* traits.
+struct AllocStats {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t live_bytes = 0;
+};
+
+template<typename T, bool Propagate = false>
+struct CountingAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+    template<typename U>
+    struct rebind {
+        using other = CountingAllocator<U, Propagate>;
+    };
+
+    AllocStats* stats;
+
+    CountingAllocator(AllocStats* stats_) : stats(stats_) {}
+
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U, Propagate>& other) : stats(other.stats) {}
+
+    T* allocate(size_t count) {
+        ++stats->allocations;
+        stats->live_bytes += count * sizeof(T);
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t count) {
+        ++stats->deallocations;
+        stats->live_bytes -= count * sizeof(T);
+        ::operator delete(ptr);
+    }
+
+    bool operator==(const CountingAllocator& other) const {
+        return stats == other.stats;
+    }
+
+    bool operator!=(const CountingAllocator& other) const {
+        return stats != other.stats;
+    }
+};
+
+void test_allocators() {
+    std::cout << "\n=== Allocator Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. Contiguous containers allocate through Alloc
+    // ======================================================
+    {
+        AllocStats stats;
+        {
+            Vector<int, CountingAllocator<int>> v(&stats);
+            assert(stats.allocations == 0);                                   // Test 1
+            for (int i = 0; i < 100; ++i) {
+                v.push_back(i);
+            }
+            assert(stats.allocations > 0 && stats.live_bytes == v.capacity() * sizeof(int)); // Test 2
+            v.shrink_to_fit();
+            assert(stats.live_bytes == 100 * sizeof(int) && v[99] == 99);     // Test 3
+            test_counter += 3;
+
+            Stack<int, CountingAllocator<int>> s(&stats);
+            Queue<int, CountingAllocator<int>> q(&stats);
+            Deque<int, CountingAllocator<int>> d(&stats);
+            for (int i = 0; i < 50; ++i) {
+                s.push(i);
+                q.push(i);
+                d.push_front(i);
+            }
+            assert(stats.allocations - stats.deallocations == 5);            // Test 4: one buffer per container, the deque a block and its map
+            assert(s.top() == 49 && q.front() == 0 && d.front() == 49);      // Test 5
+            test_counter += 2;
+        }
+        assert(stats.live_bytes == 0 && stats.allocations == stats.deallocations); // Test 6
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 2. String and SmallVector
+    // ======================================================
+    {
+        AllocStats stats;
+        {
+            BasicString<CountingAllocator<char>> str("hello", &stats);
+            str += "_world";
+            str.push_back('!');
+            assert(str.size() == 12 && stats.live_bytes == str.capacity());  // Test 7
+            str.shrink_to_fit();
+            assert(stats.live_bytes == 13 && str.capacity() == 13);          // Test 8
+            test_counter += 2;
+
+            SmallVector<int, 4, CountingAllocator<int>> sv(&stats);
+            size_t before = stats.allocations;
+            for (int i = 0; i < 4; ++i) {
+                sv.push_back(i);
+            }
+            assert(stats.allocations == before && sv.is_inline());           // Test 9
+            sv.push_back(4);
+            assert(stats.allocations == before + 1 && !sv.is_inline());      // Test 10
+            test_counter += 2;
+        }
+        assert(stats.live_bytes == 0 && stats.allocations == stats.deallocations); // Test 11
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 3. Node containers rebind Alloc to their node type
+    // ======================================================
+    {
+        AllocStats stats;
+        {
+            List<String, CountingAllocator<String>> l(&stats);
+            AVLtree<int, std::less<int>, CountingAllocator<int>> tree(&stats);
+            for (int i = 0; i < 20; ++i) {
+                l.push_back("node");
+                tree.insert(i);
+            }
+            assert(stats.allocations == 40 && stats.deallocations == 0);     // Test 12
+            l.pop_front();
+            tree.remove(tree.find(7));
+            assert(stats.deallocations == 2 && l.size() == 19 && tree.size() == 19); // Test 13
+            test_counter += 2;
+
+            AVLtree<int, std::less<int>, CountingAllocator<int>> copy(tree);
+            assert(copy.size() == 19 && copy.contains(19) && !copy.contains(7)); // Test 14
+            ++test_counter;
+        }
+        assert(stats.live_bytes == 0 && stats.allocations == stats.deallocations); // Test 15
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 4. Propagation on copy, move and swap
+    // ======================================================
+    {
+        AllocStats stats_a, stats_b;
+        {
+            //Allocators that do not propagate stay with their container
+            Vector<String, CountingAllocator<String>> a({ "x", "y" }, &stats_a);
+            Vector<String, CountingAllocator<String>> b({ "1", "2", "3" }, &stats_b);
+            a = b;
+            assert(a.get_allocator().stats == &stats_a && a.size() == 3 && a[2] == "3"); // Test 16
+
+            a = std::move(b);
+            assert(a.get_allocator().stats == &stats_a && a[0] == "1" && b.empty()); // Test 17
+
+            Deque<int, CountingAllocator<int>> d1({ 1, 2 }, &stats_a);
+            Deque<int, CountingAllocator<int>> d2({ 3 }, &stats_b);
+            d1 = std::move(d2);
+            assert(d1.get_allocator().stats == &stats_a && d1.size() == 1 && d1.front() == 3); // Test 18
+            test_counter += 3;
+
+            //Allocators that propagate follow the elements
+            List<int, CountingAllocator<int, true>> l1({ 1 }, &stats_a);
+            List<int, CountingAllocator<int, true>> l2({ 2, 3 }, &stats_b);
+            l1 = l2;
+            assert(l1.get_allocator().stats == &stats_b && l1.size() == 2);  // Test 19
+
+            Stack<int, CountingAllocator<int, true>> s1({ 1 }, &stats_a);
+            Stack<int, CountingAllocator<int, true>> s2({ 2 }, &stats_b);
+            s1.swap(s2);
+            assert(s1.get_allocator().stats == &stats_b && s1.top() == 2 && s2.top() == 1); // Test 20
+            test_counter += 2;
+        }
+        assert(stats_a.live_bytes == 0 && stats_b.live_bytes == 0);          // Test 21
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 5. PolymorphicAllocator and MemoryResource
+    // ======================================================
+    {
+        alignas(std::max_align_t) char buffer[4096];
+        MonotonicResource arena(buffer, sizeof(buffer));
+
+        Vector<int, PolymorphicAllocator<int>> v(&arena);
+        for (int i = 0; i < 100; ++i) {
+            v.push_back(i);
+        }
+        assert(v.data() >= reinterpret_cast<int*>(buffer) && v.data() < reinterpret_cast<int*>(buffer + sizeof(buffer))); // Test 22
+        ++test_counter;
+
+        //Copies use the default resource, move assignment between resources moves the elements
+        Vector<int, PolymorphicAllocator<int>> copy(v);
+        assert(copy.get_allocator().resource() == get_default_resource() && copy[99] == 99); // Test 23
+        copy = std::move(v);
+        assert(copy.get_allocator().resource() == get_default_resource() && copy.size() == 100 && v.empty()); // Test 24
+        test_counter += 2;
+
+        List<String, PolymorphicAllocator<String>> names(&arena);
+        BasicString<PolymorphicAllocator<char>> text("arena string", &arena);
+        names.push_back("a");
+        assert(names.size() == 1 && text.size() == 12 && text.get_allocator().resource() == &arena); // Test 25
+        ++test_counter;
+
+        MonotonicResource counting_default;
+        MemoryResource* previous = set_default_resource(&counting_default);
+        Deque<int, PolymorphicAllocator<int>> d;
+        d.push_back(1);
+        assert(d.get_allocator().resource() == &counting_default);          // Test 26
+        set_default_resource(previous);
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 6. NodePool and PoolAllocator
+    // ======================================================
+    {
+        NodePool pool(sizeof(int), alignof(int));
+        void* first = pool.allocate();
+        void* second = pool.allocate();
+        assert(pool.block_size() >= sizeof(void*) && pool.live_blocks() == 2); // Test 27
+        pool.deallocate(first);
+        assert(pool.allocate() == first && pool.chunk_count() == 1);        // Test 28: free list reuse
+        pool.deallocate(second);
+        test_counter += 2;
+
+        //A pool is created by the first copy or allocation, copies share it
+        PoolAllocator<int> fresh;
+        assert(fresh.pool() == nullptr);                                    // Test 29
+        PoolAllocator<int> fresh_copy(fresh);
+        assert(fresh.pool() && fresh == fresh_copy);                        // Test 30
+        test_counter += 2;
+
+        //Nodes of one list come from the chunks of its own pool
+        List<int> list;
+        for (int i = 0; i < 100; ++i) {
+            list.push_back(i);
+        }
+        const NodePool* list_pool = list.get_allocator().pool();
+        assert(list_pool && list_pool->live_blocks() == 100 && list_pool->chunk_count() == 3); // Test 31: 16 + 32 + 64 blocks
+        list.clear();
+        assert(list_pool->live_blocks() == 0 && list_pool->chunk_count() == 0); // Test 32: chunks dropped at once
+        test_counter += 2;
+
+        list.push_back(1);
+        List<int> copy(list);
+        assert(copy.get_allocator().pool() != list.get_allocator().pool()); // Test 33: a copy has its own pool
+        List<int> moved(std::move(copy));
+        assert(moved.get_allocator().pool() && moved[0] == 1 && copy.empty()); // Test 34
+        test_counter += 2;
+
+        //A pool shared by two containers is not dropped while the other one uses it
+        PoolAllocator<int> shared;
+        AVLtree<int, std::less<int>, PoolAllocator<int>> left(shared);
+        AVLtree<int, std::less<int>, PoolAllocator<int>> right(shared);
+        for (int i = 0; i < 10; ++i) {
+            left.insert(i);
+            right.insert(i);
+        }
+        assert(shared.live_blocks() == 20 && left.get_allocator() == right.get_allocator()); // Test 35
+        left.clear();
+        assert(shared.live_blocks() == 10 && right.contains(9));            // Test 36
+        test_counter += 2;
+
+        //Two node types on one pool: the one configured first is pooled, the other one
+        //goes to ::operator new and must not release the blocks of the first
+        PoolAllocator<int> mixed;
+        List<int, PoolAllocator<int>> pooled_list(mixed);
+        AVLtree<int, std::less<int>, PoolAllocator<int>> heap_tree(mixed);
+        for (int i = 0; i < 3; ++i) {
+            pooled_list.push_back(i);
+            heap_tree.insert(i);
+        }
+        heap_tree.clear();
+        assert(mixed.live_blocks() == 3 && pooled_list[2] == 2);           // Test 37
+        pooled_list.clear();
+        assert(mixed.live_blocks() == 0 && heap_tree.empty());              // Test 38
+        test_counter += 2;
+    }
+
+    std::cout << "=== All " << test_counter << " allocator tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
+
+//Map key that counts how often it is built, ordered by id
+struct TrackedKey {
+    static int constructions;
+    int id;
+
+    TrackedKey(int id_) : id(id_) { ++constructions; }
+    TrackedKey(const TrackedKey& other) : id(other.id) { ++constructions; }
+};
+int TrackedKey::constructions = 0;
+
+struct TrackedLess {
+    using is_transparent = void;
+    bool operator()(const TrackedKey& left, const TrackedKey& right) const { return left.id < right.id; }
+    bool operator()(const TrackedKey& left, int right) const { return left.id < right; }
+    bool operator()(int left, const TrackedKey& right) const { return left < right.id; }
+};
+
+void test_avl_map_class() {
+    std::cout << "\n=== AVL Map Class Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. Insertion and lookup (Tests 1-8)
+    // ======================================================
+    {
+        AVLmap<int, String> m;
+        auto first = m.insert({ 2, "two" });
+        auto again = m.insert({ 2, "zwei" });
+        assert(first.second && !again.second && again.first->second == "two"); // Test 1
+        m[1] = "one";
+        m[3];
+        assert(m.size() == 3 && m.at(1) == "one" && m.at(3).size() == 0); // Test 2
+        test_counter += 2;
+
+        auto assigned = m.insert_or_assign(3, "three");
+        auto created = m.insert_or_assign(4, String("four"));
+        assert(!assigned.second && created.second && m.at(3) == "three" && m.at(4) == "four"); // Test 3
+        test_counter += 1;
+
+        //Keys only are compared: the order follows the keys, not the values
+        String order;
+        for (auto& entry : m) {
+            order += entry.second;
+        }
+        assert(order == "onetwothreefour");            // Test 4
+        assert(m.rank(3) == 2 && m.select(0).second == "one" && m.lower_bound(5) == m.end()); // Test 5
+        test_counter += 2;
+
+        bool thrown = false;
+        try { m.at(42); }
+        catch (const std::out_of_range&) { thrown = true; }
+        assert(thrown && !m.contains(42) && m.find(4)->data.second == "four"); // Test 6
+        test_counter += 1;
+
+        const AVLmap<int, String>& cm = m;
+        assert(cm.at(2) == "two" && (*cm.begin()).first == 1); // Test 7
+        m.remove(m.find(2));
+        assert(m.size() == 3 && !m.contains(2) && m.at(3) == "three"); // Test 8
+        test_counter += 2;
+    }
+
+    // ======================================================
+    // 2. try_emplace (Tests 9-11)
+    // ======================================================
+    {
+        AVLmap<String, List<int>> m;
+        auto inserted = m.try_emplace("a", size_t(3), 7); // List(3, 7)
+        assert(inserted.second && m.at("a").size() == 3 && m.at("a")[2] == 7); // Test 9
+
+        String key("b");
+        m.try_emplace(std::move(key));
+        String other("a");
+        auto existing = m.try_emplace(std::move(other), 100, 1);
+        assert(!existing.second && other == "a" && m.at("a").size() == 3); // Test 10: key not moved from
+        assert(m.size() == 2 && m.at("b").empty());    // Test 11
+        test_counter += 3;
+    }
+
+    // ======================================================
+    // 3. Heterogeneous lookup (Tests 12-15)
+    // ======================================================
+    {
+        AVLmap<String, int, std::less<>> m({ { "apple", 1 }, { "banana", 2 }, { "cherry", 3 }, { "apple", 4 } });
+        assert(m.size() == 3 && m.at("apple") == 1);   // Test 12: first duplicate wins
+        std::string_view view("banana");
+        assert(m.contains(view) && m.at(view) == 2 && m.rank("c") == 2); // Test 13
+        test_counter += 2;
+
+        AVLmap<TrackedKey, int, TrackedLess> tracked;
+        for (int i = 0; i < 100; ++i) {
+            tracked.try_emplace(TrackedKey(i), i * i);
+        }
+        int before = TrackedKey::constructions;
+        int sum = 0;
+        for (int i = 0; i < 100; i += 10) {
+            sum += tracked.at(i);
+        }
+        bool found = tracked.contains(50) && tracked.find(99) && !tracked.contains(100);
+        auto range = tracked.equal_range(7);
+        assert(found && sum == 28500 && range.first->second == 49); // Test 14
+        assert(TrackedKey::constructions == before);   // Test 15: lookups never built a key
+        test_counter += 2;
+
+        //Removal relinks nodes, no entry is copied
+        for (int i = 0; i < 100; i += 3) {
+            assert(tracked.erase(i) == 1);
+        }
+        assert(TrackedKey::constructions == before && tracked.size() == 66); // Test 16
+        auto after = tracked.erase(tracked.lower_bound(50));
+        assert(after->first.id == 52 && !tracked.contains(50)); // Test 17
+        test_counter += 2;
+    }
+
+    // ======================================================
+    // 4. append_max keeps keys unique (Test 18)
+    // ======================================================
+    {
+        AVLmap<int, int> m;
+        m.insert({ 1, 1 });
+        m.append_max({ 2, 2 });
+        bool rejected = false;
+        try { m.append_max({ 2, 3 }); }
+        catch (const std::invalid_argument&) { rejected = true; }
+        assert(rejected && m.size() == 2 && m.at(2) == 2); // Test 18
+        ++test_counter;
+    }
+
+    std::cout << "=== All " << test_counter << " AVL map tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
+
+//Checks parent links, child positions, subtree sizes, the in-node order, the fill of every
+//node but the root and that all leaves are on one level; returns the height or -1
+template<typename Node>
+int btree_subtree_height(const Node* node, const Node* parent, size_t position, size_t minimum) {
+    if (node->parent != parent || node->position != position || node->count == 0 || (parent && node->count < minimum)) {
+        return -1;
+    }
+    for (size_t i = 1; i < node->count; ++i) {
+        if (node->values()[i] < node->values()[i - 1]) {
+            return -1;
+        }
+    }
+    size_t size = node->count;
+    int height = 0;
+    if (!node->leaf) {
+        for (size_t i = 0; i <= node->count; ++i) {
+            int child = btree_subtree_height(node->children()[i], node, i, minimum);
+            if (child < 0 || (i > 0 && child != height)) {
+                return -1;
+            }
+            height = child;
+            size += node->children()[i]->size;
+        }
+    }
+    return size == node->size ? height + 1 : -1;
+}
+
+template<typename Tree>
+bool btree_valid(const Tree& tree) {
+    if (!tree.get_root()) {
+        return tree.empty();
+    }
+    int height = btree_subtree_height(tree.get_root(), decltype(tree.get_root())(nullptr), 0, (Tree::Capacity - 1) / 2);
+    return height > 0 && static_cast<size_t>(height) == tree.height() && tree.get_root()->size == tree.size();
+}
+
+void test_btree_class() {
+    std::cout << "\n=== BTree Class Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. Insertion and iteration (Tests 1-3)
+    // ======================================================
+    {
+        BTree<int> t;
+        assert(t.empty() && t.begin() == t.end() && t.height() == 0 && t.get_root() == nullptr); // Test 1
+        ++test_counter;
+
+        for (int i = 0; i < 1000; ++i) {
+            t.insert((i * 7919) % 1000);
+        }
+        t.insert(500);
+        int previous = -1;
+        bool sorted = true;
+        for (int value : t) {
+            sorted = sorted && value >= previous;
+            previous = value;
+        }
+        assert(sorted && t.size() == 1001 && btree_valid(t) && t.height() == 2); // Test 2
+        ++test_counter;
+
+        auto last = t.end();
+        --last;
+        assert(*last == 999 && *t.begin() == 0 && t.count_range(500, 500) == 2); // Test 3
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 2. Random inserts and erases against AVLtree (Tests 4-6)
+    // ======================================================
+    {
+        //64-byte nodes hold 10 ints: many levels, splits and merges
+        BTree<int, std::less<int>, 64> t;
+        AVLtree<int> reference;
+        unsigned seed = 12345;
+        bool valid = true;
+        for (int step = 0; step < 20000; ++step) {
+            seed = seed * 1103515245u + 12345u;
+            int value = static_cast<int>((seed >> 16) % 2000);
+            if (step % 3 != 2) {
+                t.insert(value);
+                reference.insert(value);
+            }
+            else {
+                valid = valid && t.erase(value) == reference.erase(value);
+            }
+            if (step % 1000 == 0) {
+                valid = valid && btree_valid(t);
+            }
+        }
+        assert(valid && btree_valid(t) && t.size() == reference.size() && t.height() > 3); // Test 4
+        ++test_counter;
+
+        bool same = true;
+        auto it = t.begin();
+        for (int value : reference) {
+            same = same && it != t.end() && *it == value;
+            ++it;
+        }
+        assert(same && it == t.end());                 // Test 5
+        ++test_counter;
+
+        bool ranks = true;
+        for (int value = -1; value <= 2000; value += 3) {
+            ranks = ranks && t.rank(value) == reference.rank(value) && t.contains(value) == reference.contains(value) &&
+                t.count_range(value, value + 17) == reference.count_range(value, value + 17);
+        }
+        for (size_t k = 0; k < t.size(); k += 13) {
+            ranks = ranks && t.select(k) == reference.select(k);
+        }
+        assert(ranks);                                 // Test 6
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 3. Lookups and iterator arithmetic (Tests 7-10)
+    // ======================================================
+    {
+        BTree<int, std::less<int>, 64> t;
+        for (int i = 0; i < 200; i += 2) {
+            t.insert(i);
+        }
+        t.insert(50);
+        assert(*t.lower_bound(51) == 52 && *t.upper_bound(50) == 52 && t.lower_bound(199) == t.end()); // Test 7
+        auto range = t.equal_range(50);
+        assert(*range.first == 50 && *(range.first + 2) == 52 && range.second == range.first + 2); // Test 8
+        test_counter += 2;
+
+        assert(t.find(7) == t.end() && *t.find(8) == 8 && *t.nth(100) == 198 && t.nth(101) == t.end()); // Test 9
+        int sum = 0;
+        t.for_each_in_range(10, 20, [&](int value) { sum += value; });
+        auto back = t.end() - 3;
+        assert(sum == 90 && *back == 194 && (back -= 200) == t.end()); // Test 10
+        test_counter += 2;
+    }
+
+    // ======================================================
+    // 4. Erase (Tests 11-12)
+    // ======================================================
+    {
+        BTree<int, std::less<int>, 64> t;
+        for (int i = 0; i < 500; ++i) {
+            t.insert(i % 250);
+        }
+        assert(t.erase(7) == 2 && !t.contains(7) && t.erase(7) == 0 && btree_valid(t)); // Test 11
+        ++test_counter;
+
+        //Erasing every other element while iterating, then the rest
+        size_t visited = 0;
+        for (auto it = t.begin(); it != t.end(); ++visited) {
+            it = t.erase(it);
+            if (it != t.end()) {
+                ++it;
+            }
+        }
+        bool valid = btree_valid(t);
+        for (auto it = t.begin(); it != t.end();) {
+            it = t.erase(it);
+        }
+        bool thrown = false;
+        try { t.erase(t.end()); }
+        catch (const std::out_of_range&) { thrown = true; }
+        assert(visited == 249 && valid && t.empty() && t.get_root() == nullptr && thrown); // Test 12
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 5. Bulk loading (Tests 13-15)
+    // ======================================================
+    {
+        Vector<int> sorted;
+        for (int i = 0; i < 20000; ++i) {
+            sorted.push_back(i);
+        }
+        bool built = true;
+        for (size_t total : { 0, 1, 10, 11, 120, 121, 1331, 20000 }) {
+            BTree<int, std::less<int>, 64> t;
+            t.assign_sorted(sorted.data(), sorted.data() + total);
+            built = built && t.size() == total && btree_valid(t) && (total == 0 || t.select(total - 1) == int(total) - 1);
+        }
+        assert(built);                                 // Test 13
+        ++test_counter;
+
+        Vector<int> shuffled;
+        for (int i = 0; i < 20000; ++i) {
+            shuffled.push_back((i * 7919) % 20000);
+        }
+        BTree<int> t(shuffled.begin(), shuffled.end());
+        t.insert(20000);
+        t.erase(0);
+        assert(t.size() == 20000 && btree_valid(t) && *t.begin() == 1 && t.select(19999) == 20000); // Test 14
+        ++test_counter;
+
+        bool thrown = false;
+        try { t.assign_sorted(shuffled.begin(), shuffled.end()); }
+        catch (const std::invalid_argument&) { thrown = true; }
+        assert(thrown && t.size() == 20000);           // Test 15
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 6. Non-trivial elements, copy and move (Tests 16-17)
+    // ======================================================
+    {
+        BTree<String, std::less<>, 128> t;
+        for (int i = 0; i < 300; ++i) {
+            t.insert(String(std::to_string(i).c_str()));
+        }
+        for (int i = 0; i < 300; i += 2) {
+            t.erase(String(std::to_string(i).c_str()));
+        }
+        BTree<String, std::less<>, 128> copy(t);
+        BTree<String, std::less<>, 128> moved(std::move(t));
+        assert(copy.size() == 150 && btree_valid(copy) && copy.contains("99") && !copy.contains("98") &&
+               copy.contains(std::string_view("1")));   // Test 16
+        copy = moved;
+        moved.clear();
+        assert(t.empty() && moved.empty() && copy.size() == 150 && *copy.begin() == "1"); // Test 17
+        test_counter += 2;
+    }
+
+    // ======================================================
+    // 7. BTreeMap (Tests 18-21)
+    // ======================================================
+    {
+        BTreeMap<int, String> m;
+        for (int i = 0; i < 100; ++i) {
+            m[i % 50] += "x";
+        }
+        assert(m.size() == 50 && m.at(7) == "xx" && btree_valid(m)); // Test 18
+        auto existing = m.try_emplace(3, "new");
+        auto assigned = m.insert_or_assign(4, "four");
+        assert(!existing.second && m.at(3) == "xx" && !assigned.second && m.at(4) == "four"); // Test 19
+        test_counter += 2;
+
+        bool thrown = false;
+        try { m.at(50); }
+        catch (const std::out_of_range&) { thrown = true; }
+        for (int i = 0; i < 50; i += 2) {
+            m.erase(i);
+        }
+        assert(thrown && m.size() == 25 && m.begin()->first == 1 && m.rank(10) == 5 && btree_valid(m)); // Test 20
+        ++test_counter;
+
+        BTreeMap<String, int, std::less<>> words({ { "pear", 1 }, { "apple", 2 }, { "fig", 3 }, { "apple", 4 } });
+        assert(words.size() == 3 && words.at("apple") == 2 && words.find(std::string_view("fig"))->second == 3); // Test 21
+        ++test_counter;
+    }
+
+    std::cout << "=== All " << test_counter << " BTree tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
+//Key built from an int, counts the conversions FrozenSet::contains_many() makes
+struct ConvertedKey {
+    static inline size_t conversions = 0;
+    int value;
+
+    ConvertedKey(int value_) : value(value_) {
+        ++conversions;
+    }
+
+    bool operator<(const ConvertedKey& other) const {
+        return value < other.value;
+    }
+};
+
+void test_frozen_set_class() {
+    std::cout << "\n=== FrozenSet Class Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. freeze() and iteration (Tests 1-3)
+    // ======================================================
+    {
+        FrozenSet<int> empty;
+        bool none = false;
+        empty.contains_many(&test_counter, 1, &none);
+        assert(empty.empty() && empty.begin() == empty.end() && !empty.contains(0) && !none); // Test 1
+        ++test_counter;
+
+        AVLtree<int> tree;
+        for (int i = 0; i < 1000; ++i) {
+            tree.insert((i * 7919) % 1000 * 2);
+        }
+        tree.insert(10);
+        FrozenSet<int> frozen = tree.freeze();
+        bool same = true;
+        auto it = frozen.begin();
+        for (int value : tree) {
+            same = same && it != frozen.end() && *it == value;
+            ++it;
+        }
+        assert(same && it == frozen.end() && frozen.size() == 1001); // Test 2
+        ++test_counter;
+
+        auto last = frozen.end();
+        --last;
+        int count_tens = 0;
+        for (int value : frozen) {
+            count_tens += value == 10;
+        }
+        assert(*last == 1998 && *frozen.begin() == 0 && count_tens == 2); // Test 3
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 2. Lookups for every size of the last level (Tests 4-6)
+    // ======================================================
+    {
+        bool contains = true;
+        bool bounds = true;
+        bool batched = true;
+        for (int n = 0; n <= 70; ++n) {
+            AVLtree<int> tree;
+            for (int i = 0; i < n; ++i) {
+                tree.insert(2 * i);
+            }
+            FrozenSet<int> frozen = tree.freeze();
+            Vector<int> keys;
+            for (int key = -2; key <= 2 * n + 1; ++key) {
+                keys.push_back(key);
+            }
+            bool found[160];
+            frozen.contains_many(keys.data(), keys.size(), found);
+            for (size_t i = 0; i < keys.size(); ++i) {
+                int key = keys[i];
+                bool present = key >= 0 && key < 2 * n && key % 2 == 0;
+                int lower = key <= 0 ? 0 : (key + 1) / 2 * 2;
+                int upper = key < 0 ? 0 : (key / 2 + 1) * 2;
+                contains = contains && frozen.contains(key) == present;
+                batched = batched && found[i] == present;
+                bounds = bounds && (lower >= 2 * n ? frozen.lower_bound(key) == frozen.end() : *frozen.lower_bound(key) == lower) &&
+                    (upper >= 2 * n ? frozen.upper_bound(key) == frozen.end() : *frozen.upper_bound(key) == upper);
+            }
+        }
+        assert(contains);                              // Test 4
+        assert(bounds);                                // Test 5
+        assert(batched);                               // Test 6
+        test_counter += 3;
+    }
+
+    // ======================================================
+    // 3. Other element types, construction and copies (Tests 7-10)
+    // ======================================================
+    {
+        AVLtree<String, std::less<>> words;
+        words.insert("pear");
+        words.insert("apple");
+        words.insert("fig");
+        auto frozen = words.freeze();
+        assert(frozen.contains("fig") && !frozen.contains(std::string_view("kiwi")) && *frozen.lower_bound("b") == "fig"); // Test 7
+        ++test_counter;
+
+        FrozenSet<int, std::greater<int>> descending({ 1, 5, 3, 9 });
+        assert(*descending.begin() == 9 && *descending.lower_bound(4) == 3 && descending.contains(5)); // Test 8
+        ++test_counter;
+
+        FrozenSet<int> copy(FrozenSet<int>({ 3, 1, 2 }));
+        FrozenSet<int> other;
+        other = copy;
+        FrozenSet<int> moved(std::move(copy));
+        assert(other.size() == 3 && moved.contains(2) && copy.empty()); // Test 9
+        ++test_counter;
+
+        bool thrown = false;
+        int unsorted[] = { 2, 1 };
+        try { other.assign_sorted(unsorted, unsorted + 2); }
+        catch (const std::invalid_argument&) { thrown = true; }
+        assert(thrown && other.empty() && !other.contains(1)); // Test 10
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 4. Empty sets and converted batch keys (Tests 11-12)
+    // ======================================================
+    {
+        AllocStats stats;
+        auto frozen = AVLtree<int>().freeze(CountingAllocator<int>(&stats));
+        decltype(frozen) copy(frozen);
+        decltype(frozen) assigned{ CountingAllocator<int>(&stats) };
+        int none[] = { 0 };
+        assigned.assign_sorted(none, none);
+        bool found = true;
+        copy.contains_many(none, 1, &found);
+        assert(stats.allocations == 0 && frozen.empty() && copy.begin() == copy.end() &&
+            assigned.empty() && !assigned.contains(0) && !found); // Test 11
+        ++test_counter;
+
+        AVLtree<ConvertedKey> tree;
+        for (int i = 0; i < 100; ++i) {
+            tree.insert(ConvertedKey(2 * i));
+        }
+        FrozenSet<ConvertedKey> keys = tree.freeze();
+        int lookups[20];
+        for (int i = 0; i < 20; ++i) {
+            lookups[i] = 3 * i;
+        }
+        bool present[20];
+        ConvertedKey::conversions = 0;
+        keys.contains_many(lookups, 20, present);
+        bool correct = true;
+        for (int i = 0; i < 20; ++i) {
+            correct = correct && present[i] == (3 * i % 2 == 0);
+        }
+        assert(correct && ConvertedKey::conversions == 20); // Test 12: one conversion per key
+        ++test_counter;
+    }
+
+    std::cout << "=== All " << test_counter << " FrozenSet tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
+void test_concurrent_avl_tree_class() {
+    std::cout << "\n=== ConcurrentAVLtree Class Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. Writes and reads of the latest version (Tests 1-3)
+    // ======================================================
+    {
+        ConcurrentAVLtree<int> t;
+        assert(t.empty() && !t.contains(1) && t.snapshot().begin() == t.snapshot().end()); // Test 1
+        ++test_counter;
+
+        for (int i = 0; i < 1000; ++i) {
+            t.insert((i * 7919) % 1000);
+        }
+        t.insert(500);
+        t.insert(500);
+        assert(t.size() == 1002 && t.contains(999) && t.erase(500) == 3 && !t.contains(500) && t.erase(500) == 0); // Test 2
+        ++test_counter;
+
+        auto snapshot = t.snapshot();
+        int expected = 0;
+        bool ordered = true;
+        for (int value : snapshot) {
+            expected += expected == 500;
+            ordered = ordered && value == expected++;
+        }
+        assert(ordered && expected == 1000 && snapshot.size() == 999); // Test 3
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 2. Snapshots keep their version (Tests 4-6)
+    // ======================================================
+    {
+        ConcurrentAVLtree<String, std::less<>> t({ "b", "d", "f" });
+        auto before = t.snapshot();
+        t.insert("c");
+        t.erase("d");
+        auto after = t.snapshot();
+        assert(before.contains("d") && !before.contains("c") && after.contains("c") && !after.contains(std::string_view("d"))); // Test 4
+        ++test_counter;
+
+        t.clear();
+        String joined;
+        for (const String& value : before) {
+            joined += value;
+        }
+        assert(joined == "bdf" && t.empty() && after.size() == 3 && t.snapshot().empty()); // Test 5
+        ++test_counter;
+
+        String range;
+        after.for_each_in_range("c", "f", [&](const String& value) { range += value; });
+        assert(range == "cf" && *after.lower_bound("bb") == "c" && *after.upper_bound("c") == "f" &&
+               after.upper_bound("f") == after.end() && after.rank("f") == 2 && *after.find("b") == "b" && !after.find("d")); // Test 6
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 3. Reclamation of replaced nodes (Tests 7-8)
+    // ======================================================
+    {
+        AllocStats stats;
+        {
+            ConcurrentAVLtree<int, std::less<int>, CountingAllocator<int>> t{ CountingAllocator<int>(&stats) };
+            for (int i = 0; i < 5000; ++i) {
+                t.insert(i);
+                if (i % 2) {
+                    t.erase(i / 2);
+                }
+            }
+            //Without open snapshots the retired nodes are freed in batches as commits go on
+            size_t live = stats.allocations - stats.deallocations;
+            assert(t.size() == 2500 && live <= t.size() + 2 * ConcurrentAVLtree<int>::reader_slots + 64); // Test 7
+            ++test_counter;
+
+            auto pinned = t.snapshot();
+            for (int i = 0; i < 2000; ++i) {
+                t.insert(10000 + i);
+            }
+            bool kept = stats.allocations - stats.deallocations > t.size() + 2000;
+            assert(kept && pinned.size() == 2500 && !pinned.contains(10000)); // Test 8: the pinned version stays alive
+            ++test_counter;
+        }
+        assert(stats.allocations == stats.deallocations && stats.live_bytes == 0); // Test 9
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 4. Readers while a writer commits (Test 10)
+    // ======================================================
+    {
+        //The writer appends 0, 1, 2, ...: every snapshot must be such a prefix
+        ConcurrentAVLtree<int> t;
+        std::atomic<bool> done(false);
+        std::atomic<bool> consistent(true);
+        Vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&] {
+                do {
+                    auto snapshot = t.snapshot();
+                    int expected = 0;
+                    for (int value : snapshot) {
+                        if (value != expected++) {
+                            consistent = false;
+                        }
+                    }
+                    if (static_cast<size_t>(expected) != snapshot.size()) {
+                        consistent = false;
+                    }
+                } while (!done);
+            });
+        }
+        for (int i = 0; i < 3000; ++i) {
+            t.insert(i);
+        }
+        done = true;
+        for (size_t r = 0; r < readers.size(); ++r) {
+            readers[r].join();
+        }
+        assert(consistent && t.size() == 3000);        // Test 10
+        ++test_counter;
+    }
+
+    std::cout << "=== All " << test_counter << " ConcurrentAVLtree tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
+void test_persistent_avl_tree_class() {
+    std::cout << "\n=== PersistentAVLtree Class Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. Versions (Tests 1-4)
+    // ======================================================
+    {
+        PersistentAVLtree<int> empty;
+        PersistentAVLtree<int> v1 = empty.insert(5).insert(1).insert(9);
+        PersistentAVLtree<int> v2 = v1.insert(5).erase(1);
+        assert(empty.empty() && v1.size() == 3 && v2.size() == 3 && v1.contains(1) && !v2.contains(1)); // Test 1
+        ++test_counter;
+
+        String joined;
+        for (int value : v2) {
+            joined += std::to_string(value).c_str();
+        }
+        assert(joined == "559" && v2.rank(9) == 2 && *v2.lower_bound(6) == 9 && v2.upper_bound(9) == v2.end()); // Test 2
+        ++test_counter;
+
+        PersistentAVLtree<int> v3 = v2.erase(5);
+        assert(v3.size() == 1 && *v3.find(9) == 9 && !v3.find(5) && v2.size() == 3 && v2.erase(7).same_version(v2)); // Test 3
+        ++test_counter;
+
+        PersistentAVLtree<int> copy = v1;
+        copy = copy.insert(0);
+        assert(copy.size() == 4 && v1.size() == 3 && !v1.contains(0) && *copy.begin() == 0); // Test 4
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 2. Structure sharing (Tests 5-8)
+    // ======================================================
+    {
+        AllocStats stats;
+        {
+            Vector<int> keys;
+            for (int i = 0; i < 1024; ++i) {
+                keys.push_back((i * 389) % 1024);
+            }
+            PersistentAVLtree<int, std::less<int>, CountingAllocator<int>> base(keys.begin(), keys.end(), CountingAllocator<int>(&stats));
+            //Built through rvalue inserts: every node was created once and updated in place
+            assert(stats.allocations == 1024 && base.size() == 1024); // Test 5
+            ++test_counter;
+
+            Vector<PersistentAVLtree<int, std::less<int>, CountingAllocator<int>>> history;
+            history.push_back(base);
+            for (int i = 0; i < 100; ++i) {
+                history.push_back(history.back().insert(2000 + i));
+                history.push_back(history.back().erase(i));
+            }
+            //200 versions, each costs one path (height <= 1.44 log2(n + 2) < 15)
+            size_t live = stats.allocations - stats.deallocations;
+            bool intact = history[0].size() == 1024 && history[1].size() == 1025 && history.back().size() == 1024 &&
+                          history[2].contains(2000) && !history[2].contains(0) && history[0].contains(0);
+            assert(intact && live <= 1024 + 200 * 16); // Test 6
+            ++test_counter;
+
+            history.clear();
+            assert(stats.allocations - stats.deallocations == 1024 && base.size() == 1024); // Test 7
+            ++test_counter;
+        }
+        assert(stats.allocations == stats.deallocations && stats.live_bytes == 0); // Test 8
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 3. Exceptions and transparent keys (Tests 9-10)
+    // ======================================================
+    {
+        PersistentAVLtree<CopyLimited> base;
+        for (int i = 0; i < 64; ++i) {
+            base = std::move(base).insert(CopyLimited(i));
+        }
+        bool failed = false;
+        for (int budget = 0; budget < 8; ++budget) {
+            CopyLimited::budget = budget;
+            try {
+                PersistentAVLtree<CopyLimited> next = base.insert(CopyLimited(100)).erase(CopyLimited(3));
+            }
+            catch (const std::runtime_error&) {
+                failed = true;
+            }
+        }
+        CopyLimited::budget = -1;
+        int expected = 0;
+        bool intact = base.size() == 64;
+        for (const CopyLimited& value : base) {
+            intact = intact && value.value == expected++;
+        }
+        assert(failed && intact && base.contains(CopyLimited(3))); // Test 9: copies that throw leave the versions alone
+        ++test_counter;
+
+        PersistentAVLtree<String, std::less<>> names{ "bob", "alice", "carol" };
+        auto fewer = names.erase(std::string_view("bob"));
+        assert(fewer.size() == 2 && names.contains("bob") && !fewer.contains("bob") && *fewer.lower_bound("b") == "carol"); // Test 10
+        ++test_counter;
+    }
+
+    std::cout << "=== All " << test_counter << " PersistentAVLtree tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
+void test_interval_tree_class() {
+    std::cout << "\n=== IntervalTree Class Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. Overlap and stabbing queries (Tests 1-4)
+    // ======================================================
+    {
+        IntervalTree<int> tree{ { 15, 20 }, { 10, 30 }, { 17, 19 }, { 5, 20 }, { 12, 15 }, { 30, 40 } };
+        assert(tree.size() == 6 && tree.overlaps(6, 7) && tree.overlaps(40, 50) && !tree.overlaps(41, 50) && !tree.overlaps(0, 4)); // Test 1
+        ++test_counter;
+
+        Vector<Interval<int>> found = tree.overlapping(18, 25);
+        bool expected = found.size() == 4 && found[0] == Interval<int>{ 5, 20 } && found[1] == Interval<int>{ 10, 30 } &&
+                        found[2] == Interval<int>{ 15, 20 } && found[3] == Interval<int>{ 17, 19 };
+        assert(expected);                              // Test 2: in (low, high) order
+        ++test_counter;
+
+        int stabbed = 0;
+        tree.for_each_containing(30, [&](const Interval<int>&) { ++stabbed; });
+        tree.erase(Interval<int>{ 10, 30 });
+        int after_erase = 0;
+        tree.for_each_containing(30, [&](const Interval<int>&) { ++after_erase; });
+        assert(stabbed == 2 && after_erase == 1 && tree.overlapping(21, 29).size() == 0); // Test 3
+        ++test_counter;
+
+        bool thrown = false;
+        try {
+            tree.insert({ 5, 4 });
+        }
+        catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown && tree.size() == 5);            // Test 4
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 2. Payloads and brute-force comparison (Tests 5-6)
+    // ======================================================
+    {
+        struct Booking {
+            long low;
+            long high;
+            int id;
+        };
+        IntervalTree<long, Booking> bookings;
+        Vector<Booking> all;
+        unsigned seed = 7;
+        for (int id = 0; id < 400; ++id) {
+            seed = seed * 1103515245u + 12345u;
+            long low = static_cast<long>((seed >> 8) % 1000);
+            long length = static_cast<long>((seed >> 20) % 50);
+            all.push_back({ low, low + length, id });
+            bookings.insert(all.back());
+        }
+        bool all_match = true;
+        for (long low = -10; low < 1060; low += 13) {
+            long high = low + (low % 7) * 5;
+            int expected = 0;
+            for (size_t i = 0; i < all.size(); ++i) {
+                expected += all[i].low <= high && low <= all[i].high;
+            }
+            int visited = 0;
+            long last_low = -1;
+            bool ordered = true;
+            bookings.for_each_overlapping(low, high, [&](const Booking& booking) {
+                ++visited;
+                ordered = ordered && booking.low >= last_low;
+                last_low = booking.low;
+            });
+            all_match = all_match && ordered && visited == expected && bookings.overlaps(low, high) == (expected > 0);
+        }
+        assert(all_match);                             // Test 5
+        ++test_counter;
+
+        //The max-endpoint summaries stay right while intervals are removed
+        for (size_t i = 0; i < all.size(); i += 2) {
+            bookings.erase(all[i]);
+        }
+        bool still_match = bookings.size() < all.size();
+        for (long point = 0; point < 1050; point += 11) {
+            int expected = 0;
+            for (const Booking& booking : bookings) {
+                expected += booking.low <= point && point <= booking.high;
+            }
+            int stabbed = 0;
+            bookings.for_each_containing(point, [&](const Booking&) { ++stabbed; });
+            still_match = still_match && stabbed == expected;
+        }
+        assert(still_match);                           // Test 6
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 3. append_max checks the bounds (Test 7)
+    // ======================================================
+    {
+        IntervalTree<int> tree;
+        tree.append_max({ 1, 4 });
+        tree.append_max({ 2, 3 });
+        bool rejected = false;
+        try { tree.append_max({ 9, 5 }); }
+        catch (const std::invalid_argument&) { rejected = true; }
+        assert(rejected && tree.size() == 2 && tree.overlaps(3, 3)); // Test 7
+        ++test_counter;
+    }
+
+    std::cout << "=== All " << test_counter << " IntervalTree tests passed! ===\n";
+    glob_counter += test_counter;
+}
+
+
+void test_avl_multiset_class() {
+    std::cout << "\n=== AVLmultiset Class Test ===\n";
+    int test_counter = 0;
+
+    // ======================================================
+    // 1. Counts (Tests 1-4)
+    // ======================================================
+    {
+        AVLmultiset<int> bag{ 3, 1, 3, 2, 3 };
+        assert(bag.size() == 5 && bag.distinct_size() == 3 && bag.count(3) == 3 && bag.count(7) == 0); // Test 1
+        ++test_counter;
+
+        bag.insert(2, 1000);
+        assert(bag.count(2) == 1001 && bag.size() == 1005 && bag.rank(3) == 1002 && bag.rank(2) == 1); // Test 2
+        ++test_counter;
+
+        bool removed = bag.erase_one(3) && bag.erase_one(1) && !bag.erase_one(1) && !bag.erase_one(9);
+        assert(removed && bag.count(3) == 2 && !bag.contains(1) && bag.distinct_size() == 2 && bag.size() == 1003); // Test 3
+        ++test_counter;
+
+        assert(bag.erase(2) == 1001 && bag.erase(2) == 0 && bag.size() == 2 && bag.rank(3) == 0); // Test 4
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 2. Iteration expands the copies (Tests 5-6)
+    // ======================================================
+    {
+        AVLmultiset<String, std::less<>> words;
+        words.insert("b", 2);
+        words.insert("a");
+        words.insert("c", 3);
+        String joined;
+        for (const String& word : words) {
+            joined += word;
+        }
+        String distinct;
+        words.for_each_distinct([&](const String& word, size_t count) { distinct += word + std::to_string(count).c_str(); });
+        assert(joined == "abbccc" && distinct == "a1b2c3"); // Test 5
+        ++test_counter;
+
+        auto it = words.lower_bound("b");
+        String from_b;
+        for (; it != words.end(); ++it) {
+            from_b += *it;
+        }
+        assert(from_b == "bbccc" && *words.upper_bound("b") == "c" && words.upper_bound("c") == words.end() &&
+               words.count(std::string_view("c")) == 3); // Test 6
+        ++test_counter;
+    }
+
+    // ======================================================
+    // 3. One node per distinct key (Tests 7-9)
+    // ======================================================
+    {
+        AllocStats stats;
+        {
+            AVLmultiset<int, std::less<int>, CountingAllocator<int>> histogram{ CountingAllocator<int>(&stats) };
+            for (int i = 0; i < 100000; ++i) {
+                histogram.insert(i % 10);
+            }
+            AVLmultiset<int, std::less<int>, CountingAllocator<int>> repeated(1000000, 42, CountingAllocator<int>(&stats));
+            assert(stats.allocations == 11 && histogram.size() == 100000 && histogram.count(7) == 10000 &&
+                   repeated.size() == 1000000 && repeated.distinct_size() == 1); // Test 7
+            ++test_counter;
+
+            //The subtree sums stay right through the rotations of inserts and removals
+            bool ranks_match = true;
+            for (int key = 0; key < 200; ++key) {
+                histogram.insert(1000 + key, key + 1);
+            }
+            for (int key = 0; key < 200; key += 3) {
+                histogram.erase(1000 + key);
+            }
+            size_t expected = 100000;
+            for (int key = 0; key < 200; ++key) {
+                ranks_match = ranks_match && histogram.rank(1000 + key) == expected;
+                expected += histogram.count(1000 + key);
+            }
+            assert(ranks_match && histogram.size() == expected); // Test 8
+            ++test_counter;
+        }
+        assert(stats.allocations == stats.deallocations && stats.live_bytes == 0); // Test 9
+        ++test_counter;
+    }
+
+    std::cout << "=== All " << test_counter << " AVLmultiset tests passed! ===\n";
+    glob_counter += test_counter;
+}
 
 
 void start_all_tests() {
     test_vector_class();
+    test_small_vector_class();
     test_array_class();
     test_string_class();
     test_stack_class();
@@ -2553,6 +4901,14 @@ void start_all_tests() {
     test_queue_class();
     test_list_class();
     test_avl_tree_class();
+    test_avl_map_class();
+    test_btree_class();
+    test_frozen_set_class();
+    test_allocators();
+    test_concurrent_avl_tree_class();
+    test_persistent_avl_tree_class();
+    test_interval_tree_class();
+    test_avl_multiset_class();
     std::cout << "\n\n=== " << glob_counter << " tests passed! ===" << std::endl;
 }
 